@@ -177,8 +177,9 @@ typedef double          f64;
 #define Div_Floor(x, y)     ((x) / (y))
 
 
-#define Bit(n) (1 << (n))
-#define Has_Bit(n, pos) ((n) & (1 << (pos)))
+// 1ULL so these work all the way up to bit 63.
+#define Bit(n) (1ULL << (n))
+#define Has_Bit(n, pos) ((n) & (1ULL << (pos)))
 
 
 #define Flag_Set(n, f)          ((n) |= (f))
@@ -228,6 +229,9 @@ typedef double          f64;
 // multithreaded code, by forceing the functions to not store the
 // value of the variable into their own registers.
 #define global_variable     static
+// for the functions the *_Define() macros spit out, every type gets its own
+// copy that the compiler can inline, and you dont get yelled at for the ones you never call.
+#define generated_function  __attribute__ ((unused)) static inline
 
 
 
@@ -320,6 +324,8 @@ s32   Mem_Cmp (void *ptr1, void *ptr2, u64 count);
 #ifndef BESTED_ALIGNED_ALLOC
     #define BESTED_ALIGNED_ALLOC(align, size)       aligned_alloc((align), (size))
     #define BESTED_FREE(ptr)                        free(ptr)
+    // so things like the large array mode know they can go around malloc.
+    #define BESTED_DEFAULT_ALLOCATOR
 #else
     #ifndef BESTED_FREE
         #error "Must Define BESTED_FREE as well as BESTED_ALIGNED_MALLOC"
@@ -378,6 +384,33 @@ s32   Mem_Cmp (void *ptr1, void *ptr2, u64 count);
 #define Atomic_Capture_Lock(lock) while (Atomic_Test_And_Set(lock)); for (int __lock_macro_holder = 0; __lock_macro_holder == 0; __lock_macro_holder = (Atomic_Clear(lock), 1))
 
 
+// a reader / writer spin lock, any number of readers, or one writer.
+//
+// the top bit is the writer, the rest is how many readers are in.
+// once a writer is waiting no new readers get in, so writers dont starve.
+typedef Atomic(u32) RW_Lock;
+
+#define RW_LOCK_WRITER      (1u << 31)
+
+void RW_Lock_Read_Lock   (RW_Lock *lock);
+void RW_Lock_Read_Unlock (RW_Lock *lock);
+void RW_Lock_Write_Lock  (RW_Lock *lock);
+void RW_Lock_Write_Unlock(RW_Lock *lock);
+
+// the same as Atomic_Capture_Lock(), with all the same warnings.
+#define RW_Lock_Capture_Read(lock)  RW_Lock_Read_Lock(lock);  for (int __lock_macro_holder = 0; __lock_macro_holder == 0; __lock_macro_holder = (RW_Lock_Read_Unlock(lock), 1))
+#define RW_Lock_Capture_Write(lock) RW_Lock_Write_Lock(lock); for (int __lock_macro_holder = 0; __lock_macro_holder == 0; __lock_macro_holder = (RW_Lock_Write_Unlock(lock), 1))
+
+// tell the cpu were spinning.
+#if defined(__x86_64__) || defined(__i386__)
+    #define Spin_Loop_Hint()    __builtin_ia32_pause()
+#elif defined(__aarch64__)
+    #define Spin_Loop_Hint()    __asm__ __volatile__("yield")
+#else
+    #define Spin_Loop_Hint()    ((void)0)
+#endif
+
+
 
 // ===================================================
 //                      Arena
@@ -558,6 +591,23 @@ void Pool_Free_Arenas(Arena_Pool *pool);
 #endif
 
 
+// arrays without an allocator that get at least this big (in bytes)
+// are backed by mmap() instead of malloc(), so growing them is just
+// mremap() shuffling some page tables around, instead of a giant Mem_Copy()
+// that briefly needs twice the memory.
+#ifndef ARRAY_MREMAP_THRESHOLD
+    #define ARRAY_MREMAP_THRESHOLD      (64 * MEGABYTE)
+#endif
+
+// linux only, and only if you haven't replaced the allocator,
+// #define ARRAY_DONT_USE_MREMAP if you dont want it.
+#if defined(__linux__) && defined(BESTED_DEFAULT_ALLOCATOR) && !defined(ARRAY_DONT_USE_MREMAP)
+    #define ARRAY_USE_MREMAP 1
+#else
+    #define ARRAY_USE_MREMAP 0
+#endif
+
+
 //
 // Example:
 //   - make a variable
@@ -604,6 +654,10 @@ typedef struct {
 // array will be able to hold at least count elements.
 void Array_Maybe_Grow(Generic_Array *array, Array_Item_Type_Properties_Struct item_properties, u64 new_count, bool clear_to_zero, Source_Code_Location caller_location);
 
+// frees the items of an array that doesn't have an allocator,
+// big arrays might be mmap()'d, see ARRAY_MREMAP_THRESHOLD.
+void Array_Free_Items(void *items, u64 capacity_in_bytes);
+
 // shifts the array left, why do i have this function?
 void Array_Shift(Generic_Array *array, Array_Item_Type_Properties_Struct item_properties, u64 from_index);
 
@@ -656,6 +710,93 @@ void Array_Shift(Generic_Array *array, Array_Item_Type_Properties_Struct item_pr
     } while (0)
 
 
+// items this small get copied every time, and the write index only moves
+// if the item is kept, no branch on the predicate, so no mispredicts.
+//
+// (the write index depends on the last item, so the compiler cant vectorize
+// this, for integer arrays and a simple compare use Array_Retain_Where().)
+#ifndef ARRAY_RETAIN_BRANCHLESS_SIZE
+    #define ARRAY_RETAIN_BRANCHLESS_SIZE    16
+#endif
+
+// keep only the items where 'keep_expr' is true, keeps the order. O(n), one pass.
+//
+// 'it' is a pointer to the current item, like in Array_For_Each().
+//
+//     Array_Retain(&sessions, it, it->expires_at > now);
+//
+#define Array_Retain(array, it, keep_expr)                                          \
+    do {                                                                            \
+        Typeof((array)->items) _items = (array)->items;                             \
+        u64 _write = 0;                                                             \
+        for (u64 _read = 0; _read < (array)->count; _read++) {                      \
+            Typeof(*(array)->items) *it = &_items[_read];                           \
+            bool _keep = (keep_expr);                                               \
+            if (sizeof(*_items) <= ARRAY_RETAIN_BRANCHLESS_SIZE) {                  \
+                _items[_write] = *it;                                               \
+                _write += _keep;                                                    \
+            } else if (_keep) {                                                     \
+                if (_write != _read) _items[_write] = *it;                          \
+                _write += 1;                                                        \
+            }                                                                       \
+        }                                                                           \
+        (array)->count = _write;                                                    \
+    } while (0)
+
+// what Array_Retain_Where() compares with, keeps the items where 'item OP scalar'.
+typedef enum {
+    Array_Keep_Equal,
+    Array_Keep_Not_Equal,
+    Array_Keep_Less,
+    Array_Keep_Less_Equal,
+    Array_Keep_Greater,
+    Array_Keep_Greater_Equal,
+} Array_Keep_Op;
+
+// Array_Retain() for integer arrays and one compare, 16 bytes at a time with SSE2.
+//
+// a lane thats all kept is stored as is, one thats all gone is skipped, the rest
+// get packed with one shuffle from a table of where the kept ones are, (SSSE3).
+// with just SSE2, only the 4 byte ones do lanes, the 1 and 2 byte ones are faster one
+// at a time without the shuffle. u64 / s64 dont have 64 bit compares in SSE2 either.
+// (one at a time is still branchless.)
+//
+//     Array_Retain_Where(&ages, Array_Keep_Greater_Equal, 18);
+//
+#define Array_Retain_Where(array, op, scalar)                                       \
+    do {                                                                            \
+        static_assert(_Generic(*(array)->items, u8: 1, u16: 1, u32: 1, u64: 1, s8: 1, s16: 1, s32: 1, s64: 1, default: 0), "Array_Retain_Where() only works on integer arrays"); \
+        (array)->count = Array_Retain_Where_Generic(                                \
+            (array)->items, (array)->count, sizeof(*(array)->items),                \
+            _Generic(*(array)->items, s8: true, s16: true, s32: true, s64: true, default: false), \
+            (op), (u64)(Typeof(*(array)->items))(scalar)                            \
+        );                                                                          \
+    } while (0)
+
+// returns the new count, 'scalar' is the bits of an item, (only the low 'item_size' bytes are used).
+u64 Array_Retain_Where_Generic(void *items, u64 count, u64 item_size, bool is_signed, Array_Keep_Op op, u64 scalar);
+
+// removes the runs of equal items from a sorted array, keeps the first of each run.
+//
+// 'a' is the last item kept, 'b' is the one being looked at.
+//
+//     Array_Dedup_Sorted(&ids, a, b, *a == *b);
+//
+#define Array_Dedup_Sorted(array, a, b, equal_expr)                                 \
+    do {                                                                            \
+        Typeof((array)->items) _items = (array)->items;                             \
+        if ((array)->count > 1) {                                                   \
+            u64 _write = 1;                                                         \
+            for (u64 _read = 1; _read < (array)->count; _read++) {                  \
+                Typeof(*(array)->items) *a = &_items[_write - 1];                   \
+                Typeof(*(array)->items) *b = &_items[_read];                        \
+                if (!(equal_expr)) _items[_write++] = *b;                           \
+            }                                                                       \
+            (array)->count = _write;                                                \
+        }                                                                           \
+    } while (0)
+
+
 // u64 index = it - array->items;
 #define Array_For_Each(it, array)                                             \
     for (Typeof(*(array)->items) *it = (array)->items; it < (array)->items + (array)->count; it++)
@@ -681,1588 +822,7300 @@ void Array_Shift(Generic_Array *array, Array_Item_Type_Properties_Struct item_pr
             fprintf(stderr, "I hope you have a terrible day.\n");                                                               \
             fprintf(stderr, "=======================================================================================\n");       \
         }                                   \
-        BESTED_FREE((array)->items);        \
-        (array)->items = NULL;              \
+        Array_Free_Items((array)->items, (array)->capacity * Array_Item_Size(array));  \
+        (array)->items    = NULL;           \
+        (array)->count    = 0;              \
+        (array)->capacity = 0;              \
     } while (0)
 
 
 
 // ===================================================
-//                Dynamic Hash Map
+//                Structure Of Arrays
 // ===================================================
 
-// how big the hashmap grows on the first insert.
-#ifndef HASH_MAP_INITAL_CAPACITY
-    #define HASH_MAP_INITAL_CAPACITY 32
-#endif
-
-
-// returns a hash of the key,
-// size is the size of the key type.
-typedef u64  (*Hash_Function    )(void *key, u64 size);
-// checks equality between 2 keys. return true if equal.
 //
-// I know hash collisions are pretty unlikely, (if you use a
-// good hash function), but if two key hash's collide, it could
-// create the worst, most un-debuggable bug. you would spend
-// every night in terror.
-typedef bool (*Equality_Function)(void *key_a, void *key_b, u64 size);
-
+// Like an Array(Type), but every field of the struct gets its own column.
+//
+// If your hot loop only touches 1 field of a big struct, an Array(Type)
+// drags every other field through the cache as well, this doesn't.
 //
 // Example:
-//   - make a variable:
-//     Hash_Map(u32, f32) id_to_percent_map = ZEROED;
+//   - list the fields, as (Type, name) pairs:
+//      #define PARTICLE_FIELDS(X)  X(f32, x) X(f32, y) X(f32, speed) X(u32, color)
 //
-//   - make a type:
-//     typedef Hash_Map(String, Baz) Baz_Hash_Map;
+//   - make the type, (and the functions that go with it):
+//      SoA_Define(Particles, PARTICLE_FIELDS)
 //
-//   id_to_percent_map.count         = /* number of entries in hash map        */
-//   id_to_percent_map.hash_function = /* hash function to use for the key     */
-//   id_to_percent_map.eq_function   = /* equality function to use for the key */
-//   id_to_percent_map.allocator     = /* a settable arena allocator           */
-//   id_to_percent_map.default_value = /* the default value when you use Hash_Map_Get_Or_Default() and the key is not in the map */
+//   Particles particles = ZEROED;
+//
+//   particles.count     = /* number of rows */
+//   particles.capacity  = /* the capacity of every column */
+//   particles.allocator = /* a settable arena allocator */
+//   particles.x         = /* the 'x' column, just a f32 pointer */
+//
+//   Particles_Row       = /* a struct with every field, for moving whole rows around */
 //
 // ```
-//     Hash_Map(s32, String) hash_map = {
-//         .hash_function = NULL, // the default hash function just takes
-//         .eq_function   = NULL, // the bytes of your type and hash's it.
+//     Particles_Append(&particles, ((Particles_Row){ .x = 1, .y = 2, .speed = 3 }));
 //
-//         .default_value = S("NO VALUE"), // a default value
-//     };
+//     // only pulls the 'x' and 'speed' columns through the cache, and vectorizes.
+//     SoA_For_Each_Index(i, &particles) {
+//         particles.x[i] += particles.speed[i];
+//     }
 //
-//    Hash_Map(String, s32) reverse_map = {
-//         .hash_function = Hash_Map_Hash_String, // some hash functions are provided for the String types,
-//         .eq_function   = Hash_Map_Eq_String,   // (as well as 'const char *' type, but who cares about that one.)
+//     Particles_Row row = Particles_Get(&particles, 0);
+//     Particles_Set(&particles, 0, row);
 //
-//         .default_value = 0, // by default this is allready zero.
-//    };
+//     Particles_Swap_And_Remove(&particles, 0);
+//
+//     // only if you didn't set an allocator.
+//     Particles_Free(&particles);
 // ```
 //
-#define Hash_Map(Key_Type, Value_Type)      \
-    struct {                                \
-        struct {                            \
-            u64        hash;                \
-            Key_Type   key;                 \
-            Value_Type value;               \
-        } *entries;                         \
-                                            \
-        /* total number of alive items in hash_map */   \
-        u64 count;                          \
-        /* total number dead items in hash map */       \
-        u64 dead_count;                     \
-        u64 capacity;                       \
-                                            \
-        Hash_Function     hash_function;    \
-        Equality_Function eq_function;      \
-                                            \
-        /* Settable allocator */            \
-        Arena *allocator;                   \
-                                            \
-        /* Default value of new items */    \
-        Value_Type default_value;           \
+// all the columns live in one allocation, and they all grow at the same time.
+//
+#define SoA_Define(Name, FIELDS)                                                                            \
+    typedef struct { FIELDS(SoA_Internal_Row_Field) } Name##_Row;                                           \
+                                                                                                            \
+    typedef struct {                                                                                        \
+        u64 count;                                                                                          \
+        u64 capacity;                                                                                       \
+        Arena *allocator;                                                                                   \
+        FIELDS(SoA_Internal_Column_Field)                                                                   \
+    } Name;                                                                                                 \
+                                                                                                            \
+    static_assert(sizeof(Name) == sizeof(Generic_SoA) + (0 FIELDS(SoA_Internal_Count_Field)) * sizeof(void*),    \
+        "every column is a pointer, so this should line up with Generic_SoA");                              \
+                                                                                                            \
+    generated_function void Name##_Maybe_Grow(Name *soa, u64 new_count, bool clear_to_zero) {               \
+        Array_Item_Type_Properties_Struct columns[] = { FIELDS(SoA_Internal_Column_Properties) };           \
+        SoA_Maybe_Grow((Generic_SoA*)soa, columns, Array_Len(columns), new_count, clear_to_zero, Get_Source_Code_Location());   \
+    }                                                                                                       \
+                                                                                                            \
+    /* make sure there is enough room to hold 'n' rows, dose not increase count. */                         \
+    generated_function void Name##_Reserve(Name *soa, u64 n) {                                              \
+        Name##_Maybe_Grow(soa, n, false);                                                                   \
+    }                                                                                                       \
+                                                                                                            \
+    /* returns the index of the new row. */                                                                 \
+    generated_function u64 Name##_Append(Name *soa, Name##_Row row) {                                       \
+        Name##_Maybe_Grow(soa, soa->count + 1, false);                                                      \
+        u64 index = soa->count++;                                                                           \
+        FIELDS(SoA_Internal_Store_Field)                                                                    \
+        return index;                                                                                       \
+    }                                                                                                       \
+                                                                                                            \
+    /* add 'n' rows, returns the index of the first one. */                                                 \
+    generated_function u64 Name##_Add(Name *soa, u64 n, bool zeroed) {                                      \
+        Name##_Maybe_Grow(soa, soa->count + n, zeroed);                                                     \
+        soa->count += n;                                                                                    \
+        return soa->count - n;                                                                              \
+    }                                                                                                       \
+                                                                                                            \
+    generated_function Name##_Row Name##_Get(Name *soa, u64 index) {                                        \
+        ASSERT(index < soa->count);                                                                         \
+        Name##_Row row;                                                                                     \
+        FIELDS(SoA_Internal_Load_Field)                                                                     \
+        return row;                                                                                         \
+    }                                                                                                       \
+                                                                                                            \
+    generated_function void Name##_Set(Name *soa, u64 index, Name##_Row row) {                              \
+        ASSERT(index < soa->count);                                                                         \
+        FIELDS(SoA_Internal_Store_Field)                                                                    \
+    }                                                                                                       \
+                                                                                                            \
+    /* Dose the full swap, like Array_Swap_And_Remove(). */                                                 \
+    generated_function void Name##_Swap_And_Remove(Name *soa, u64 index) {                                  \
+        ASSERT(index < soa->count);                                                                         \
+        u64 last = soa->count - 1;                                                                          \
+        if (index != last) { FIELDS(SoA_Internal_Swap_Field) }                                              \
+        soa->count -= 1;                                                                                    \
+    }                                                                                                       \
+                                                                                                            \
+    /* only call this if you haven't set an allocator. */                                                   \
+    generated_function void Name##_Free(Name *soa) {                                                        \
+        SoA_Free((Generic_SoA*)soa, (0 FIELDS(SoA_Internal_Count_Field)));                                  \
     }
 
 
+// for (u64 index = 0; index < soa->count; index++)
+#define SoA_For_Each_Index(index, soa)      for (u64 index = 0; index < (soa)->count; index++)
 
-typedef struct {
-    u64 hash;
-    u8 key_and_value_data[];
-} Generic_Entry;
 
-typedef struct {
-    void *entries;
+// the X() macros SoA_Define() hands to your field list.
+#define SoA_Internal_Row_Field(Type, name)              Type name;
+#define SoA_Internal_Column_Field(Type, name)           Type *name;
+#define SoA_Internal_Count_Field(Type, name)            + 1
+#define SoA_Internal_Column_Properties(Type, name)      { sizeof(Type), alignof(Type) },
+#define SoA_Internal_Store_Field(Type, name)            soa->name[index] = row.name;
+#define SoA_Internal_Load_Field(Type, name)             row.name = soa->name[index];
+#define SoA_Internal_Swap_Field(Type, name)             { Type tmp = soa->name[index]; soa->name[index] = soa->name[last]; soa->name[last] = tmp; }
 
+
+// every SoA_Define()'d struct starts like this, followed by its column pointers.
+typedef struct {
     u64 count;
-    u64 dead_count;
     u64 capacity;
-
-    Hash_Function     hash_function;
-    Equality_Function eq_function;
-
     Arena *allocator;
 
-    // dont know how big this thing is. or where it is.
-    u8 default_value_maybe[];
-} Generic_Hash_Map;
+    // in the same order as the field list.
+    void *columns[];
+} Generic_SoA;
 
+// might increase the capacity of every column,
+// the columns will be able to hold at least new_count rows.
+void SoA_Maybe_Grow(Generic_SoA *soa, Array_Item_Type_Properties_Struct *columns, u64 column_count, u64 new_count, bool clear_to_zero, Source_Code_Location caller_location);
 
-// These could probably be u32's,
-//
-// but im betting on llvm or whatever to compile this whole
-// thing into something better, also its not gonna cost much to
-// pass this thing as an argument.
-//
-// also every instance of this struct is a constant,
-// optimizers will have fun with that.
-typedef struct {
-    u64 key_size;
-    u64 value_size;
+void SoA_Free(Generic_SoA *soa, u64 column_count);
 
-    // used because predicting c struct packing
-    // is not something I want to do right now.
-    u64 entry_size;
-    u64 entry_alignment;
 
-    // key could be Aligned to 128-bit padding,
-    // this is so I dont have to care about that.
-    u64 key_offset_in_entry;
-    u64 value_offset_in_entry;
 
-    u64 default_value_offset_in_hash_map;
+// ===================================================
+//                  Bucket Array
+// ===================================================
 
-} Hash_Map_Key_Value_Type_Properties;
+// how many items fit into a single bucket.
+#ifndef BUCKET_ARRAY_ITEMS_PER_BUCKET
+    #define BUCKET_ARRAY_ITEMS_PER_BUCKET   256
+#endif
+static_assert(Is_Pow_2(BUCKET_ARRAY_ITEMS_PER_BUCKET), "so indexing is just a shift and a mask");
 
-#define Get_Hash_Map_Type_Properties(hash_map)                                              \
-    ((Hash_Map_Key_Value_Type_Properties) {                                                 \
-        .key_size   = sizeof((hash_map)->entries->key),                                     \
-        .value_size = sizeof((hash_map)->entries->value),                                   \
-                                                                                            \
-        .entry_size      = sizeof (*(hash_map)->entries),                                   \
-        .entry_alignment = Alignof(*(hash_map)->entries),                                   \
-                                                                                            \
-        .key_offset_in_entry   = offsetof(Typeof(*(hash_map)->entries), key),               \
-        .value_offset_in_entry = offsetof(Typeof(*(hash_map)->entries), value),             \
-                                                                                            \
-        .default_value_offset_in_hash_map = offsetof(Typeof(*(hash_map)), default_value),   \
-    })
+// how many bucket pointers the directory starts with.
+#ifndef BUCKET_ARRAY_INITAL_DIRECTORY_CAPACITY
+    #define BUCKET_ARRAY_INITAL_DIRECTORY_CAPACITY  8
+#endif
 
 
-// Returns a pointer to the value at with that key,
 //
-// may return null if key dose not exist.
+// A dynamic array made of fixed size buckets,
+// growing only ever adds a new bucket, nothing is ever copied.
 //
-// this function, (as well as many other hash_map functions),
-// rely on GNU compound statements, to provide the user the
-// ability to hand this function both:
-//     - a variable,
-//     - and a constant value.
-// you might have to turn some warnings off though.
-#define Hash_Map_Get(hash_map, the_key)                                 \
-    ({                                                                  \
-        Typeof((hash_map)->entries->key) key_on_stack = (the_key);      \
-        (Typeof((hash_map)->entries->value)*) Generic_Hash_Map_Get((Generic_Hash_Map*)(hash_map), &key_on_stack, Get_Hash_Map_Type_Properties(hash_map));   \
-    })
-
-// Returns a pointer to the value at with that key,
+// So pointers into a Bucket_Array stay valid for as long as the array lives,
+// and if you give it an arena, no old copies of the array get left behind in it.
 //
-// creates a new default value item if the key is not in the map.
+// Example:
+//   - make a variable
+//      Bucket_Array(Foo) foo_array;
 //
-// always returns a valid pointer, will PANIC() otherwise.
+//   - make a type
+//      typedef Bucket_Array(Bar) Bar_Bucket_Array;
 //
-// TODO what if the area the user gave us set "dont panic" mode?
-#define Hash_Map_Get_Or_Default(hash_map, the_key)                      \
-    ({                                                                  \
-        Typeof((hash_map)->entries->key) key_on_stack = (the_key);      \
-        (Typeof((hash_map)->entries->value)*) Generic_Hash_Map_Get_Or_Default((Generic_Hash_Map*)(hash_map), &key_on_stack, Get_Hash_Map_Type_Properties(hash_map), Get_Source_Code_Location());    \
-    })
+//   foo_array.buckets          = /* the bucket directory, each bucket holds BUCKET_ARRAY_ITEMS_PER_BUCKET items */
+//   foo_array.count            = /* number of items in array */
+//   foo_array.bucket_count     = /* number of buckets that have been allocated */
+//   foo_array.buckets_capacity = /* the capacity of the bucket directory */
+//   foo_array.allocator        = /* a settable arena allocator, (Pool_Get() works great here) */
+//
+// ```
+//     Foo *foo = Bucket_Array_Add_One(&foo_array, true);
+//     Bucket_Array_Append(&foo_array, ((Foo){ .bar = 5 }));
+//
+//     // this pointer is still good, no matter how much more you add.
+//     foo = Bucket_Array_Get(&foo_array, 0);
+//
+//     Bucket_Array_For_Each(it, &foo_array) {
+//         printf("%zu: %d\n", it.index, it.item->bar);
+//     }
+// ```
+//
+#define Bucket_Array(Type)                  \
+    struct {                                \
+        Type **buckets;                     \
+        u64 count;                          \
+        u64 bucket_count;                   \
+        u64 buckets_capacity;               \
+        Arena *allocator;                   \
+    }
 
-// the same as Hash_Map_Get_Or_Default() except it dose not set the default value.
-#define Hash_Map_Put(hash_map, the_key)                                 \
-    ({                                                                  \
-        Typeof((hash_map)->entries->key) key_on_stack = (the_key);      \
-        (Typeof((hash_map)->entries->value)*) Generic_Hash_Map_Put((Generic_Hash_Map*)(hash_map), &key_on_stack, Get_Hash_Map_Type_Properties(hash_map), Get_Source_Code_Location());   \
-    })
 
+// this struct shares the same shape as every bucket array.
+typedef struct {
+    void **buckets;
+    u64 count;
+    u64 bucket_count;
+    u64 buckets_capacity;
+    Arena *allocator;
+} Generic_Bucket_Array;
 
-// true if key is in map. returns bool type.
-#define Hash_Map_Contains(hash_map, the_key)                            \
-    ({                                                                  \
-        Typeof((hash_map)->entries->key) key_on_stack = (the_key);      \
-        Generic_Hash_Map_Contains((Generic_Hash_Map*)(hash_map), &key_on_stack, Get_Hash_Map_Type_Properties(hash_map));    \
-    })
 
+// might allocate new buckets, never moves the old ones.
+// array will be able to hold at least new_count elements.
+void Bucket_Array_Maybe_Grow(Generic_Bucket_Array *array, Array_Item_Type_Properties_Struct item_properties, u64 new_count, bool clear_to_zero, Source_Code_Location caller_location);
 
-// remove a key and value from hash map,
-//
-// returns weather or not the key was in the hash map.
-#define Hash_Map_Remove(hash_map, the_key)                              \
-    ({                                                                  \
-        Typeof((hash_map)->entries->key) key_on_stack = (the_key);      \
-        Generic_Hash_Map_Remove((Generic_Hash_Map*)(hash_map), &key_on_stack, Get_Hash_Map_Type_Properties(hash_map));  \
-    })
+// only call this if you haven't set an allocator.
+void Generic_Bucket_Array_Free(Generic_Bucket_Array *array);
 
-// remove an entry by pointer to the value,
-//
-// will ASSERT() that the value pointer is valid
-// (is one of this hash maps entries)
-//
-// returns true if it was successful.
-#define Hash_Map_Remove_By_Value(hash_map, value_ptr)                   \
-    Generic_Hash_Map_Remove_By_Value((Generic_Hash_Map*)(hash_map), value_ptr, Get_Hash_Map_Type_Properties(hash_map))
 
+#define Get_Bucket_Array_Item_Properties(array) ( (Array_Item_Type_Properties_Struct){ sizeof(**(array)->buckets), Alignof(**(array)->buckets) } )
 
-// reserve space for num_to_reserver *TOTAL* items,
-//
-// may PANIC() if your computer runs out of memory.
-#define Hash_Map_Reserve(hash_map, num_to_reserve)                      \
-    Generic_Hash_Map_Reserve((Generic_Hash_Map*)(hash_map), (num_to_reserve), Get_Hash_Map_Type_Properties(hash_map), Get_Source_Code_Location())
+// pointer to the item at index,
+// dose not do any bounds checking.
+#define Bucket_Array_Get(array, index)                                                  \
+    (&(array)->buckets[(u64)(index) / BUCKET_ARRAY_ITEMS_PER_BUCKET][(u64)(index) % BUCKET_ARRAY_ITEMS_PER_BUCKET])
 
-// clear the hash map, keep the memory.
-#define Hash_Map_Clear(hash_map)    Generic_Hash_Map_Clear((Generic_Hash_Map*)(hash_map), Get_Hash_Map_Type_Properties(hash_map))
-// free the memory used, only use if you haven't set an allocator.
-//
-// only free()'s the entries pointer,
-// you have to manage the other memory yourself.
-#define Hash_Map_Free(hash_map)     Generic_Hash_Map_Free((Generic_Hash_Map*)(hash_map))
+// add a single value
+#define Bucket_Array_Append(array, value)                                                                                                           \
+    (Bucket_Array_Maybe_Grow((Generic_Bucket_Array*)(array), Get_Bucket_Array_Item_Properties(array), (array)->count + 1, false, Get_Source_Code_Location()), \
+    (array)->count += 1,                                                                                                                            \
+    *Bucket_Array_Get(array, (array)->count - 1) = (value))
 
+// add a single item, and get a pointer to it.
+#define Bucket_Array_Add_One(array, zeroed)                                                                                                         \
+    (Bucket_Array_Maybe_Grow((Generic_Bucket_Array*)(array), Get_Bucket_Array_Item_Properties(array), (array)->count + 1, zeroed, Get_Source_Code_Location()), \
+    (array)->count += 1,                                                                                                                            \
+    Bucket_Array_Get(array, (array)->count - 1))
 
-// return a pointer to the key for the value, please dont modify this.
+// make sure there is enough room to hold 'n' items, dose not increase count.
+#define Bucket_Array_Reserve(array, n)                                                                                                              \
+    (Bucket_Array_Maybe_Grow((Generic_Bucket_Array*)(array), Get_Bucket_Array_Item_Properties(array), (n), false, Get_Source_Code_Location()))
+
+// the last item gets moved into the hole, so a pointer to the last item will now point past the end.
+#define Bucket_Array_Swap_And_Remove(array, index)                                          \
+    do {                                                                                    \
+        ASSERT(0 <= (index) && (index) < (array)->count);                                   \
+        if ((index) != (array)->count-1) {                                                  \
+            *Bucket_Array_Get(array, (index)) = *Bucket_Array_Get(array, (array)->count-1); \
+        }                                                                                   \
+        (array)->count -= 1;                                                                \
+    } while (0)
+
+// keeps the buckets around, so the next items dont have to allocate.
+#define Bucket_Array_Clear(array)       ((array)->count = 0)
+
+#define Bucket_Array_Free(array)        Generic_Bucket_Array_Free((Generic_Bucket_Array*)(array))
+
+
+// it.index = the index of the item
+// it.item  = pointer to the item
 //
-// i could of just dereferenced this key, but
-// it would be pretty easy to get around it.
-// if what you were storing was an array or something.
-#define Hash_Map_Key_For(hash_map, value_ptr)       \
-    ((Typeof((hash_map)->entries->key)*) Generic_Hash_Map_Key_For((Generic_Hash_Map*)(hash_map), (value_ptr), Get_Hash_Map_Type_Properties(hash_map)))
+// walks through each bucket with a pointer, only looks at the directory when it crosses into the next one.
+#define Bucket_Array_For_Each(it, array)                                                                            \
+    for (                                                                                                           \
+        struct { u64 index; Typeof(**(array)->buckets) *item; } it = { 0, (array)->count ? (array)->buckets[0] : NULL };    \
+        it.index < (array)->count;                                                                                  \
+        it.index += 1,                                                                                              \
+        it.item = (it.index % BUCKET_ARRAY_ITEMS_PER_BUCKET == 0 && it.index < (array)->count)                      \
+            ? (array)->buckets[it.index / BUCKET_ARRAY_ITEMS_PER_BUCKET]                                            \
+            : it.item + 1                                                                                           \
+    )
+
+
+
+// ===================================================
+//              Ring Buffer / Deque
+// ===================================================
+
+#ifndef RING_BUFFER_INITAL_CAPACITY
+    #define RING_BUFFER_INITAL_CAPACITY     32
+#endif
+static_assert(Is_Pow_2(RING_BUFFER_INITAL_CAPACITY), "the capacity is always a power of 2, so wrapping is just a mask");
 
 
-// allows you to loop over all values in the hash table.
 //
-// ```
-// Hash_Map(s32, u32) hash_map = ZEROED;
+// A queue you can push and pop from both ends of, in O(1).
 //
-// *Hash_Map_Get_Or_Default(&hash_map, 52) = 6;
-// *Hash_Map_Get_Or_Default(&hash_map, 12) = 8;
+// Use this instead of Array_Remove(&queue, 0, 1), witch moves every item, every time.
 //
-// Hash_Map_For_Each(value, &hash_map) {
-//     s32 *key = Hash_Map_Key_For(&hash_map, value);
+// Example:
+//   - make a variable
+//      Ring_Buffer(Job) jobs;
 //
-//     printf("%d => %u", *key, *value);
+//   - make a type
+//      typedef Deque(Job) Job_Queue;
+//
+//   jobs.items     = /* the buffer, the items wrap around the end of it */
+//   jobs.head      = /* index of the front item in 'items' */
+//   jobs.count     = /* number of items in the queue */
+//   jobs.capacity  = /* the capacity, always a power of 2 */
+//   jobs.allocator = /* a settable arena allocator */
 //
-//     // you can also modify the value here.
-//     *value += 1;
-// }
 // ```
-#define Hash_Map_For_Each(value_it, hash_map)                       \
-    for (                                                           \
-        Typeof((hash_map)->entries->value) *value_it = NULL;        \
-        Generic_Hash_Map_For_Each_Iterator_Next((Generic_Hash_Map*)(hash_map), (void**)&value_it, Get_Hash_Map_Type_Properties(hash_map));     \
-    )
-
-
-
-// this is the default for a hash table, if no hash function is set.
+//     Ring_Buffer_Push_Back (&jobs, job);
+//     Ring_Buffer_Push_Front(&jobs, urgent_job);
 //
-// hash's the data for the key.
+//     Job next = Ring_Buffer_Pop_Front(&jobs);
+//     Job last = Ring_Buffer_Pop_Back (&jobs);
 //
-// uses FNV-1a
-u64  Hash_Map_Default_Hash_Function    (void *key, u64 size);
-bool Hash_Map_Default_Equality_Function(void *key_a, void *key_b, u64 size);
-
+//     // 'i' items from the front.
+//     Job *job = Ring_Buffer_Get(&jobs, i);
+//
+//     // take up to 64 jobs at once, they might wrap around, so you get 2 spans.
+//     Ring_Buffer_Spans spans = Ring_Buffer_Pop_Front_Many(&jobs, 64);
+//     do_jobs(spans.first,  spans.first_count);
+//     do_jobs(spans.second, spans.second_count);
+// ```
+//
+#define Ring_Buffer(Type)                   \
+    struct {                                \
+        Type *items;                        \
+        u64 head;                           \
+        u64 count;                          \
+        u64 capacity;                       \
+        Arena *allocator;                   \
+    }
 
-// use these if your key type is String,
-// hash entire string with Hash_Map_Default_Hash_Function()
-u64  Hash_Map_Hash_String(void *key, u64 size);
-bool Hash_Map_Eq_String  (void *key_a, void *key_b, u64 size);
+// its the same thing, some people just know it by this name.
+#define Deque(Type)     Ring_Buffer(Type)
 
-// use this if your key type is a c String,
-// hash entire string with Hash_Map_Default_Hash_Function()
-u64  Hash_Map_Hash_C_String(void *key, u64 size);
-bool Hash_Map_Eq_C_String  (void *key_a, void *key_b, u64 size);
 
+// this struct shares the same shape as every ring buffer.
+typedef struct {
+    void *items;
+    u64 head;
+    u64 count;
+    u64 capacity;
+    Arena *allocator;
+} Generic_Ring_Buffer;
 
-// TODO maybe more hash functions,
+// up to two contiguous runs of items, the second one is
+// only used when the items wrap around the end of the buffer.
 //
-// but really, who cares? fnv1a is good enough for every job,
-// some might even say its a great hash function, that is more
-// than fast enough for literally every job, sure you might like
-// djb2 because its simpler or something, but any remotely
-// good hash will do the exact same job.
-u64 Hash_Function_fnv1a(void *key, u64 size);
-// Hash_Function Hash_Function_fnv1(void *key, u64 size);
-
-
-// The generic functions that power the hash map interface.
+// in queue order, first then second.
+typedef struct {
+    void *first;
+    u64   first_count;
+    void *second;
+    u64   second_count;
+} Ring_Buffer_Spans;
 
-void *Generic_Hash_Map_Get                  (Generic_Hash_Map *hash_map, void *key,            Hash_Map_Key_Value_Type_Properties properties);
-void *Generic_Hash_Map_Get_Or_Default       (Generic_Hash_Map *hash_map, void *key,            Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location);
-void *Generic_Hash_Map_Put                  (Generic_Hash_Map *hash_map, void *key,            Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location);
 
-bool Generic_Hash_Map_Contains              (Generic_Hash_Map *hash_map, void *key,            Hash_Map_Key_Value_Type_Properties properties);
+// might increase the capacity, when it dose the items get
+// straightened out, (head goes back to 0) in the new buffer.
+void Ring_Buffer_Maybe_Grow(Generic_Ring_Buffer *ring_buffer, Array_Item_Type_Properties_Struct item_properties, u64 new_count, Source_Code_Location caller_location);
 
-void Generic_Hash_Map_Clear                 (Generic_Hash_Map *hash_map,                       Hash_Map_Key_Value_Type_Properties properties);
-void Generic_Hash_Map_Free                  (Generic_Hash_Map *hash_map);
-void Generic_Hash_Map_Reserve               (Generic_Hash_Map *hash_map, u64 num_to_reserve,   Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location);
+Ring_Buffer_Spans Generic_Ring_Buffer_Push_Back_Many(Generic_Ring_Buffer *ring_buffer, Array_Item_Type_Properties_Struct item_properties, u64 n, Source_Code_Location caller_location);
+Ring_Buffer_Spans Generic_Ring_Buffer_Pop_Front_Many(Generic_Ring_Buffer *ring_buffer, Array_Item_Type_Properties_Struct item_properties, u64 n);
 
-bool Generic_Hash_Map_Remove                (Generic_Hash_Map *hash_map, void *key,            Hash_Map_Key_Value_Type_Properties properties);
-bool Generic_Hash_Map_Remove_By_Value       (Generic_Hash_Map *hash_map, void *value_ptr,      Hash_Map_Key_Value_Type_Properties properties);
+// only call this if you haven't set an allocator.
+void Generic_Ring_Buffer_Free(Generic_Ring_Buffer *ring_buffer);
 
-void *Generic_Hash_Map_Key_For              (Generic_Hash_Map *hash_map, void *value_ptr,      Hash_Map_Key_Value_Type_Properties properties);
-bool Generic_Hash_Map_For_Each_Iterator_Next(Generic_Hash_Map *hash_map, void **current_value, Hash_Map_Key_Value_Type_Properties properties);
 
+// where the i'th item from the front lives in 'items'
+#define Ring_Buffer_Index(ring_buffer, i)   (((ring_buffer)->head + (i)) & ((ring_buffer)->capacity - 1))
 
+// pointer to the i'th item from the front, dose not do any bounds checking.
+#define Ring_Buffer_Get(ring_buffer, i)     (&(ring_buffer)->items[Ring_Buffer_Index(ring_buffer, i)])
 
-// ===================================================
-//                       String
-// ===================================================
+#define Ring_Buffer_Push_Back(ring_buffer, value)                                                                                                           \
+    (Ring_Buffer_Maybe_Grow((Generic_Ring_Buffer*)(ring_buffer), Get_Item_Type_Properties(ring_buffer), (ring_buffer)->count + 1, Get_Source_Code_Location()),   \
+    (ring_buffer)->count += 1,                                                                                                                              \
+    *Ring_Buffer_Get(ring_buffer, (ring_buffer)->count - 1) = (value))
 
-// returns true if c is one of the ASCII whitespace characters.
-bool Is_Whitespace(char c);
-#define To_Upper(c) (('a' <= (c) && (c) <= 'z') ? ((c) - 'a' + 'A') : (c))
-#define To_Lower(c) (('A' <= (c) && (c) <= 'Z') ? ((c) - 'A' + 'a') : (c))
+#define Ring_Buffer_Push_Front(ring_buffer, value)                                                                                                          \
+    (Ring_Buffer_Maybe_Grow((Generic_Ring_Buffer*)(ring_buffer), Get_Item_Type_Properties(ring_buffer), (ring_buffer)->count + 1, Get_Source_Code_Location()),   \
+    (ring_buffer)->head   = ((ring_buffer)->head - 1) & ((ring_buffer)->capacity - 1),                                                                      \
+    (ring_buffer)->count += 1,                                                                                                                              \
+    (ring_buffer)->items[(ring_buffer)->head] = (value))
 
+// will ASSERT() that there is something to pop.
+#define Ring_Buffer_Pop_Front(ring_buffer)                                                  \
+    ({                                                                                      \
+        ASSERT((ring_buffer)->count > 0);                                                   \
+        Typeof(*(ring_buffer)->items) _front = (ring_buffer)->items[(ring_buffer)->head];   \
+        (ring_buffer)->head   = Ring_Buffer_Index(ring_buffer, 1);                          \
+        (ring_buffer)->count -= 1;                                                          \
+        _front;                                                                             \
+    })
 
-typedef struct {
-    char *data;
-    u64 length;
-} String;
+// will ASSERT() that there is something to pop.
+#define Ring_Buffer_Pop_Back(ring_buffer)                                                   \
+    ({                                                                                      \
+        ASSERT((ring_buffer)->count > 0);                                                   \
+        (ring_buffer)->count -= 1;                                                          \
+        *Ring_Buffer_Get(ring_buffer, (ring_buffer)->count);                                \
+    })
 
-typedef Array(String) String_Array;
+// NULL if empty.
+#define Ring_Buffer_Peek_Front(ring_buffer)     ((ring_buffer)->count ? Ring_Buffer_Get(ring_buffer, 0)                          : NULL)
+#define Ring_Buffer_Peek_Back(ring_buffer)      ((ring_buffer)->count ? Ring_Buffer_Get(ring_buffer, (ring_buffer)->count - 1)   : NULL)
 
+// make room for 'n' more items at the back, returns where to put them.
+//
+// the pointers are void*, there the same type as the items.
+#define Ring_Buffer_Push_Back_Many(ring_buffer, n)      \
+    Generic_Ring_Buffer_Push_Back_Many((Generic_Ring_Buffer*)(ring_buffer), Get_Item_Type_Properties(ring_buffer), (n), Get_Source_Code_Location())
 
-// Formatting for printf()
-#define S_Fmt    "%.*s"
-#define S_Arg(s) (int) (s).length, (s).data
+// pop up to 'n' items from the front, returns where they are,
+// there good until the next time you push something.
+#define Ring_Buffer_Pop_Front_Many(ring_buffer, n)      \
+    Generic_Ring_Buffer_Pop_Front_Many((Generic_Ring_Buffer*)(ring_buffer), Get_Item_Type_Properties(ring_buffer), (n))
 
-String  String_From_C_Str(const char *str);
-#define S(c_str)    String_From_C_Str(c_str)
+// make sure there is enough room to hold 'n' items, dose not increase count.
+#define Ring_Buffer_Reserve(ring_buffer, n)     \
+    Ring_Buffer_Maybe_Grow((Generic_Ring_Buffer*)(ring_buffer), Get_Item_Type_Properties(ring_buffer), (n), Get_Source_Code_Location())
 
+#define Ring_Buffer_Clear(ring_buffer)  ((ring_buffer)->head = 0, (ring_buffer)->count = 0)
+#define Ring_Buffer_Free(ring_buffer)   Generic_Ring_Buffer_Free((Generic_Ring_Buffer*)(ring_buffer))
 
-// will use BESTED_MALLOC() if allocator is NULL
-const char *String_To_C_Str(String s, Arena *allocator);
-const char *temp_String_To_C_Str(String s);
 
 
-typedef struct {
-    // the allocator to use, will use BESTED_MALLOC() if null.
-    Arena* allocator;
-    // weather or not to null terminate the string.
-    bool null_terminate;
-} String_Duplicate_Opt;
+// ===================================================
+//                      Bitset
+// ===================================================
 
-// if arena == NULL, uses BESTED_MALLOC.
 //
-// by default dose not null_terminate
-#define String_Duplicate(string, ...) _String_Duplicate((string), (String_Duplicate_Opt){ __VA_ARGS__ })
-String _String_Duplicate(String s, String_Duplicate_Opt opt);
-
-// in place.
-void    String_To_Upper(String *s);
+// A growable array of bits, for visited markers, filter masks, that kind of thing.
+//
+// The front of this struct has the same shape as an Array(u64),
+// so it grows the exact same way, (allocator and all).
+//
+// ```
+//     Bitset visited = ZEROED;
+//     Bitset_Resize(&visited, node_count); // new bits are always 0
+//
+//     Bitset_Set  (&visited, 5);
+//     Bitset_Clear(&visited, 5);
+//     if (Bitset_Test(&visited, 5)) { ... }
+//
+//     u64 how_many = Bitset_Count(&visited);
+//
+//     Bitset_For_Each_Set(index, &visited) {
+//         printf("%zu was visited\n", index);
+//     }
+//
+//     // whole sets at once, (SIMD when the compiler lets us).
+//     Bitset_And(&visited, &filter);
+// ```
+//
+typedef struct {
+    u64 *words;
+    u64 word_count;
+    u64 word_capacity;
+    Arena *allocator;
 
-bool    String_Eq           (String s1, String s2);
-bool    String_Starts_With  (String s, String prefix);
-bool    String_Ends_With    (String s, String postfix);
+    // number of bits, bits past this in the last word are always 0.
+    u64 count;
+} Bitset;
 
-bool    String_Contains_Char        (String s, char c);
-// finds the first occurrence of c in s, -1 on failure
-s64     String_Find_Index_Of_Char   (String s, char c);
-// finds the first occurrence of needle in s, -1 on failure
-// if needle.size == 0, returns -1.
-s64     String_Find_Index_Of        (String s, String needle);
+#define BITSET_BITS_PER_WORD    64
 
-// finds the line at index, and returns a String of the line, strips '\n'
-String  String_get_single_line(String s, u64 index);
 
-// advance the data, subtract the size, in place.
-// dose not check for null, or do any bounds checking. thats on you.
-void    String_Advance  (String *s, s64 count);
-// advance the data, subtract the size, returns a new copy.
-// dose not check for null, or do any bounds checking. thats on you.
-String  String_Advanced (String s, s64 count);
+// new bits are 0, if it shrinks, the bits past the new count are cleared.
+void _Bitset_Resize(Bitset *bitset, u64 new_count, Source_Code_Location caller_location);
+#define Bitset_Resize(bitset, new_count)    _Bitset_Resize((bitset), (new_count), Get_Source_Code_Location())
 
-typedef bool (*char_to_bool_func)(char);
-// remove ASCII whitespace characters from the right of the String.
-String  String_Trim_Right(String s);
-// returns a String with the front chopped off, according to the test function.
-// use Is_Whitespace to chop the whitespace off of the front.
-String  String_Chop_While(String s, char_to_bool_func test_char_function);
+// these dont do any bounds checking, Bitset_Resize() first.
+#define Bitset_Set(bitset, index)       ((bitset)->words[(u64)(index) / BITSET_BITS_PER_WORD] |=  (1ULL << ((u64)(index) % BITSET_BITS_PER_WORD)))
+#define Bitset_Clear(bitset, index)     ((bitset)->words[(u64)(index) / BITSET_BITS_PER_WORD] &= ~(1ULL << ((u64)(index) % BITSET_BITS_PER_WORD)))
+#define Bitset_Toggle(bitset, index)    ((bitset)->words[(u64)(index) / BITSET_BITS_PER_WORD] ^=  (1ULL << ((u64)(index) % BITSET_BITS_PER_WORD)))
+#define Bitset_Test(bitset, index)      (((bitset)->words[(u64)(index) / BITSET_BITS_PER_WORD] >> ((u64)(index) % BITSET_BITS_PER_WORD)) & 1)
 
+// sets every bit to 0, keeps the count.
+void Bitset_Clear_All(Bitset *bitset);
+// sets every bit to 1, (up to count).
+void Bitset_Set_All(Bitset *bitset);
 
-typedef struct {
-    // left side of the split, may be entire
-    // string if separator was not present.
-    String left;
-    // right side of the split. may be empty.
-    String right;
-    // weather the separator was in the string at all.
-    bool ok;
-} Split_Once_Result;
+// number of set bits.
+u64 Bitset_Count(Bitset *bitset);
 
-// splits the string once.
+// the index of the next set / unset bit, starting at (and including) 'from'.
 //
-// if the separator is not in the string, the left side
-// returns the whole string, and the right string is empty.
-Split_Once_Result Split_Once(String string, String separator);
+// returns bitset->count if there isn't one.
+u64 Bitset_Find_Next_Set  (Bitset *bitset, u64 from);
+u64 Bitset_Find_Next_Unset(Bitset *bitset, u64 from);
 
-// appends the string split by separator parts into the result array.
+// loop over the index of every set bit.
+#define Bitset_For_Each_Set(index, bitset)                                          \
+    for (u64 index = Bitset_Find_Next_Set((bitset), 0); index < (bitset)->count; index = Bitset_Find_Next_Set((bitset), index + 1))
+
+// dest = dest OP src, over the bits dest has.
 //
-// returns the number of sections.
-u64 String_Split_By(String string, String separator, String_Array *result);
+// if src is shorter than dest, its missing bits count as 0.
+void Bitset_And     (Bitset *dest, Bitset *src);
+void Bitset_Or      (Bitset *dest, Bitset *src);
+void Bitset_Xor     (Bitset *dest, Bitset *src);
+// dest = dest & ~src
+void Bitset_And_Not (Bitset *dest, Bitset *src);
 
+// only call this if you haven't set an allocator.
+void Bitset_Free(Bitset *bitset);
 
-String String_Path_to_Filename(String s);
-String String_Remove_Extention(String s);
 
-typedef enum {
-    SGNL_Remove_Comments = 1 << 0,
-    SGNL_Trim            = 1 << 1,
-    SGNL_Skip_Empty      = 1 << 2,
-    SGNL_All             = SGNL_Remove_Comments | SGNL_Trim | SGNL_Skip_Empty,
-} String_Get_Next_Line_Flag;
+// ===================================================
+//                  Heap / Priority Queue
+// ===================================================
 
-// gets the next line in parseing, and advances parseing and line_num to match
-// bool's toggle removeing comments that start with '#',
-// trimming the output (from the right), and skiping over empty lines.
 //
-// 'result == parseing' signifies the end of the file.
-// OR result.size == 0 if skip_empty is toggled.
-String  String_Get_Next_Line(String *parseing, u64 *line_num, String_Get_Next_Line_Flag flags);
+// A priority queue, on top of a plain Array, so the allocator works the same.
+//
+// The compare is baked into the generated functions, so it inlines.
+//
+// ```
+//     // 'a' comes out before 'b'.
+//     #define Job_Less(a, b)  ((a).priority < (b).priority)
+//
+//     // 2 for a binary heap, 4 is usually faster for big heaps (less levels, children share a cache line).
+//     Heap_Define(Job_Heap, Job, 4, Job_Less)
+//
+//     Job_Heap jobs = ZEROED;
+//     Job_Heap_Push(&jobs, job);
+//
+//     Job *next = Job_Heap_Peek(&jobs); // NULL if empty
+//     Job  job  = Job_Heap_Pop (&jobs);
+//
+//     // allready have an array? just give it the items, then heapify it in O(n).
+//     Job_Heap_Heapify(&jobs);
+//
+//     // the 10 'smallest' of some items, in the order Pop() would give them.
+//     Job best[10];
+//     u64 n = Job_Heap_Top_K(items, item_count, 10, best);
+//
+//     // its just an array.
+//     Array_Free(&jobs);
+// ```
+//
+// If you need decrease-key, use Heap_Define_Indexed(), and give it a ON_MOVE(item, index)
+// that remembers where each item is, its called every time an item lands somewhere new.
+//
+// ```
+//     #define Node_Less(a, b)             (distances[(a)] < distances[(b)])
+//     #define Node_Moved(node, index)     (heap_index_of[(node)] = (index))
+//
+//     Heap_Define_Indexed(Node_Heap, u32, 4, Node_Less, Node_Moved)
+//
+//     distances[node] = new_distance;
+//     Node_Heap_Decrease_Key(&heap, heap_index_of[node], node);
+// ```
+//
 
+#define Heap(Type)      Array(Type)
+
+#define Heap_Define(Name, Type, ARITY, LESS)        Heap_Define_Indexed(Name, Type, ARITY, LESS, Heap_Internal_No_Move)
+
+#define Heap_Define_Indexed(Name, Type, ARITY, LESS, ON_MOVE)                                               \
+    typedef Heap(Type) Name;                                                                                \
+                                                                                                            \
+    static_assert((ARITY) >= 2, "a heap needs at least 2 children per node");                              \
+                                                                                                            \
+    Heap_Internal_Define_Sift(Name##_Internal,          Type, ARITY, LESS, Heap_Internal_In_Order, ON_MOVE)                 \
+    /* a 'worst first' heap, for Top_K(). */                                                                \
+    Heap_Internal_Define_Sift(Name##_Internal_Reversed, Type, ARITY, LESS, Heap_Internal_Reversed, Heap_Internal_No_Move)   \
+                                                                                                            \
+    generated_function void Name##_Push(Name *heap, Type item) {                                            \
+        Array_Append(heap, item);                                                                           \
+        Name##_Internal_Sift_Up(heap->items, heap->count - 1);                                              \
+    }                                                                                                       \
+                                                                                                            \
+    /* NULL if the heap is empty. */                                                                        \
+    generated_function Type *Name##_Peek(Name *heap) {                                                      \
+        return heap->count ? &heap->items[0] : NULL;                                                        \
+    }                                                                                                       \
+                                                                                                            \
+    generated_function Type Name##_Pop(Name *heap) {                                                        \
+        ASSERT(heap->count > 0);                                                                            \
+        Type result = heap->items[0];                                                                       \
+        heap->count -= 1;                                                                                   \
+        if (heap->count > 0) {                                                                              \
+            heap->items[0] = heap->items[heap->count];                                                      \
+            Name##_Internal_Sift_Down(heap->items, heap->count, 0);                                         \
+        }                                                                                                   \
+        return result;                                                                                      \
+    }                                                                                                       \
+                                                                                                            \
+    /* turns whatever is in items into a heap, O(n). */                                                     \
+    generated_function void Name##_Heapify(Name *heap) {                                                    \
+        /* the leaves never get sifted, so tell ON_MOVE where everything starts. */                         \
+        for (u64 i = 0; i < heap->count; i++) ON_MOVE(heap->items[i], i);                                   \
+        if (heap->count < 2) return;                                                                        \
+        for (u64 i = (heap->count - 2) / (ARITY) + 1; i-- > 0; ) {                                          \
+            Name##_Internal_Sift_Down(heap->items, heap->count, i);                                         \
+        }                                                                                                   \
+    }                                                                                                       \
+                                                                                                            \
+    /* replace the item at 'index' with one that comes out sooner (or the same). */                         \
+    generated_function void Name##_Decrease_Key(Name *heap, u64 index, Type item) {                         \
+        ASSERT(index < heap->count);                                                                        \
+        ASSERT(!(LESS(heap->items[index], item)) && "Decrease_Key() cant make an item come out later");    \
+        heap->items[index] = item;                                                                          \
+        Name##_Internal_Sift_Up(heap->items, index);                                                        \
+    }                                                                                                       \
+                                                                                                            \
+    /* the item at 'index' changed in some way, put it back where it belongs. */                            \
+    generated_function void Name##_Update(Name *heap, u64 index) {                                          \
+        ASSERT(index < heap->count);                                                                        \
+        if (index > 0 && (LESS(heap->items[index], heap->items[(index - 1) / (ARITY)]))) {                 \
+            Name##_Internal_Sift_Up(heap->items, index);                                                    \
+        } else {                                                                                            \
+            Name##_Internal_Sift_Down(heap->items, heap->count, index);                                     \
+        }                                                                                                   \
+    }                                                                                                       \
+                                                                                                            \
+    generated_function Type Name##_Remove(Name *heap, u64 index) {                                          \
+        ASSERT(index < heap->count);                                                                        \
+        Type result = heap->items[index];                                                                   \
+        heap->count -= 1;                                                                                   \
+        if (index != heap->count) {                                                                         \
+            heap->items[index] = heap->items[heap->count];                                                  \
+            Name##_Update(heap, index);                                                                     \
+        }                                                                                                   \
+        return result;                                                                                      \
+    }                                                                                                       \
+                                                                                                            \
+    /* puts the first 'k' items Pop() would give out into 'out', in order. */                               \
+    /* 'out' has to have room for 'k' items, returns Min(k, count). */                                      \
+    generated_function u64 Name##_Top_K(Type *items, u64 count, u64 k, Type *out) {                         \
+        u64 n = 0;                                                                                          \
+        for (u64 i = 0; i < count; i++) {                                                                   \
+            if (n < k) {                                                                                    \
+                out[n] = items[i];                                                                          \
+                Name##_Internal_Reversed_Sift_Up(out, n);                                                   \
+                n += 1;                                                                                     \
+            } else if (k > 0 && (LESS(items[i], out[0]))) {                                                 \
+                /* better than the worst one we have. */                                                    \
+                out[0] = items[i];                                                                          \
+                Name##_Internal_Reversed_Sift_Down(out, n, 0);                                              \
+            }                                                                                               \
+        }                                                                                                   \
+        /* heap sort, the worst goes to the back. */                                                        \
+        for (u64 end = n; end > 1; end--) {                                                                 \
+            Type tmp = out[0]; out[0] = out[end - 1]; out[end - 1] = tmp;                                   \
+            Name##_Internal_Reversed_Sift_Down(out, end - 1, 0);                                            \
+        }                                                                                                   \
+        return n;                                                                                           \
+    }
 
-const char *temp_sprintf       (const char *format, ...) __attribute__ ((format (printf, 1, 2)));
-// is null terminated
-String      temp_String_sprintf(const char *format, ...) __attribute__ ((format (printf, 1, 2)));
+
+// internal heap stuff.
+#define Heap_Internal_No_Move(item, index)      ((void)0)
+#define Heap_Internal_In_Order(a, b)            (a, b)
+#define Heap_Internal_Reversed(a, b)            (b, a)
+// ORDER() expands to the argument list first, then LESS gets called with it.
+#define Heap_Internal_Call(LESS, args)          (LESS args)
+
+// moves the hole instead of swapping, each step is one copy.
+#define Heap_Internal_Define_Sift(Prefix, Type, ARITY, LESS, ORDER, ON_MOVE)                                \
+    generated_function void Prefix##_Sift_Up(Type *items, u64 index) {                                      \
+        Type item = items[index];                                                                           \
+        while (index > 0) {                                                                                 \
+            u64 parent = (index - 1) / (ARITY);                                                             \
+            if (!Heap_Internal_Call(LESS, ORDER(item, items[parent]))) break;                               \
+            items[index] = items[parent];                                                                   \
+            ON_MOVE(items[index], index);                                                                   \
+            index = parent;                                                                                 \
+        }                                                                                                   \
+        items[index] = item;                                                                                \
+        ON_MOVE(items[index], index);                                                                       \
+    }                                                                                                       \
+                                                                                                            \
+    generated_function void Prefix##_Sift_Down(Type *items, u64 count, u64 index) {                         \
+        Type item = items[index];                                                                           \
+        while (true) {                                                                                      \
+            u64 first_child = index * (ARITY) + 1;                                                          \
+            if (first_child >= count) break;                                                                \
+            u64 end_child = Min(first_child + (ARITY), count);                                              \
+                                                                                                            \
+            u64 best = first_child;                                                                         \
+            for (u64 child = first_child + 1; child < end_child; child++) {                                 \
+                if (Heap_Internal_Call(LESS, ORDER(items[child], items[best]))) best = child;               \
+            }                                                                                               \
+            if (!Heap_Internal_Call(LESS, ORDER(items[best], item))) break;                                 \
+                                                                                                            \
+            items[index] = items[best];                                                                     \
+            ON_MOVE(items[index], index);                                                                   \
+            index = best;                                                                                   \
+        }                                                                                                   \
+        items[index] = item;                                                                                \
+        ON_MOVE(items[index], index);                                                                       \
+    }
 
 
 
 // ===================================================
-//                    String Builder
+//                     Slot Map
 // ===================================================
 
-#define STRING_BUILDER_NUM_BUFFERS      32
-static_assert(Is_Pow_2(STRING_BUILDER_NUM_BUFFERS), "For Speed");
-
-// how much to alloc by default when a new segment of memory is needed.
-#ifndef STRING_BUILDER_BUFFER_DEFAULT_SIZE
-    // 4096 bytes is equal to the default page size in windows and linux. probably.
-    #define STRING_BUILDER_BUFFER_DEFAULT_SIZE      (4 * KILOBYTE)
-#endif
+//
+// Items live packed together in 'items', (so its just as fast to loop over as an Array),
+// but you hold onto a handle instead of an index or a pointer.
+//
+// Handles never go stale without you knowing, removing an item bumps its slots
+// generation, so any old handle to it just gets NULL back from Slot_Map_Get().
+//
+// Insert, Remove and Get are all O(1).
+//
+// ```
+//     Slot_Map(Entity) entities = ZEROED; // or set .allocator, same as arrays.
+//
+//     Slot_Map_Handle player = Slot_Map_Insert(&entities, ((Entity){ .hp = 100 }));
+//
+//     Entity *e = Slot_Map_Get(&entities, player); // NULL if its been removed.
+//
+//     // its shaped like an Array, so this just works.
+//     Array_For_Each(it, &entities) {
+//         Slot_Map_Handle handle = Slot_Map_Handle_Of(&entities, it - entities.items);
+//     }
+//
+//     Slot_Map_Remove(&entities, player); // the last item gets moved into the hole.
+//
+//     Slot_Map_Free(&entities);
+// ```
+//
 
-// This macro is called when something goes wrong. Recommended to just use assert.
+// the generation is in the top 32 bits, the slot in the bottom 32.
 //
-// If the macro dose nothing, (or doesn't exist,) the results of some operations
-// will return NULL/base values. or do no work at all. use at your own risk.
-#ifndef STRING_BUILDER_PANIC
-    #define STRING_BUILDER_PANIC(error_text)        ASSERT(false && error_text)
-#endif
+// a slot with an odd generation is in use, so 0 is never a valid handle,
+// feel free to use it as 'no handle'.
+typedef u64 Slot_Map_Handle;
 
+typedef struct {
+    u32 generation;
+    // if the slot is in use, where the item is in 'items',
+    // otherwise the next free slot + 1.
+    u32 index;
+} Slot_Map_Slot;
+
+typedef Array(u32)              Slot_Map_Index_Array;
+typedef Array(Slot_Map_Slot)    Slot_Map_Slot_Array;
+
+#define Slot_Map(Type)                              \
+    struct {                                        \
+        Type *items;                                \
+        u64 count;                                  \
+        u64 capacity;                               \
+        Arena *allocator;                           \
+                                                    \
+        /* which slot each item belongs to */       \
+        Slot_Map_Index_Array slot_of_item;          \
+        Slot_Map_Slot_Array slots;                  \
+        /* first free slot + 1, 0 means none */     \
+        u32 free_list;                              \
+    }
 
-// String Builder internal structure
-// holds the segments of the being built string.
+// this struct shares the same shape as every slot map.
 typedef struct {
-    char *data;
+    void *items;
     u64 count;
     u64 capacity;
-} Character_Buffer;
+    Arena *allocator;
 
-// String Builder internal structure
-// Holds a bunch character buffers, and a pointer to the next Segment as well,
-// Acts like a linked list node.
-typedef struct Segment {
-    struct Segment *next;
-    Character_Buffer buffers[STRING_BUILDER_NUM_BUFFERS];
-} Segment;
+    Slot_Map_Index_Array slot_of_item;
+    Slot_Map_Slot_Array slots;
+    u32 free_list;
+} Generic_Slot_Map;
 
-// A data-structure that can efficiently grow a string.
-// good for medium to large strings. small strings (< 4096 bytes) are not recommended, as this structure will allocate once.
-typedef struct String_Builder {
-    // how much to allocate when a new segment is needed.
-    u64 base_new_allocation;
 
-    // the current segment were working on.
-    // if its pointing to NULL, (aka you just zero initalized it), it will be set to a pointer to 'first_segment_holder'
-    Segment *current_segment;
+// adds an item on the end of 'items', (uninitialized), and gives it a slot.
+Slot_Map_Handle Generic_Slot_Map_Insert(Generic_Slot_Map *slot_map, Array_Item_Type_Properties_Struct item_properties, Source_Code_Location caller_location);
+// returns false if the handle was allready dead.
+bool Generic_Slot_Map_Remove(Generic_Slot_Map *slot_map, Array_Item_Type_Properties_Struct item_properties, Slot_Map_Handle handle);
+// removes everything, every handle goes stale, keeps the memory.
+void Generic_Slot_Map_Clear(Generic_Slot_Map *slot_map);
+// only call this if you haven't set an allocator.
+void Generic_Slot_Map_Free(Generic_Slot_Map *slot_map, Array_Item_Type_Properties_Struct item_properties);
 
-    // last buffer in use.
-    u64 buffer_index;
-    // the first in a linked list.
-    Segment first_segment_holder;
 
-    // set an allocator to use it to allocate, otherwise uses 'BESTED_MALLOC()'.
-    Arena *allocator;
-} String_Builder;
+#define Slot_Map_Handle_Slot(handle)            ((u32)((handle) & 0xFFFFFFFF))
+#define Slot_Map_Handle_Generation(handle)      ((u32)((handle) >> 32))
 
+#define Slot_Map_Insert(slot_map, value)                                                                                                \
+    ({                                                                                                                                  \
+        Slot_Map_Handle _handle = Generic_Slot_Map_Insert((Generic_Slot_Map*)(slot_map), Get_Item_Type_Properties(slot_map), Get_Source_Code_Location());   \
+        (slot_map)->items[(slot_map)->count - 1] = (value);                                                                            \
+        _handle;                                                                                                                        \
+    })
 
-// current size of the string being built.
+// pointer to the item, or NULL if the handle is stale.
 //
-// this calculation runs though all of the segments, so dont spam it maybe.
-u64 String_Builder_Count(String_Builder *sb);
-// how much space the builder has.
-// NOTE. some space will be wasted, for performance reasons.
-u64 String_Builder_Total_Capacity(String_Builder *sb);
+// the pointer is good until the next Insert() or Remove().
+#define Slot_Map_Get(slot_map, handle)                                                                          \
+    ({                                                                                                          \
+        Slot_Map_Handle _handle = (handle);                                                                     \
+        u32 _slot = Slot_Map_Handle_Slot(_handle);                                                              \
+        u32 _generation = Slot_Map_Handle_Generation(_handle);                                                  \
+        bool _alive = (_generation & 1) && _slot < (slot_map)->slots.count && (slot_map)->slots.items[_slot].generation == _generation;   \
+        _alive ? &(slot_map)->items[(slot_map)->slots.items[_slot].index] : NULL;                               \
+    })
+
+#define Slot_Map_Contains(slot_map, handle)     (Slot_Map_Get(slot_map, handle) != NULL)
+
+// the handle of the item at 'index' in 'items'.
+#define Slot_Map_Handle_Of(slot_map, index)                                                                     \
+    ({                                                                                                          \
+        u32 _slot = (slot_map)->slot_of_item.items[(index)];                                                    \
+        ((Slot_Map_Handle)(slot_map)->slots.items[_slot].generation << 32) | _slot;                             \
+    })
+
+#define Slot_Map_Remove(slot_map, handle)   Generic_Slot_Map_Remove((Generic_Slot_Map*)(slot_map), Get_Item_Type_Properties(slot_map), (handle))
+#define Slot_Map_Clear(slot_map)            Generic_Slot_Map_Clear((Generic_Slot_Map*)(slot_map))
+#define Slot_Map_Free(slot_map)             Generic_Slot_Map_Free((Generic_Slot_Map*)(slot_map), Get_Item_Type_Properties(slot_map))
+
+
+
+// ===================================================
+//                  B-Tree / Ordered Map
+// ===================================================
+
+// how big a node is, in bytes, a handful of cache lines.
+//
+// the keys of a node are next to each other, so a search
+// inside one only touches the first few lines.
+#ifndef B_TREE_NODE_SIZE
+    #define B_TREE_NODE_SIZE    512
+#endif
+#ifndef B_TREE_NODE_ALIGNMENT
+    #define B_TREE_NODE_ALIGNMENT   64
+#endif
+
+//
+// A sorted map, for when you need the keys in order, or every key between two others.
+// Hash_Map is faster for lookups, but it cant do either of those.
+//
+// Its a B+tree, the keys and values are only in the leaves, and the leaves are
+// linked together, so walking a range is just walking an array, then the next one.
+//
+// The compare is baked into the generated functions, same as the heap.
+//
+// ```
+//     #define Id_Less(a, b)   ((a) < (b))
+//     B_Tree_Define(Id_Tree, u64, f32, Id_Less)
+//
+//     Id_Tree tree = ZEROED; // or set .allocator, then the nodes come from there.
+//
+//     *Id_Tree_Put(&tree, 12) = 0.5;
+//     f32 *value = Id_Tree_Get(&tree, 12); // NULL if its not in there.
+//     Id_Tree_Remove(&tree, 12);
+//
+//     // every key in [10, 20), in order.
+//     Id_Tree_Iterator it = Id_Tree_Range(&tree, 10, 20);
+//     while (Id_Tree_Next(&it)) printf("%zu => %f\n", *it.key, *it.value);
+//
+//     // or everything from the first key thats >= 10, (Id_Tree_Begin() for all of them).
+//     it = Id_Tree_Lower_Bound(&tree, 10);
+//
+//     Id_Tree_Free(&tree);
+// ```
+//
+// removed nodes go on a free list, and get reused before asking the arena for more.
+// Put() and Remove() move entries around, so the pointers they give out,
+// (and any iterators), are only good until the next one.
+//
+
+#define B_Tree_Define(Name, Key_Type, Value_Type, LESS)                                                     \
+    /* the most keys a node can hold, (at least 4, or the splits and merges dont work). */                  \
+    enum {                                                                                                  \
+        Name##_LEAF_CAPACITY   = B_Tree_Internal_Capacity(B_TREE_NODE_SIZE - sizeof(void*) - 8, sizeof(Key_Type) + sizeof(Value_Type)), \
+        Name##_BRANCH_CAPACITY = B_Tree_Internal_Capacity(B_TREE_NODE_SIZE - sizeof(void*) - 8, sizeof(Key_Type) + sizeof(void*)), \
+    };                                                                                                      \
+                                                                                                            \
+    typedef struct Name##_Leaf {                                                                            \
+        u32 count;                                                                                          \
+        u32 is_leaf;                                                                                        \
+        /* the leaves are a linked list, in order, (or the free list, once its removed). */                 \
+        struct Name##_Leaf *next;                                                                           \
+        Key_Type   keys  [Name##_LEAF_CAPACITY];                                                            \
+        Value_Type values[Name##_LEAF_CAPACITY];                                                            \
+    } Name##_Leaf;                                                                                          \
+                                                                                                            \
+    typedef struct Name##_Branch {                                                                          \
+        u32 count;                                                                                          \
+        u32 is_leaf;                                                                                        \
+        /* children[i] has the keys that are >= keys[i-1], and < keys[i]. */                                \
+        void    *children[Name##_BRANCH_CAPACITY + 1];                                                      \
+        Key_Type keys    [Name##_BRANCH_CAPACITY];                                                          \
+    } Name##_Branch;                                                                                        \
+                                                                                                            \
+    typedef struct {                                                                                        \
+        void *root;                                                                                         \
+        u64 count;                                                                                          \
+        /* how many branches down the leaves are. */                                                        \
+        u32 height;                                                                                         \
+                                                                                                            \
+        /* a settable arena allocator, if its NULL the tree uses its own. */                                \
+        Arena *allocator;                                                                                   \
+        Arena arena;                                                                                        \
+                                                                                                            \
+        Name##_Leaf   *free_leaves;                                                                         \
+        Name##_Branch *free_branches;                                                                       \
+    } Name;                                                                                                 \
+                                                                                                            \
+    typedef struct {                                                                                        \
+        Name##_Leaf *leaf;                                                                                  \
+        u32 index;                                                                                          \
+        bool has_end;                                                                                       \
+        Key_Type end;                                                                                       \
+                                                                                                            \
+        /* set by Next(). */                                                                                \
+        Key_Type   *key;                                                                                    \
+        Value_Type *value;                                                                                  \
+    } Name##_Iterator;                                                                                      \
+                                                                                                            \
+    /* first keys[i] thats >= key. */                                                                       \
+    generated_function u32 Name##_Internal_Lower_Bound(Key_Type *keys, u32 count, Key_Type key) {           \
+        u32 low = 0, high = count;                                                                          \
+        while (low < high) {                                                                                \
+            u32 middle = (low + high) / 2;                                                                  \
+            if (LESS(keys[middle], key)) low = middle + 1;                                                  \
+            else                         high = middle;                                                     \
+        }                                                                                                   \
+        return low;                                                                                         \
+    }                                                                                                       \
+    /* first keys[i] thats > key, so the child of a branch that key would be in. */                         \
+    generated_function u32 Name##_Internal_Upper_Bound(Key_Type *keys, u32 count, Key_Type key) {           \
+        u32 low = 0, high = count;                                                                          \
+        while (low < high) {                                                                                \
+            u32 middle = (low + high) / 2;                                                                  \
+            if (LESS(key, keys[middle])) high = middle;                                                     \
+            else                         low  = middle + 1;                                                 \
+        }                                                                                                   \
+        return low;                                                                                         \
+    }                                                                                                       \
+                                                                                                            \
+    generated_function Name##_Leaf *Name##_Internal_New_Leaf(Name *tree) {                                  \
+        Name##_Leaf *leaf = tree->free_leaves;                                                              \
+        if (leaf) {                                                                                         \
+            tree->free_leaves = leaf->next;                                                                 \
+        } else {                                                                                            \
+            Arena *arena = tree->allocator ? tree->allocator : &tree->arena;                                \
+            leaf = Arena_Alloc(arena, sizeof(Name##_Leaf), .alignment = B_TREE_NODE_ALIGNMENT, .clear_to_zero = false); \
+        }                                                                                                   \
+        leaf->count   = 0;                                                                                  \
+        leaf->is_leaf = true;                                                                               \
+        leaf->next    = NULL;                                                                               \
+        return leaf;                                                                                        \
+    }                                                                                                       \
+    generated_function Name##_Branch *Name##_Internal_New_Branch(Name *tree) {                              \
+        Name##_Branch *branch = tree->free_branches;                                                        \
+        if (branch) {                                                                                       \
+            tree->free_branches = branch->children[0];                                                      \
+        } else {                                                                                            \
+            Arena *arena = tree->allocator ? tree->allocator : &tree->arena;                                \
+            branch = Arena_Alloc(arena, sizeof(Name##_Branch), .alignment = B_TREE_NODE_ALIGNMENT, .clear_to_zero = false); \
+        }                                                                                                   \
+        branch->count   = 0;                                                                                \
+        branch->is_leaf = false;                                                                            \
+        return branch;                                                                                      \
+    }                                                                                                       \
+    generated_function void Name##_Internal_Free_Leaf(Name *tree, Name##_Leaf *leaf) {                      \
+        leaf->next = tree->free_leaves;                                                                     \
+        tree->free_leaves = leaf;                                                                           \
+    }                                                                                                       \
+    /* the first child pointer is the free list link. */                                                    \
+    generated_function void Name##_Internal_Free_Branch(Name *tree, Name##_Branch *branch) {                \
+        branch->children[0] = tree->free_branches;                                                          \
+        tree->free_branches = branch;                                                                       \
+    }                                                                                                       \
+                                                                                                            \
+    /* the leaf the key is in, (or would be in). */                                                         \
+    generated_function Name##_Leaf *Name##_Internal_Find_Leaf(Name *tree, Key_Type key) {                   \
+        void *node = tree->root;                                                                            \
+        for (u32 level = 0; level < tree->height; level++) {                                                \
+            Name##_Branch *branch = node;                                                                   \
+            node = branch->children[Name##_Internal_Upper_Bound(branch->keys, branch->count, key)];         \
+        }                                                                                                   \
+        return node;                                                                                        \
+    }                                                                                                       \
+                                                                                                            \
+    /* NULL if the key is not in the tree. */                                                               \
+    generated_function Value_Type *Name##_Get(Name *tree, Key_Type key) {                                   \
+        if (!tree->root) return NULL;                                                                       \
+        Name##_Leaf *leaf = Name##_Internal_Find_Leaf(tree, key);                                           \
+        u32 index = Name##_Internal_Lower_Bound(leaf->keys, leaf->count, key);                              \
+        if (index < leaf->count && !(LESS(key, leaf->keys[index]))) return &leaf->values[index];            \
+        return NULL;                                                                                        \
+    }                                                                                                       \
+                                                                                                            \
+    generated_function bool Name##_Contains(Name *tree, Key_Type key) {                                     \
+        return Name##_Get(tree, key) != NULL;                                                               \
+    }                                                                                                       \
+                                                                                                            \
+    /* splits the full child at 'index' in two, the parent gets the new separator. */                       \
+    generated_function void Name##_Internal_Split_Child(Name *tree, Name##_Branch *parent, u32 index) {     \
+        Key_Type separator;                                                                                 \
+        void *right_node;                                                                                   \
+                                                                                                            \
+        if (((Name##_Leaf*)parent->children[index])->is_leaf) {                                             \
+            Name##_Leaf *left  = parent->children[index];                                                   \
+            Name##_Leaf *right = Name##_Internal_New_Leaf(tree);                                            \
+            u32 half = left->count / 2;                                                                     \
+            right->count = left->count - half;                                                              \
+            Mem_Copy(right->keys,   left->keys   + half, right->count * sizeof(Key_Type));                  \
+            Mem_Copy(right->values, left->values + half, right->count * sizeof(Value_Type));                \
+            left->count = half;                                                                             \
+                                                                                                            \
+            right->next = left->next;                                                                       \
+            left->next  = right;                                                                            \
+            separator  = right->keys[0];                                                                    \
+            right_node = right;                                                                             \
+        } else {                                                                                            \
+            /* the middle key moves up, its not in either half. */                                          \
+            Name##_Branch *left  = parent->children[index];                                                 \
+            Name##_Branch *right = Name##_Internal_New_Branch(tree);                                        \
+            u32 half = left->count / 2;                                                                     \
+            right->count = left->count - half - 1;                                                          \
+            Mem_Copy(right->keys,     left->keys     + half + 1, right->count * sizeof(Key_Type));          \
+            Mem_Copy(right->children, left->children + half + 1, (right->count + 1) * sizeof(void*));       \
+            left->count = half;                                                                             \
+                                                                                                            \
+            separator  = left->keys[half];                                                                  \
+            right_node = right;                                                                             \
+        }                                                                                                   \
+                                                                                                            \
+        Mem_Move(parent->keys     + index + 1, parent->keys     + index,     (parent->count - index)     * sizeof(Key_Type)); \
+        Mem_Move(parent->children + index + 2, parent->children + index + 1, (parent->count - index)     * sizeof(void*)); \
+        parent->keys    [index]     = separator;                                                            \
+        parent->children[index + 1] = right_node;                                                           \
+        parent->count += 1;                                                                                 \
+    }                                                                                                       \
+                                                                                                            \
+    generated_function bool Name##_Internal_Is_Full(void *node) {                                           \
+        Name##_Leaf *leaf = node;                                                                           \
+        return leaf->count == (leaf->is_leaf ? (u32)Name##_LEAF_CAPACITY : (u32)Name##_BRANCH_CAPACITY);    \
+    }                                                                                                       \
+                                                                                                            \
+    /* pointer to the keys value, if its new, the value is zeroed. */                                       \
+    generated_function Value_Type *Name##_Put(Name *tree, Key_Type key) {                                   \
+        if (!tree->root) tree->root = Name##_Internal_New_Leaf(tree);                                       \
+                                                                                                            \
+        /* full nodes get split on the way down, so theres always room for the separator. */                \
+        if (Name##_Internal_Is_Full(tree->root)) {                                                          \
+            Name##_Branch *new_root = Name##_Internal_New_Branch(tree);                                     \
+            new_root->children[0] = tree->root;                                                             \
+            Name##_Internal_Split_Child(tree, new_root, 0);                                                 \
+            tree->root    = new_root;                                                                       \
+            tree->height += 1;                                                                              \
+        }                                                                                                   \
+                                                                                                            \
+        void *node = tree->root;                                                                            \
+        for (u32 level = 0; level < tree->height; level++) {                                                \
+            Name##_Branch *branch = node;                                                                   \
+            u32 index = Name##_Internal_Upper_Bound(branch->keys, branch->count, key);                      \
+            if (Name##_Internal_Is_Full(branch->children[index])) {                                         \
+                Name##_Internal_Split_Child(tree, branch, index);                                           \
+                if (!(LESS(key, branch->keys[index]))) index += 1;                                          \
+            }                                                                                               \
+            node = branch->children[index];                                                                 \
+        }                                                                                                   \
+                                                                                                            \
+        Name##_Leaf *leaf = node;                                                                           \
+        u32 index = Name##_Internal_Lower_Bound(leaf->keys, leaf->count, key);                              \
+        if (index < leaf->count && !(LESS(key, leaf->keys[index]))) return &leaf->values[index];            \
+                                                                                                            \
+        Mem_Move(leaf->keys   + index + 1, leaf->keys   + index, (leaf->count - index) * sizeof(Key_Type)); \
+        Mem_Move(leaf->values + index + 1, leaf->values + index, (leaf->count - index) * sizeof(Value_Type)); \
+        leaf->keys[index] = key;                                                                            \
+        Mem_Zero(&leaf->values[index], sizeof(Value_Type));                                                 \
+        leaf->count += 1;                                                                                   \
+        tree->count += 1;                                                                                   \
+        return &leaf->values[index];                                                                        \
+    }                                                                                                       \
+                                                                                                            \
+    /* makes sure the child at 'index' can lose a key, by borrowing from or merging with a sibling. */      \
+    /* returns the index of the child the key is in now. */                                                 \
+    generated_function u32 Name##_Internal_Fix_Child(Name *tree, Name##_Branch *parent, u32 index) {        \
+        Name##_Leaf *child_leaf = parent->children[index];                                                  \
+        bool is_leaf = child_leaf->is_leaf;                                                                 \
+        u32 minimum  = is_leaf ? Name##_LEAF_CAPACITY / 2 : (Name##_BRANCH_CAPACITY - 1) / 2;               \
+        if (child_leaf->count > minimum) return index;                                                      \
+                                                                                                            \
+        Name##_Leaf *left_leaf  = (index > 0)             ? parent->children[index - 1] : NULL;             \
+        Name##_Leaf *right_leaf = (index < parent->count) ? parent->children[index + 1] : NULL;             \
+                                                                                                            \
+        if (is_leaf) {                                                                                      \
+            Name##_Leaf *child = child_leaf;                                                                \
+            if (left_leaf && left_leaf->count > minimum) {                                                  \
+                Mem_Move(child->keys   + 1, child->keys,   child->count * sizeof(Key_Type));                \
+                Mem_Move(child->values + 1, child->values, child->count * sizeof(Value_Type));              \
+                left_leaf->count -= 1;                                                                      \
+                child->keys  [0] = left_leaf->keys  [left_leaf->count];                                     \
+                child->values[0] = left_leaf->values[left_leaf->count];                                     \
+                child->count += 1;                                                                          \
+                parent->keys[index - 1] = child->keys[0];                                                   \
+                return index;                                                                               \
+            }                                                                                               \
+            if (right_leaf && right_leaf->count > minimum) {                                                \
+                child->keys  [child->count] = right_leaf->keys  [0];                                        \
+                child->values[child->count] = right_leaf->values[0];                                        \
+                child->count += 1;                                                                          \
+                right_leaf->count -= 1;                                                                     \
+                Mem_Move(right_leaf->keys,   right_leaf->keys   + 1, right_leaf->count * sizeof(Key_Type)); \
+                Mem_Move(right_leaf->values, right_leaf->values + 1, right_leaf->count * sizeof(Value_Type)); \
+                parent->keys[index] = right_leaf->keys[0];                                                  \
+                return index;                                                                               \
+            }                                                                                               \
+        } else {                                                                                            \
+            Name##_Branch *child = parent->children[index];                                                 \
+            Name##_Branch *left  = (Name##_Branch*)left_leaf;                                               \
+            Name##_Branch *right = (Name##_Branch*)right_leaf;                                              \
+            /* the separator comes down, the siblings key goes up. */                                       \
+            if (left && left->count > minimum) {                                                            \
+                Mem_Move(child->keys     + 1, child->keys,     child->count       * sizeof(Key_Type));      \
+                Mem_Move(child->children + 1, child->children, (child->count + 1) * sizeof(void*));         \
+                child->keys    [0] = parent->keys[index - 1];                                               \
+                child->children[0] = left->children[left->count];                                           \
+                child->count += 1;                                                                          \
+                left->count  -= 1;                                                                          \
+                parent->keys[index - 1] = left->keys[left->count];                                          \
+                return index;                                                                               \
+            }                                                                                               \
+            if (right && right->count > minimum) {                                                          \
+                child->keys    [child->count]     = parent->keys[index];                                    \
+                child->children[child->count + 1] = right->children[0];                                     \
+                child->count += 1;                                                                          \
+                parent->keys[index] = right->keys[0];                                                       \
+                right->count -= 1;                                                                          \
+                Mem_Move(right->keys,     right->keys     + 1, right->count       * sizeof(Key_Type));      \
+                Mem_Move(right->children, right->children + 1, (right->count + 1) * sizeof(void*));         \
+                return index;                                                                               \
+            }                                                                                               \
+        }                                                                                                   \
+                                                                                                            \
+        /* neither sibling can spare one, so merge with one of them, (the left one goes first). */          \
+        u32 left_index = (index > 0) ? index - 1 : index;                                                   \
+        if (is_leaf) {                                                                                      \
+            Name##_Leaf *left  = parent->children[left_index];                                              \
+            Name##_Leaf *right = parent->children[left_index + 1];                                          \
+            Mem_Copy(left->keys   + left->count, right->keys,   right->count * sizeof(Key_Type));           \
+            Mem_Copy(left->values + left->count, right->values, right->count * sizeof(Value_Type));         \
+            left->count += right->count;                                                                    \
+            left->next   = right->next;                                                                     \
+            Name##_Internal_Free_Leaf(tree, right);                                                         \
+        } else {                                                                                            \
+            Name##_Branch *left  = parent->children[left_index];                                            \
+            Name##_Branch *right = parent->children[left_index + 1];                                        \
+            left->keys[left->count] = parent->keys[left_index];                                             \
+            Mem_Copy(left->keys     + left->count + 1, right->keys,     right->count       * sizeof(Key_Type)); \
+            Mem_Copy(left->children + left->count + 1, right->children, (right->count + 1) * sizeof(void*)); \
+            left->count += right->count + 1;                                                                \
+            Name##_Internal_Free_Branch(tree, right);                                                       \
+        }                                                                                                   \
+                                                                                                            \
+        parent->count -= 1;                                                                                 \
+        Mem_Move(parent->keys     + left_index,     parent->keys     + left_index + 1, (parent->count - left_index) * sizeof(Key_Type)); \
+        Mem_Move(parent->children + left_index + 1, parent->children + left_index + 2, (parent->count - left_index) * sizeof(void*)); \
+        return left_index;                                                                                  \
+    }                                                                                                       \
+                                                                                                            \
+    /* returns false if the key wasn't in there. */                                                         \
+    generated_function bool Name##_Remove(Name *tree, Key_Type key) {                                       \
+        if (!tree->root) return false;                                                                      \
+                                                                                                            \
+        /* small nodes get fixed on the way down, so the leaf can always lose one. */                       \
+        void *node = tree->root;                                                                            \
+        while (!((Name##_Leaf*)node)->is_leaf) {                                                            \
+            Name##_Branch *branch = node;                                                                   \
+            u32 index = Name##_Internal_Upper_Bound(branch->keys, branch->count, key);                      \
+            index = Name##_Internal_Fix_Child(tree, branch, index);                                         \
+                                                                                                            \
+            /* the root lost its last key, its only child takes its place. */                               \
+            if (branch == tree->root && branch->count == 0) {                                               \
+                tree->root    = branch->children[0];                                                        \
+                tree->height -= 1;                                                                          \
+                Name##_Internal_Free_Branch(tree, branch);                                                  \
+                node = tree->root;                                                                          \
+                continue;                                                                                   \
+            }                                                                                               \
+            node = branch->children[index];                                                                 \
+        }                                                                                                   \
+                                                                                                            \
+        Name##_Leaf *leaf = node;                                                                           \
+        u32 index = Name##_Internal_Lower_Bound(leaf->keys, leaf->count, key);                              \
+        if (index == leaf->count || LESS(key, leaf->keys[index])) return false;                             \
+                                                                                                            \
+        leaf->count -= 1;                                                                                   \
+        Mem_Move(leaf->keys   + index, leaf->keys   + index + 1, (leaf->count - index) * sizeof(Key_Type)); \
+        Mem_Move(leaf->values + index, leaf->values + index + 1, (leaf->count - index) * sizeof(Value_Type)); \
+        tree->count -= 1;                                                                                   \
+        return true;                                                                                        \
+    }                                                                                                       \
+                                                                                                            \
+    /* starts at the first key thats >= key, call Next() to get it. */                                      \
+    generated_function Name##_Iterator Name##_Lower_Bound(Name *tree, Key_Type key) {                       \
+        Name##_Iterator it = ZEROED;                                                                        \
+        if (!tree->root) return it;                                                                         \
+        it.leaf  = Name##_Internal_Find_Leaf(tree, key);                                                    \
+        it.index = Name##_Internal_Lower_Bound(it.leaf->keys, it.leaf->count, key);                         \
+        return it;                                                                                          \
+    }                                                                                                       \
+                                                                                                            \
+    /* every key, in order. */                                                                              \
+    generated_function Name##_Iterator Name##_Begin(Name *tree) {                                           \
+        Name##_Iterator it = ZEROED;                                                                        \
+        void *node = tree->root;                                                                            \
+        for (u32 level = 0; node && level < tree->height; level++) node = ((Name##_Branch*)node)->children[0]; \
+        it.leaf = node;                                                                                     \
+        return it;                                                                                          \
+    }                                                                                                       \
+                                                                                                            \
+    /* every key in [low, high). */                                                                         \
+    generated_function Name##_Iterator Name##_Range(Name *tree, Key_Type low, Key_Type high) {              \
+        Name##_Iterator it = Name##_Lower_Bound(tree, low);                                                 \
+        it.has_end = true;                                                                                  \
+        it.end     = high;                                                                                  \
+        return it;                                                                                          \
+    }                                                                                                       \
+                                                                                                            \
+    /* moves to the next key, and sets it.key and it.value, returns false when its done. */                 \
+    generated_function bool Name##_Next(Name##_Iterator *it) {                                              \
+        while (it->leaf && it->index >= it->leaf->count) {                                                  \
+            it->leaf  = it->leaf->next;                                                                     \
+            it->index = 0;                                                                                  \
+        }                                                                                                   \
+        if (!it->leaf || (it->has_end && !(LESS(it->leaf->keys[it->index], it->end)))) {                    \
+            it->leaf  = NULL;                                                                               \
+            it->key   = NULL;                                                                               \
+            it->value = NULL;                                                                               \
+            return false;                                                                                   \
+        }                                                                                                   \
+        it->key   = &it->leaf->keys  [it->index];                                                           \
+        it->value = &it->leaf->values[it->index];                                                           \
+        it->index += 1;                                                                                     \
+        return true;                                                                                        \
+    }                                                                                                       \
+                                                                                                            \
+    /* 'height' is how many branches down the leaves are from this node. */                                 \
+    generated_function void Name##_Internal_Free_Node(Name *tree, void *node, u32 height) {                 \
+        if (height == 0) {                                                                                  \
+            Name##_Internal_Free_Leaf(tree, node);                                                          \
+            return;                                                                                         \
+        }                                                                                                   \
+        Name##_Branch *branch = node;                                                                       \
+        for (u32 i = 0; i <= branch->count; i++) Name##_Internal_Free_Node(tree, branch->children[i], height - 1); \
+        Name##_Internal_Free_Branch(tree, branch);                                                          \
+    }                                                                                                       \
+                                                                                                            \
+    /* removes everything, the nodes go on the free lists. */                                               \
+    generated_function void Name##_Clear(Name *tree) {                                                      \
+        if (tree->root) Name##_Internal_Free_Node(tree, tree->root, tree->height);                          \
+        tree->root   = NULL;                                                                                \
+        tree->count  = 0;                                                                                   \
+        tree->height = 0;                                                                                   \
+    }                                                                                                       \
+                                                                                                            \
+    /* only frees the nodes if you haven't set an allocator. */                                             \
+    generated_function void Name##_Free(Name *tree) {                                                       \
+        if (!tree->allocator) Arena_Free(&tree->arena);                                                     \
+        *tree = (Name)ZEROED;                                                                               \
+    }
+
+
+// internal b-tree stuff.
+#define B_Tree_Internal_Capacity(bytes, entry_size)     ((bytes) / (entry_size) < 4 ? 4 : (bytes) / (entry_size))
+
+
+
+// ===================================================
+//                Dynamic Hash Map
+// ===================================================
+
+// how big the hashmap grows on the first insert.
+#ifndef HASH_MAP_INITAL_CAPACITY
+    #define HASH_MAP_INITAL_CAPACITY 32
+#endif
+
+// with '.incremental_resize', how many slots of the old table every insert and Hash_Map_Remove() moves over.
+//
+// Hash_Map_Get() and friends never move anything, (they dont change the map), and neither dose
+// Hash_Map_Remove_By_Value(), so its still fine inside a Hash_Map_For_Each(). a map that only
+// gets read from after it grows keeps both tables, (and looks in both), until something changes it.
+//
+// the new table is at least the same size, so this many per insert
+// always finishes before the new table wants to grow again.
+#ifndef HASH_MAP_RESIZE_STEP
+    #define HASH_MAP_RESIZE_STEP 64
+#endif
+
+
+// returns a hash of the key,
+// size is the size of the key type.
+typedef u64  (*Hash_Function    )(void *key, u64 size);
+// checks equality between 2 keys. return true if equal.
+//
+// I know hash collisions are pretty unlikely, (if you use a
+// good hash function), but if two key hash's collide, it could
+// create the worst, most un-debuggable bug. you would spend
+// every night in terror.
+typedef bool (*Equality_Function)(void *key_a, void *key_b, u64 size);
+// the same as Hash_Function, but mixes in the maps seed.
+typedef u64  (*Seeded_Hash_Function)(void *key, u64 size, u64 seed);
+
+// how the hash map lays out its memory, set it before the first insert.
+typedef enum {
+    // {hash, key, value} entries, quadratic probing.
+    Hash_Map_Layout_Default = 0,
+
+    // the same entries, plus a byte per slot with 7 bits of the hash (or empty / dead).
+    //
+    // a lookup checks 16 of those bytes at a time, (with SSE2), and only looks
+    // at an entry when the 7 bits match, so a miss usually never touches the entries.
+    // Hash_Map_Clear() is a single memset.
+    Hash_Map_Layout_Control_Bytes,
+
+    // the hashes, keys and values each get their own array, (still one allocation).
+    //
+    // a probe only walks the hashes and keys, the value is only touched
+    // when the key matches, so big values dont get dragged into the cache.
+    Hash_Map_Layout_Split,
+
+    // the default entries, but linear probing where every key is kept in order of
+    // how far it is from where it wants to be, (probe distance, worked out from the hash).
+    //
+    // an insert pushes the 'richer' keys down one, a remove shifts the next ones back,
+    // so there are never any dead slots, and a miss can stop as soon as it passes where
+    // the key would have been. its fine to fill these up to 90%.
+    //
+    // inserting and removing move other entries, so dont hold on to value pointers,
+    // and dont Hash_Map_Remove_By_Value() inside a Hash_Map_For_Each().
+    Hash_Map_Layout_Robin_Hood,
+
+    // like python's dict, the entries are packed together in the order they were put in,
+    // and the probing happens in a separate index table, (1, 2, 4 or 8 bytes a slot,
+    // whatever fits the entry count).
+    //
+    // Hash_Map_For_Each() is a straight walk over the entries, in insertion order,
+    // and there are fewer entries than slots, so its smaller too. a removed entry
+    // stays dead until the next rehash, (growing or Hash_Map_Shrink_To_Fit()).
+    //
+    // '.incremental_resize' is ignored, these always rehash all at once.
+    Hash_Map_Layout_Ordered,
+} Hash_Map_Layout;
+
+// for '.incremental_resize', the old table while its being moved into the new one.
+//
+// every slot in the old table before 'next_slot' has allready been moved,
+// 'entries' is NULL when there is no resize going on.
+typedef struct {
+    void *entries;
+    u64 capacity;
+    u64 next_slot;
+} Hash_Map_Resize_State;
+
+//
+// Example:
+//   - make a variable:
+//     Hash_Map(u32, f32) id_to_percent_map = ZEROED;
+//
+//   - make a type:
+//     typedef Hash_Map(String, Baz) Baz_Hash_Map;
+//
+//   id_to_percent_map.count         = /* number of entries in hash map        */
+//   id_to_percent_map.hash_function = /* hash function to use for the key     */
+//   id_to_percent_map.eq_function   = /* equality function to use for the key */
+//   id_to_percent_map.allocator     = /* a settable arena allocator           */
+//   id_to_percent_map.layout        = /* how the entries are stored, see Hash_Map_Layout */
+//   id_to_percent_map.incremental_resize = /* grow a few slots at a time on every insert and remove, instead of all at once */
+//
+//   id_to_percent_map.seed                 = /* mixed into every hash, set it to Hash_Map_Random_Seed() if the keys come from someone you dont trust */
+//   id_to_percent_map.seeded_hash_function = /* used instead of hash_function, gets the seed */
+//   id_to_percent_map.default_value = /* the default value when you use Hash_Map_Get_Or_Default() and the key is not in the map */
+//
+// ```
+//     Hash_Map(s32, String) hash_map = {
+//         .hash_function = NULL, // the default hash function just takes
+//         .eq_function   = NULL, // the bytes of your type and hash's it.
+//
+//         .default_value = S("NO VALUE"), // a default value
+//     };
+//
+//    Hash_Map(String, s32) reverse_map = {
+//         .hash_function = Hash_Map_Hash_String, // some hash functions are provided for the String types,
+//         .eq_function   = Hash_Map_Eq_String,   // (as well as 'const char *' type, but who cares about that one.)
+//
+//         .default_value = 0, // by default this is allready zero.
+//    };
+// ```
+//
+#define Hash_Map(Key_Type, Value_Type)      \
+    struct {                                \
+        struct {                            \
+            u64        hash;                \
+            Key_Type   key;                 \
+            Value_Type value;               \
+        } *entries;                         \
+                                            \
+        /* total number of alive items in hash_map */   \
+        u64 count;                          \
+        /* total number dead items in hash map */       \
+        u64 dead_count;                     \
+        u64 capacity;                       \
+                                            \
+        Hash_Function     hash_function;    \
+        Equality_Function eq_function;      \
+                                            \
+        u64 seed;                           \
+        Seeded_Hash_Function seeded_hash_function;  \
+                                            \
+        /* Settable allocator */            \
+        Arena *allocator;                   \
+                                            \
+        Hash_Map_Layout layout;             \
+                                            \
+        /* no big rehash, the old table gets moved over a bit at a time */ \
+        bool incremental_resize;            \
+        Hash_Map_Resize_State resizing;     \
+                                            \
+        /* Default value of new items */    \
+        Value_Type default_value;           \
+    }
+
+
+
+typedef struct {
+    u64 hash;
+    u8 key_and_value_data[];
+} Generic_Entry;
+
+typedef struct {
+    void *entries;
+
+    u64 count;
+    u64 dead_count;
+    u64 capacity;
+
+    Hash_Function     hash_function;
+    Equality_Function eq_function;
+
+    u64 seed;
+    Seeded_Hash_Function seeded_hash_function;
+
+    Arena *allocator;
+
+    Hash_Map_Layout layout;
+
+    bool incremental_resize;
+    Hash_Map_Resize_State resizing;
+
+    // dont know how big this thing is. or where it is.
+    u8 default_value_maybe[];
+} Generic_Hash_Map;
+
+
+// These could probably be u32's,
+//
+// but im betting on llvm or whatever to compile this whole
+// thing into something better, also its not gonna cost much to
+// pass this thing as an argument.
+//
+// also every instance of this struct is a constant,
+// optimizers will have fun with that.
+typedef struct {
+    u64 key_size;
+    u64 value_size;
+
+    // used because predicting c struct packing
+    // is not something I want to do right now.
+    u64 entry_size;
+    u64 entry_alignment;
+
+    // key could be Aligned to 128-bit padding,
+    // this is so I dont have to care about that.
+    u64 key_offset_in_entry;
+    u64 value_offset_in_entry;
+
+    u64 default_value_offset_in_hash_map;
+
+} Hash_Map_Key_Value_Type_Properties;
+
+#define Get_Hash_Map_Type_Properties(hash_map)                                              \
+    ((Hash_Map_Key_Value_Type_Properties) {                                                 \
+        .key_size   = sizeof((hash_map)->entries->key),                                     \
+        .value_size = sizeof((hash_map)->entries->value),                                   \
+                                                                                            \
+        .entry_size      = sizeof (*(hash_map)->entries),                                   \
+        .entry_alignment = Alignof(*(hash_map)->entries),                                   \
+                                                                                            \
+        .key_offset_in_entry   = offsetof(Typeof(*(hash_map)->entries), key),               \
+        .value_offset_in_entry = offsetof(Typeof(*(hash_map)->entries), value),             \
+                                                                                            \
+        .default_value_offset_in_hash_map = offsetof(Typeof(*(hash_map)), default_value),   \
+    })
+
+
+// Returns a pointer to the value at with that key,
+//
+// may return null if key dose not exist.
+//
+// this function, (as well as many other hash_map functions),
+// rely on GNU compound statements, to provide the user the
+// ability to hand this function both:
+//     - a variable,
+//     - and a constant value.
+// you might have to turn some warnings off though.
+#define Hash_Map_Get(hash_map, the_key)                                 \
+    ({                                                                  \
+        Typeof((hash_map)->entries->key) key_on_stack = (the_key);      \
+        (Typeof((hash_map)->entries->value)*) Generic_Hash_Map_Get((Generic_Hash_Map*)(hash_map), &key_on_stack, Get_Hash_Map_Type_Properties(hash_map));   \
+    })
+
+// Returns a pointer to the value at with that key,
+//
+// creates a new default value item if the key is not in the map.
+//
+// always returns a valid pointer, will PANIC() otherwise.
+//
+// TODO what if the area the user gave us set "dont panic" mode?
+#define Hash_Map_Get_Or_Default(hash_map, the_key)                      \
+    ({                                                                  \
+        Typeof((hash_map)->entries->key) key_on_stack = (the_key);      \
+        (Typeof((hash_map)->entries->value)*) Generic_Hash_Map_Get_Or_Default((Generic_Hash_Map*)(hash_map), &key_on_stack, Get_Hash_Map_Type_Properties(hash_map), Get_Source_Code_Location());    \
+    })
+
+// the same as Hash_Map_Get_Or_Default() except it dose not set the default value.
+#define Hash_Map_Put(hash_map, the_key)                                 \
+    ({                                                                  \
+        Typeof((hash_map)->entries->key) key_on_stack = (the_key);      \
+        (Typeof((hash_map)->entries->value)*) Generic_Hash_Map_Put((Generic_Hash_Map*)(hash_map), &key_on_stack, Get_Hash_Map_Type_Properties(hash_map), Get_Source_Code_Location());   \
+    })
+
+
+// true if key is in map. returns bool type.
+#define Hash_Map_Contains(hash_map, the_key)                            \
+    ({                                                                  \
+        Typeof((hash_map)->entries->key) key_on_stack = (the_key);      \
+        Generic_Hash_Map_Contains((Generic_Hash_Map*)(hash_map), &key_on_stack, Get_Hash_Map_Type_Properties(hash_map));    \
+    })
+
+
+// look up a whole array of keys at once, 'values_out[i]' is the value for 'keys[i]', (or NULL).
+//
+// the keys get hashed and their slots prefetched a batch at a time, before any of
+// them are looked at, so the cache misses happen all together instead of one after
+// another. a lot faster than Hash_Map_Get() in a loop when the map doesn't fit in cache.
+//
+// ```
+//     u64  ids[256] = { ... };
+//     f32 *percents[256];
+//     Hash_Map_Get_Many(&id_to_percent_map, ids, Array_Len(ids), percents);
+// ```
+#define Hash_Map_Get_Many(hash_map, keys, count, values_out)                                \
+    ({                                                                                      \
+        Typeof((hash_map)->entries->key)    *keys_ptr   = (keys);                           \
+        Typeof((hash_map)->entries->value) **values_ptr = (values_out);                     \
+        Generic_Hash_Map_Get_Many((Generic_Hash_Map*)(hash_map), keys_ptr, (count), (void**)values_ptr, Get_Hash_Map_Type_Properties(hash_map));  \
+    })
+
+// the same as Hash_Map_Get_Many(), but 'results_out' is an array of bool.
+#define Hash_Map_Contains_Many(hash_map, keys, count, results_out)                          \
+    ({                                                                                      \
+        Typeof((hash_map)->entries->key) *keys_ptr = (keys);                                \
+        Generic_Hash_Map_Contains_Many((Generic_Hash_Map*)(hash_map), keys_ptr, (count), (results_out), Get_Hash_Map_Type_Properties(hash_map));  \
+    })
+
+
+// remove a key and value from hash map,
+//
+// returns weather or not the key was in the hash map.
+#define Hash_Map_Remove(hash_map, the_key)                              \
+    ({                                                                  \
+        Typeof((hash_map)->entries->key) key_on_stack = (the_key);      \
+        Generic_Hash_Map_Remove((Generic_Hash_Map*)(hash_map), &key_on_stack, Get_Hash_Map_Type_Properties(hash_map));  \
+    })
+
+// remove an entry by pointer to the value,
+//
+// will ASSERT() that the value pointer is valid
+// (is one of this hash maps entries)
+//
+// returns true if it was successful.
+#define Hash_Map_Remove_By_Value(hash_map, value_ptr)                   \
+    Generic_Hash_Map_Remove_By_Value((Generic_Hash_Map*)(hash_map), value_ptr, Get_Hash_Map_Type_Properties(hash_map))
+
+
+// reserve space for num_to_reserver *TOTAL* items,
+//
+// may PANIC() if your computer runs out of memory.
+#define Hash_Map_Reserve(hash_map, num_to_reserve)                      \
+    Generic_Hash_Map_Reserve((Generic_Hash_Map*)(hash_map), (num_to_reserve), Get_Hash_Map_Type_Properties(hash_map), Get_Source_Code_Location())
+
+// make the map as small as it can be for the items in it,
+// (and get rid of any dead slots), frees everything if its empty.
+//
+// if you set an allocator, the old memory just stays in the arena.
+#define Hash_Map_Shrink_To_Fit(hash_map)                                \
+    Generic_Hash_Map_Shrink_To_Fit((Generic_Hash_Map*)(hash_map), Get_Hash_Map_Type_Properties(hash_map), Get_Source_Code_Location())
+
+// clear the hash map, keep the memory.
+#define Hash_Map_Clear(hash_map)    Generic_Hash_Map_Clear((Generic_Hash_Map*)(hash_map), Get_Hash_Map_Type_Properties(hash_map))
+// free the memory used, only use if you haven't set an allocator.
+//
+// only free()'s the entries pointer,
+// you have to manage the other memory yourself.
+#define Hash_Map_Free(hash_map)     Generic_Hash_Map_Free((Generic_Hash_Map*)(hash_map))
+
+
+// return a pointer to the key for the value, please dont modify this.
+//
+// i could of just dereferenced this key, but
+// it would be pretty easy to get around it.
+// if what you were storing was an array or something.
+#define Hash_Map_Key_For(hash_map, value_ptr)       \
+    ((Typeof((hash_map)->entries->key)*) Generic_Hash_Map_Key_For((Generic_Hash_Map*)(hash_map), (value_ptr), Get_Hash_Map_Type_Properties(hash_map)))
+
+
+// allows you to loop over all values in the hash table.
+//
+// ```
+// Hash_Map(s32, u32) hash_map = ZEROED;
+//
+// *Hash_Map_Get_Or_Default(&hash_map, 52) = 6;
+// *Hash_Map_Get_Or_Default(&hash_map, 12) = 8;
+//
+// Hash_Map_For_Each(value, &hash_map) {
+//     s32 *key = Hash_Map_Key_For(&hash_map, value);
+//
+//     printf("%d => %u", *key, *value);
+//
+//     // you can also modify the value here.
+//     *value += 1;
+// }
+// ```
+#define Hash_Map_For_Each(value_it, hash_map)                       \
+    for (                                                           \
+        Typeof((hash_map)->entries->value) *value_it = NULL;        \
+        Generic_Hash_Map_For_Each_Iterator_Next((Generic_Hash_Map*)(hash_map), (void**)&value_it, Get_Hash_Map_Type_Properties(hash_map));     \
+    )
+
+
+
+// this is the default for a hash table, if no hash function is set.
+//
+// hash's the data for the key.
+//
+// uses Hash_Function_wyhash(), with special cases for 4 and 8 byte keys.
+u64  Hash_Map_Default_Hash_Function    (void *key, u64 size);
+u64  Hash_Map_Default_Seeded_Hash_Function(void *key, u64 size, u64 seed);
+bool Hash_Map_Default_Equality_Function(void *key_a, void *key_b, u64 size);
+
+
+// use these if your key type is String,
+// hash entire string with Hash_Map_Default_Hash_Function()
+u64  Hash_Map_Hash_String(void *key, u64 size);
+u64  Hash_Map_Seeded_Hash_String(void *key, u64 size, u64 seed);
+bool Hash_Map_Eq_String  (void *key_a, void *key_b, u64 size);
+
+// use this if your key type is a c String,
+// hash's the string while finding its length, see Hash_C_String().
+u64  Hash_Map_Hash_C_String(void *key, u64 size);
+u64  Hash_Map_Seeded_Hash_C_String(void *key, u64 size, u64 seed);
+bool Hash_Map_Eq_C_String  (void *key_a, void *key_b, u64 size);
+
+// a seed from the OS, (getrandom() on linux), so nobody can guess what keys collide.
+u64 Hash_Map_Random_Seed(void);
+
+
+// a wyhash style hash, reads 8 or 16 bytes at a time,
+// and mixes with a 64 x 64 -> 128 bit multiply.
+//
+// way faster than fnv1a for anything longer than a few bytes.
+u64 Hash_Function_wyhash(void *key, u64 size, u64 seed);
+
+// the old default, one byte at a time. still here if you want it.
+u64 Hash_Function_fnv1a(void *key, u64 size);
+
+// hash's a c string and finds its length at the same time,
+// (8 bytes at a time), instead of walking it once for strlen() and again to hash it.
+//
+// length_out can be NULL. dose not give the same hash as Hash_Function_wyhash() on the same bytes.
+u64 Hash_C_String(const char *c_str, u64 seed, u64 *length_out);
+
+
+// the wyhash constants.
+#define HASH_SECRET_0   0x2d358dccaa6c78a5ULL
+#define HASH_SECRET_1   0x8bb84b93962eacc9ULL
+#define HASH_SECRET_2   0x4b33a62ed433d4a3ULL
+#define HASH_SECRET_3   0x4d5a2da51de1aa47ULL
+
+// these live in the header so they can inline, they get used by a lot of things.
+
+// multiply to 128 bits, and fold the halves together.
+internal inline u64 Hash_Mix(u64 a, u64 b) {
+    __uint128_t result = (__uint128_t)a * b;
+    return (u64)result ^ (u64)(result >> 64);
+}
+
+// the fast path for integer keys.
+internal inline u64 Hash_u64(u64 value, u64 seed) {
+    __uint128_t result = (__uint128_t)(value ^ HASH_SECRET_0) * (seed ^ HASH_SECRET_1);
+    return Hash_Mix((u64)result ^ HASH_SECRET_0, (u64)(result >> 64) ^ HASH_SECRET_1);
+}
+#define Hash_u32(value, seed)   Hash_u64((u32)(value), (seed))
+// the same as Hash_Map_Seeded_Hash_String(), but takes the String.
+#define Hash_String(string, seed) Hash_Function_wyhash((string).data, (string).length, (seed))
+
+
+// Hash map helper functions / macros.
+//
+// these are up here so the Hash_Map_Define() functions can use them.
+
+#define Hash_Map_UNALLOCATED    (0)
+#define Hash_Map_DEAD           (1)
+
+#define HASH_MAP_HASH_FROM_ENTRY(entry) (((Generic_Entry*)entry)->hash)
+
+// for Hash_Map_Layout_Split, where the keys and values start in the table.
+//
+// the hashes are first, 'alignment' is the alignment of the whole entry, (so its at least 8).
+#define Hash_Map_Internal_Align_Up(size, alignment)     (((size) + (alignment) - 1) & ~((u64)(alignment) - 1))
+#define Hash_Map_Split_Keys_Offset(capacity, alignment)                 \
+    Hash_Map_Internal_Align_Up((capacity) * sizeof(u64), (alignment))
+#define Hash_Map_Split_Values_Offset(capacity, key_size, alignment)     \
+    (Hash_Map_Split_Keys_Offset((capacity), (alignment)) + Hash_Map_Internal_Align_Up((capacity) * (key_size), (alignment)))
+
+// bad hash's get swapped for this, (its just the FNV 64-bit offset)
+#define HASH_MAP_BAD_HASH_REPLACEMENT   14695981039346656037ULL
+
+// what the find functions return when there is no slot.
+#define HASH_MAP_NO_SLOT        (~0ULL)
+
+// why use a macro when you can just not?
+internal inline bool Hash_Map_Hash_Is_Bad(u64 hash) {
+    return (hash == Hash_Map_UNALLOCATED) || (hash == Hash_Map_DEAD);
+}
+
+
+// for Hash_Map_Layout_Control_Bytes, every slot gets one of these.
+//
+// empty and dead slots have the top bit set, full slots hold 7 bits
+// of the hash, so most of the time we never look at the entry.
+#define HASH_MAP_CONTROL_EMPTY          ((u8)0x80)
+#define HASH_MAP_CONTROL_DEAD           ((u8)0xFE)
+#define HASH_MAP_CONTROL_FROM_HASH(hash) ((u8)((hash) & 0x7F))
+
+// the control bytes get looked at this many at a time.
+#define HASH_MAP_GROUP_SIZE             16
+
+// returns a mask with a bit set for every byte in the group that is equal to 'control'
+//
+// 'available' has a bit set for every empty or dead slot.
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+
+    internal inline u32 Hash_Map_Group_Match(u8 *group, u8 control) {
+        __m128i bytes = _mm_load_si128((__m128i*)group);
+        return (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8((char)control)));
+    }
+    internal inline u32 Hash_Map_Group_Match_Available(u8 *group) {
+        // the top bit is all we need, and thats exactly what movemask grabs.
+        return (u32) _mm_movemask_epi8(_mm_load_si128((__m128i*)group));
+    }
+#else
+    internal inline u32 Hash_Map_Group_Match(u8 *group, u8 control) {
+        u32 result = 0;
+        for (u32 i = 0; i < HASH_MAP_GROUP_SIZE; i++) result |= (u32)(group[i] == control) << i;
+        return result;
+    }
+    internal inline u32 Hash_Map_Group_Match_Available(u8 *group) {
+        u32 result = 0;
+        for (u32 i = 0; i < HASH_MAP_GROUP_SIZE; i++) result |= (u32)(group[i] >> 7) << i;
+        return result;
+    }
+#endif
+
+
+// only grow array when at nearing capacity, not at capacity.
+#define HASH_MAP_GROWTH_PERCENT     75
+// robin hood probes stay short for a lot longer.
+#define HASH_MAP_ROBIN_HOOD_GROWTH_PERCENT  90
+
+// how many slots can be used before the map has to grow.
+internal inline u64 Hash_Map_Max_Load(Hash_Map_Layout layout, u64 capacity) {
+    u64 percent = (layout == Hash_Map_Layout_Robin_Hood) ? HASH_MAP_ROBIN_HOOD_GROWTH_PERCENT : HASH_MAP_GROWTH_PERCENT;
+    return capacity * percent / 100;
+}
+
+// for Hash_Map_Layout_Ordered, how many bytes each slot in the index table is.
+//
+// the index table holds the entry index + 1, so zero is empty, and all ones is dead.
+internal inline u64 Hash_Map_Ordered_Index_Width(u64 capacity) {
+    u64 entry_count = Hash_Map_Max_Load(Hash_Map_Layout_Ordered, capacity);
+    if (entry_count < UINT8_MAX)  return 1;
+    if (entry_count < UINT16_MAX) return 2;
+    if (entry_count < UINT32_MAX) return 4;
+    return 8;
+}
+
+// for Hash_Map_Layout_Robin_Hood, how far a slot is from where its hash wants it.
+#define Hash_Map_Probe_Distance(hash, slot, mask)   (((slot) - ((hash) & (mask))) & (mask))
+
+// true while an '.incremental_resize' map still has an old table.
+#define Hash_Map_Is_Resizing(hash_map)              ((hash_map)->resizing.entries != NULL)
+
+// Hash_Map_Define() hands these off to the generic functions, (the ordered layout probes a different table).
+#define Hash_Map_Define_Uses_Generic(hash_map)      (Hash_Map_Is_Resizing(hash_map) || (hash_map)->layout == Hash_Map_Layout_Ordered)
+
+
+// The generic functions that power the hash map interface.
+
+void *Generic_Hash_Map_Get                  (Generic_Hash_Map *hash_map, void *key,            Hash_Map_Key_Value_Type_Properties properties);
+void *Generic_Hash_Map_Get_Or_Default       (Generic_Hash_Map *hash_map, void *key,            Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location);
+void *Generic_Hash_Map_Put                  (Generic_Hash_Map *hash_map, void *key,            Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location);
+
+bool Generic_Hash_Map_Contains              (Generic_Hash_Map *hash_map, void *key,            Hash_Map_Key_Value_Type_Properties properties);
+void Generic_Hash_Map_Get_Many              (Generic_Hash_Map *hash_map, void *keys, u64 count, void **values_out, Hash_Map_Key_Value_Type_Properties properties);
+void Generic_Hash_Map_Contains_Many         (Generic_Hash_Map *hash_map, void *keys, u64 count, bool *results_out, Hash_Map_Key_Value_Type_Properties properties);
+
+void Generic_Hash_Map_Clear                 (Generic_Hash_Map *hash_map,                       Hash_Map_Key_Value_Type_Properties properties);
+void Generic_Hash_Map_Free                  (Generic_Hash_Map *hash_map);
+void Generic_Hash_Map_Reserve               (Generic_Hash_Map *hash_map, u64 num_to_reserve,   Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location);
+void Generic_Hash_Map_Shrink_To_Fit         (Generic_Hash_Map *hash_map,                       Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location);
+// grows the map, (or clears out the dead slots), if one more thing wont fit.
+void Generic_Hash_Map_Make_Room_For_One     (Generic_Hash_Map *hash_map,                       Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location);
+
+bool Generic_Hash_Map_Remove                (Generic_Hash_Map *hash_map, void *key,            Hash_Map_Key_Value_Type_Properties properties);
+bool Generic_Hash_Map_Remove_By_Value       (Generic_Hash_Map *hash_map, void *value_ptr,      Hash_Map_Key_Value_Type_Properties properties);
+
+void *Generic_Hash_Map_Key_For              (Generic_Hash_Map *hash_map, void *value_ptr,      Hash_Map_Key_Value_Type_Properties properties);
+bool Generic_Hash_Map_For_Each_Iterator_Next(Generic_Hash_Map *hash_map, void **current_value, Hash_Map_Key_Value_Type_Properties properties);
+
+
+
+//
+// Hash_Map_Stats()
+//
+// how well the keys are spread out, to catch a bad hash function before it
+// becomes a slow map. a 'probe' is a slot the lookup had to look at, (for
+// Hash_Map_Layout_Control_Bytes its a group of HASH_MAP_GROUP_SIZE slots).
+//
+// ```
+//     Hash_Map_Stats stats = Hash_Map_Stats(&map);
+//     if (stats.max_probe_length > 32) { ... }
+//     Hash_Map_Print_Stats(&stats);
+// ```
+//
+// it walks the whole table, (and re-probes every key), so dont put it in a hot loop.
+// while a map is in an incremental resize, only the new table is looked at.
+//
+#ifndef HASH_MAP_STATS_HISTOGRAM_SIZE
+    #define HASH_MAP_STATS_HISTOGRAM_SIZE   16
+#endif
+
+typedef struct {
+    u64 count;
+    u64 dead_count;
+    u64 capacity;
+
+    // count / capacity, and dead_count / capacity.
+    f64 load_factor;
+    f64 dead_ratio;
+
+    // how many probes it takes to find each key thats in there.
+    f64 mean_probe_length;
+    u64 max_probe_length;
+    // [i] is how many keys took i + 1 probes, the last one is everything longer.
+    u64 probe_length_histogram[HASH_MAP_STATS_HISTOGRAM_SIZE + 1];
+
+    // runs of slots next to each other that aren't empty, (dead ones count).
+    u64 cluster_count;
+    u64 max_cluster_size;
+    f64 mean_cluster_size;
+} Hash_Map_Stats;
+
+#define Hash_Map_Stats(hash_map)        Generic_Hash_Map_Stats((Generic_Hash_Map*)(hash_map), Get_Hash_Map_Type_Properties(hash_map))
+
+Hash_Map_Stats Generic_Hash_Map_Stats(Generic_Hash_Map *hash_map, Hash_Map_Key_Value_Type_Properties properties);
+void           Hash_Map_Print_Stats  (Hash_Map_Stats *stats);
+
+
+//
+// HASH_MAP_COUNT_PROBES
+//
+// #define this before including Bested.h, and every Get / Put / Contains / Remove,
+// (generic or Hash_Map_Define()), counts how many probes it took. the counts
+// are per thread, and cover every map, so reset them before the part you care about.
+//
+// ```
+//     Hash_Map_Reset_Probe_Counts();
+//     for (...) Hash_Map_Get(&map, key);
+//     Hash_Map_Probe_Counts counts = Hash_Map_Get_Probe_Counts();
+//     printf("%f probes a lookup\n", (f64)counts.probes / counts.lookups);
+// ```
+//
+#ifdef HASH_MAP_COUNT_PROBES
+    typedef struct {
+        u64 lookups;
+        u64 probes;
+        // the longest single lookup.
+        u64 max_probes;
+        // the one thats going on right now.
+        u64 this_lookup;
+    } Hash_Map_Probe_Counts;
+
+    extern _Thread_local Hash_Map_Probe_Counts hash_map_probe_counts;
+
+    internal inline void Hash_Map_Count_Lookup(void) {
+        hash_map_probe_counts.max_probes   = Max(hash_map_probe_counts.max_probes, hash_map_probe_counts.this_lookup);
+        hash_map_probe_counts.this_lookup  = 0;
+        hash_map_probe_counts.lookups     += 1;
+    }
+    #define Hash_Map_Count_Probe()      (hash_map_probe_counts.probes += 1, hash_map_probe_counts.this_lookup += 1)
+
+    Hash_Map_Probe_Counts Hash_Map_Get_Probe_Counts  (void);
+    void                  Hash_Map_Reset_Probe_Counts(void);
+#else
+    #define Hash_Map_Count_Lookup()     ((void)0)
+    #define Hash_Map_Count_Probe()      ((void)0)
+#endif
+
+
+
+//
+// Hash_Map_Define(Name, Key_Type, Value_Type, HASH, EQ)
+//
+// Makes a Hash_Map type with its own functions, the hash and equality get
+// inlined, keys are compared directly, (not through a function pointer and
+// a Mem_Eq()), and nothing has to be looked up in a properties struct.
+//
+// HASH(key, seed) returns a u64, EQ(a, b) returns true if the keys are the same.
+//
+// ```
+//     Hash_Map_Define(Id_Map,     u64,    f32, Hash_u64,    Hash_Map_Eq_Direct)
+//     Hash_Map_Define(Name_Map,   String, s32, Hash_String, String_Eq)
+//
+//     Id_Map ids = ZEROED;                   // its just a Hash_Map(u64, f32)
+//     *Id_Map_Put(&ids, 12) = 0.5;
+//
+//     f32 *percent = Id_Map_Get(&ids, 12);   // NULL if its not there
+//     *Id_Map_Get_Or_Default(&ids, 13) += 1;
+//     Id_Map_Contains(&ids, 12);
+//     Id_Map_Remove(&ids, 12);
+//
+//     // everything else is the normal Hash_Map_* stuff.
+//     Hash_Map_For_Each(value, &ids) { ... }
+//     Hash_Map_Free(&ids);
+// ```
+//
+// the normal Hash_Map_Get() and friends still work on these maps, as long as they
+// come up with the same hash. Hash_u64(), Hash_u32() and Hash_String() give the
+// same answer as the default hash function and Hash_Map_Seeded_Hash_String().
+//
+// every layout works, set '.layout' like normal. with '.incremental_resize' set,
+// these just call the generic functions while there is still an old table around.
+//
+#define Hash_Map_Define(Name, Key_Type, Value_Type, HASH, EQ)                                               \
+    typedef Hash_Map(Key_Type, Value_Type) Name;                                                            \
+                                                                                                            \
+    generated_function u64 Name##_Hash(Name *hash_map, Key_Type key) {                                      \
+        u64 hash = HASH(key, hash_map->seed);                                                               \
+        return Hash_Map_Hash_Is_Bad(hash) ? HASH_MAP_BAD_HASH_REPLACEMENT : hash;                           \
+    }                                                                                                       \
+                                                                                                            \
+    /* where the hash, key and value for a slot live, for every layout. */                                  \
+    generated_function u64 *Name##_Hash_At(Name *hash_map, u64 slot) {                                      \
+        if (hash_map->layout == Hash_Map_Layout_Split) return (u64*)hash_map->entries + slot;               \
+        return &hash_map->entries[slot].hash;                                                               \
+    }                                                                                                       \
+    generated_function Key_Type *Name##_Key_At(Name *hash_map, u64 slot) {                                  \
+        if (hash_map->layout == Hash_Map_Layout_Split) {                                                    \
+            return (Key_Type*)((u8*)hash_map->entries + Hash_Map_Split_Keys_Offset(hash_map->capacity, Alignof(*hash_map->entries))) + slot; \
+        }                                                                                                   \
+        return &hash_map->entries[slot].key;                                                                \
+    }                                                                                                       \
+    generated_function Value_Type *Name##_Value_At(Name *hash_map, u64 slot) {                              \
+        if (hash_map->layout == Hash_Map_Layout_Split) {                                                    \
+            return (Value_Type*)((u8*)hash_map->entries + Hash_Map_Split_Values_Offset(hash_map->capacity, sizeof(Key_Type), Alignof(*hash_map->entries))) + slot; \
+        }                                                                                                   \
+        return &hash_map->entries[slot].value;                                                              \
+    }                                                                                                       \
+                                                                                                            \
+    /* the same probing as the generic functions, (it has to be, they share the table). */                  \
+    generated_function u64 Name##_Find_Slot(Name *hash_map, Key_Type key, u64 hash, u64 *insert_slot) {     \
+        if (insert_slot) *insert_slot = HASH_MAP_NO_SLOT;                                                   \
+        Hash_Map_Count_Lookup();                                                                            \
+        if (hash_map->capacity == 0) return HASH_MAP_NO_SLOT;                                               \
+        u64 mask = hash_map->capacity - 1;                                                                  \
+                                                                                                            \
+        if (hash_map->layout == Hash_Map_Layout_Control_Bytes) {                                            \
+            u8 *control_bytes = Hash_Map_Internal_Control_Bytes(hash_map);                                  \
+            u8  control       = HASH_MAP_CONTROL_FROM_HASH(hash);                                           \
+            u64 group_mask    = mask / HASH_MAP_GROUP_SIZE;                                                 \
+            u64 group_index   = (hash >> 7) & group_mask;                                                   \
+                                                                                                            \
+            for (u64 step = 1; ; step++) {                                                                  \
+                u8 *group = control_bytes + group_index * HASH_MAP_GROUP_SIZE;                              \
+                Hash_Map_Count_Probe();                                                                     \
+                for (u32 matches = Hash_Map_Group_Match(group, control); matches; matches &= matches - 1) { \
+                    u64 slot = group_index * HASH_MAP_GROUP_SIZE + __builtin_ctz(matches);                  \
+                    if (hash_map->entries[slot].hash == hash && (EQ(hash_map->entries[slot].key, key))) return slot; \
+                }                                                                                           \
+                u32 available = Hash_Map_Group_Match_Available(group);                                      \
+                if (insert_slot && *insert_slot == HASH_MAP_NO_SLOT && available) {                         \
+                    *insert_slot = group_index * HASH_MAP_GROUP_SIZE + __builtin_ctz(available);            \
+                }                                                                                           \
+                if (Hash_Map_Group_Match(group, HASH_MAP_CONTROL_EMPTY)) return HASH_MAP_NO_SLOT;           \
+                                                                                                            \
+                ASSERT(step <= group_mask + 1);                                                             \
+                group_index = (group_index + step) & group_mask;                                            \
+            }                                                                                               \
+        }                                                                                                   \
+                                                                                                            \
+        if (hash_map->layout == Hash_Map_Layout_Robin_Hood) {                                               \
+            u64 slot = hash & mask;                                                                         \
+            for (u64 distance = 0; ; distance++) {                                                          \
+                u64 slot_hash = hash_map->entries[slot].hash;                                               \
+                Hash_Map_Count_Probe();                                                                     \
+                if (slot_hash == Hash_Map_UNALLOCATED || Hash_Map_Probe_Distance(slot_hash, slot, mask) < distance) { \
+                    if (insert_slot) *insert_slot = slot;                                                   \
+                    return HASH_MAP_NO_SLOT;                                                                \
+                }                                                                                           \
+                if (slot_hash == hash && (EQ(hash_map->entries[slot].key, key))) return slot;               \
+                slot = (slot + 1) & mask;                                                                   \
+            }                                                                                               \
+        }                                                                                                   \
+                                                                                                            \
+        /* default and split only differ in how far apart the hashes and keys are. */                       \
+        u8 *hashes = (u8*)Name##_Hash_At(hash_map, 0);                                                      \
+        u8 *keys   = (u8*)Name##_Key_At (hash_map, 0);                                                      \
+        u64 hash_stride = (hash_map->layout == Hash_Map_Layout_Split) ? sizeof(u64)      : sizeof(*hash_map->entries); \
+        u64 key_stride  = (hash_map->layout == Hash_Map_Layout_Split) ? sizeof(Key_Type) : sizeof(*hash_map->entries); \
+                                                                                                            \
+        u64 slot            = hash & mask;                                                                  \
+        u64 first_dead_slot = HASH_MAP_NO_SLOT;                                                             \
+        for (u64 increment = 1; ; increment++) {                                                            \
+            u64 slot_hash = *(u64*)(hashes + slot * hash_stride);                                           \
+            Hash_Map_Count_Probe();                                                                         \
+            if (slot_hash == Hash_Map_UNALLOCATED) break;                                                   \
+            if (slot_hash == hash && (EQ(*(Key_Type*)(keys + slot * key_stride), key))) return slot;        \
+            if (slot_hash == Hash_Map_DEAD && first_dead_slot == HASH_MAP_NO_SLOT) first_dead_slot = slot;  \
+                                                                                                            \
+            ASSERT(increment < 4096);                                                                       \
+            slot = (slot + increment) & mask;                                                               \
+        }                                                                                                   \
+        if (insert_slot) *insert_slot = (first_dead_slot != HASH_MAP_NO_SLOT) ? first_dead_slot : slot;     \
+        return HASH_MAP_NO_SLOT;                                                                            \
+    }                                                                                                       \
+                                                                                                            \
+    generated_function Value_Type *Name##_Get(Name *hash_map, Key_Type key) {                               \
+        if (Hash_Map_Define_Uses_Generic(hash_map)) return Hash_Map_Get(hash_map, key);                     \
+        u64 slot = Name##_Find_Slot(hash_map, key, Name##_Hash(hash_map, key), NULL);                       \
+        return (slot == HASH_MAP_NO_SLOT) ? NULL : Name##_Value_At(hash_map, slot);                         \
+    }                                                                                                       \
+                                                                                                            \
+    generated_function bool Name##_Contains(Name *hash_map, Key_Type key) {                                 \
+        if (Hash_Map_Define_Uses_Generic(hash_map)) return Hash_Map_Contains(hash_map, key);                \
+        return Name##_Find_Slot(hash_map, key, Name##_Hash(hash_map, key), NULL) != HASH_MAP_NO_SLOT;       \
+    }                                                                                                       \
+                                                                                                            \
+    generated_function Value_Type *Name##_Internal_Put(Name *hash_map, Key_Type key, bool set_default) {    \
+        u64 hash = Name##_Hash(hash_map, key);                                                              \
+                                                                                                            \
+        u64 used = hash_map->dead_count + hash_map->count + 1;                                              \
+        if (used >= Hash_Map_Max_Load(hash_map->layout, hash_map->capacity)) {                              \
+            Generic_Hash_Map_Make_Room_For_One((Generic_Hash_Map*)hash_map, Get_Hash_Map_Type_Properties(hash_map), Get_Source_Code_Location()); \
+        }                                                                                                   \
+        /* the generic functions know about the old table, let them deal with it. */                        \
+        if (Hash_Map_Define_Uses_Generic(hash_map)) {                                                       \
+            return set_default ? Hash_Map_Get_Or_Default(hash_map, key) : Hash_Map_Put(hash_map, key);      \
+        }                                                                                                   \
+                                                                                                            \
+        u64 insert_slot;                                                                                    \
+        u64 slot = Name##_Find_Slot(hash_map, key, hash, &insert_slot);                                     \
+        if (slot != HASH_MAP_NO_SLOT) return Name##_Value_At(hash_map, slot);                               \
+                                                                                                            \
+        slot = insert_slot;                                                                                 \
+        ASSERT(slot != HASH_MAP_NO_SLOT);                                                                   \
+        if (hash_map->layout == Hash_Map_Layout_Control_Bytes) {                                            \
+            u8 *control = &Hash_Map_Internal_Control_Bytes(hash_map)[slot];                                 \
+            if (*control == HASH_MAP_CONTROL_DEAD) hash_map->dead_count -= 1;                               \
+            *control = HASH_MAP_CONTROL_FROM_HASH(hash);                                                    \
+        } else if (hash_map->layout == Hash_Map_Layout_Robin_Hood) {                                        \
+            /* move everyone from here to the next empty slot down one. */                                  \
+            u64 mask  = hash_map->capacity - 1;                                                             \
+            u64 empty = slot;                                                                               \
+            while (hash_map->entries[empty].hash != Hash_Map_UNALLOCATED) empty = (empty + 1) & mask;       \
+            for (u64 to = empty; to != slot; to = (to - 1) & mask) hash_map->entries[to] = hash_map->entries[(to - 1) & mask]; \
+        } else {                                                                                            \
+            if (*Name##_Hash_At(hash_map, slot) == Hash_Map_DEAD) hash_map->dead_count -= 1;                \
+        }                                                                                                   \
+        *Name##_Hash_At(hash_map, slot) = hash;                                                             \
+        *Name##_Key_At (hash_map, slot) = key;                                                              \
+        Value_Type *value = Name##_Value_At(hash_map, slot);                                                \
+        if (set_default) *value = hash_map->default_value;                                                  \
+        hash_map->count += 1;                                                                               \
+                                                                                                            \
+        return value;                                                                                       \
+    }                                                                                                       \
+                                                                                                            \
+    /* the same as Hash_Map_Put(), the value is whatever was there before. */                               \
+    generated_function Value_Type *Name##_Put(Name *hash_map, Key_Type key) {                               \
+        return Name##_Internal_Put(hash_map, key, false);                                                   \
+    }                                                                                                       \
+                                                                                                            \
+    generated_function Value_Type *Name##_Get_Or_Default(Name *hash_map, Key_Type key) {                    \
+        return Name##_Internal_Put(hash_map, key, true);                                                    \
+    }                                                                                                       \
+                                                                                                            \
+    generated_function bool Name##_Remove(Name *hash_map, Key_Type key) {                                   \
+        if (Hash_Map_Define_Uses_Generic(hash_map)) return Hash_Map_Remove(hash_map, key);                  \
+        u64 slot = Name##_Find_Slot(hash_map, key, Name##_Hash(hash_map, key), NULL);                       \
+        if (slot == HASH_MAP_NO_SLOT) return false;                                                         \
+        return Generic_Hash_Map_Remove_By_Value((Generic_Hash_Map*)hash_map, Name##_Value_At(hash_map, slot), Get_Hash_Map_Type_Properties(hash_map)); \
+    }
+
+
+// for Hash_Map_Define(), when the keys can just be compared with ==
+#define Hash_Map_Eq_Direct(a, b)        ((a) == (b))
+
+// the control bytes, without a call to Mem_Align_Forward().
+#define Hash_Map_Internal_Control_Bytes(hash_map)                                                           \
+    ((u8*)(hash_map)->entries + (((hash_map)->capacity * sizeof(*(hash_map)->entries) + HASH_MAP_GROUP_SIZE - 1) & ~(u64)(HASH_MAP_GROUP_SIZE - 1)))
+
+
+
+// ===================================================
+//                    Hash Set
+// ===================================================
+
+//
+// A Hash_Map with no values, just the keys.
+//
+// its the same generic code underneath, (the value size is zero), so every
+// Hash_Map_Layout, '.seed', '.allocator' and '.incremental_resize' work the same way,
+// an entry is just {hash, key}, not {hash, key, some u8 you dont care about + padding}.
+//
+// ```
+//     Hash_Set(u64) seen = ZEROED;
+//
+//     Hash_Set_Add(&seen, 12);        // true if it wasn't there allready
+//     Hash_Set_Contains(&seen, 12);
+//     Hash_Set_Remove(&seen, 12);
+//
+//     Hash_Set_For_Each(key, &seen) {
+//         printf("%zu\n", *key);      // dont change the key.
+//     }
+//
+//     // these change the first set.
+//     Hash_Set_Union       (&seen, &other);   // everything in either
+//     Hash_Set_Intersection(&seen, &other);   // only whats in both
+//     Hash_Set_Difference  (&seen, &other);   // only whats not in other
+//
+//     Hash_Set_Free(&seen);
+// ```
+//
+// the other set can hash differently, (different seed or functions), but the key types have to match.
+//
+#define Hash_Set(Key_Type)                  \
+    struct {                                \
+        struct {                            \
+            u64      hash;                  \
+            Key_Type key;                   \
+        } *entries;                         \
+                                            \
+        u64 count;                          \
+        u64 dead_count;                     \
+        u64 capacity;                       \
+                                            \
+        Hash_Function     hash_function;    \
+        Equality_Function eq_function;      \
+                                            \
+        u64 seed;                           \
+        Seeded_Hash_Function seeded_hash_function;  \
+                                            \
+        Arena *allocator;                   \
+                                            \
+        Hash_Map_Layout layout;             \
+                                            \
+        bool incremental_resize;            \
+        Hash_Map_Resize_State resizing;     \
+    }
+
+// a set is a map where the value is the key, with no size.
+#define Get_Hash_Set_Type_Properties(hash_set)                                              \
+    ((Hash_Map_Key_Value_Type_Properties) {                                                 \
+        .key_size   = sizeof((hash_set)->entries->key),                                     \
+        .value_size = 0,                                                                    \
+                                                                                            \
+        .entry_size      = sizeof (*(hash_set)->entries),                                   \
+        .entry_alignment = Alignof(*(hash_set)->entries),                                   \
+                                                                                            \
+        .key_offset_in_entry   = offsetof(Typeof(*(hash_set)->entries), key),               \
+        .value_offset_in_entry = offsetof(Typeof(*(hash_set)->entries), key),               \
+                                                                                            \
+        .default_value_offset_in_hash_map = 0,                                              \
+    })
+
+#define Hash_Set_Key_Type(hash_set)     Typeof((hash_set)->entries->key)
+
+// returns true if the key is new.
+#define Hash_Set_Add(hash_set, the_key)                                 \
+    ({                                                                  \
+        Hash_Set_Key_Type(hash_set) key_on_stack = (the_key);           \
+        Generic_Hash_Set_Add((Generic_Hash_Map*)(hash_set), &key_on_stack, Get_Hash_Set_Type_Properties(hash_set), Get_Source_Code_Location());  \
+    })
+
+#define Hash_Set_Contains(hash_set, the_key)                            \
+    ({                                                                  \
+        Hash_Set_Key_Type(hash_set) key_on_stack = (the_key);           \
+        Generic_Hash_Map_Contains((Generic_Hash_Map*)(hash_set), &key_on_stack, Get_Hash_Set_Type_Properties(hash_set));  \
+    })
+
+// returns true if it was there.
+#define Hash_Set_Remove(hash_set, the_key)                              \
+    ({                                                                  \
+        Hash_Set_Key_Type(hash_set) key_on_stack = (the_key);           \
+        Generic_Hash_Map_Remove((Generic_Hash_Map*)(hash_set), &key_on_stack, Get_Hash_Set_Type_Properties(hash_set));    \
+    })
+
+// see Hash_Map_Get_Many(), 'results_out' is an array of bool.
+#define Hash_Set_Contains_Many(hash_set, keys, count, results_out)                          \
+    ({                                                                                      \
+        Hash_Set_Key_Type(hash_set) *keys_ptr = (keys);                                     \
+        Generic_Hash_Map_Contains_Many((Generic_Hash_Map*)(hash_set), keys_ptr, (count), (results_out), Get_Hash_Set_Type_Properties(hash_set));  \
+    })
+
+#define Hash_Set_Reserve(hash_set, num_to_reserve)                      \
+    Generic_Hash_Map_Reserve((Generic_Hash_Map*)(hash_set), (num_to_reserve), Get_Hash_Set_Type_Properties(hash_set), Get_Source_Code_Location())
+#define Hash_Set_Clear(hash_set)    Generic_Hash_Map_Clear((Generic_Hash_Map*)(hash_set), Get_Hash_Set_Type_Properties(hash_set))
+#define Hash_Set_Free(hash_set)     Generic_Hash_Map_Free((Generic_Hash_Map*)(hash_set))
+
+// 'key_it' is a pointer to the key, the same rules as Hash_Map_For_Each().
+#define Hash_Set_For_Each(key_it, hash_set)                         \
+    for (                                                           \
+        Hash_Set_Key_Type(hash_set) *key_it = NULL;                 \
+        Generic_Hash_Map_For_Each_Iterator_Next((Generic_Hash_Map*)(hash_set), (void**)&key_it, Get_Hash_Set_Type_Properties(hash_set));     \
+    )
+
+// these all change 'hash_set', and leave 'other' alone.
+#define Hash_Set_Union(hash_set, other)                                                     \
+    do {                                                                                    \
+        static_assert(sizeof((hash_set)->entries->key) == sizeof((other)->entries->key), "the sets need the same key type");  \
+        Generic_Hash_Set_Union((Generic_Hash_Map*)(hash_set), (Generic_Hash_Map*)(other), Get_Hash_Set_Type_Properties(hash_set), Get_Hash_Set_Type_Properties(other), Get_Source_Code_Location()); \
+    } while (0)
+#define Hash_Set_Intersection(hash_set, other)                                              \
+    do {                                                                                    \
+        static_assert(sizeof((hash_set)->entries->key) == sizeof((other)->entries->key), "the sets need the same key type");  \
+        Generic_Hash_Set_Keep_If((Generic_Hash_Map*)(hash_set), (Generic_Hash_Map*)(other), true,  Get_Hash_Set_Type_Properties(hash_set), Get_Hash_Set_Type_Properties(other));    \
+    } while (0)
+#define Hash_Set_Difference(hash_set, other)                                                \
+    do {                                                                                    \
+        static_assert(sizeof((hash_set)->entries->key) == sizeof((other)->entries->key), "the sets need the same key type");  \
+        Generic_Hash_Set_Keep_If((Generic_Hash_Map*)(hash_set), (Generic_Hash_Map*)(other), false, Get_Hash_Set_Type_Properties(hash_set), Get_Hash_Set_Type_Properties(other));    \
+    } while (0)
+
+
+bool Generic_Hash_Set_Add    (Generic_Hash_Map *hash_set, void *key,               Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location);
+void Generic_Hash_Set_Union  (Generic_Hash_Map *hash_set, Generic_Hash_Map *other, Hash_Map_Key_Value_Type_Properties properties, Hash_Map_Key_Value_Type_Properties other_properties, Source_Code_Location caller_location);
+// keeps the keys that are (or aren't) in 'other'.
+void Generic_Hash_Set_Keep_If(Generic_Hash_Map *hash_set, Generic_Hash_Map *other, bool keep_if_in_other, Hash_Map_Key_Value_Type_Properties properties, Hash_Map_Key_Value_Type_Properties other_properties);
+
+
+
+// ===================================================
+//                 Frozen Hash Map
+// ===================================================
+
+//
+// A Hash_Map that will never change again, built with Hash_Map_Freeze().
+//
+// its a minimal perfect hash, (CHD, compress hash and displace), every key has
+// exactly one slot it could be in, and there are exactly 'count' slots. so a
+// lookup is one displacement, one entry, one compare. no probing, no empty slots.
+//
+// keys with the exact same hash, (like a hash function that only gives 32 bits),
+// cant be split up by a displacement, so all but one of them go in a small
+// overflow at the end, and only a lookup that finds the wrong one looks there.
+//
+// ```
+//     Hash_Map(u32, f32) map = ZEROED;
+//     ... put everything in ...
+//
+//     Frozen_Hash_Map(u32, f32) frozen = ZEROED;
+//     Hash_Map_Freeze(&map, &frozen);
+//     Hash_Map_Free(&map); // the frozen one has its own copy.
+//
+//     f32 *value = Frozen_Hash_Map_Get(&frozen, 12);
+//
+//     // everything lives in one blob, save it, and load it next time.
+//     Frozen_Hash_Map_Save(&frozen, "keywords.frozen");
+//     Frozen_Hash_Map_Free(&frozen);
+//
+//     Frozen_Hash_Map(u32, f32) loaded = ZEROED;
+//     if (!Frozen_Hash_Map_Load_File(&loaded, "keywords.frozen")) { ... }  // mmap()'d on linux.
+//     Frozen_Hash_Map_Free(&loaded);
+// ```
+//
+// the hash / eq functions and seed are copied from the map when its frozen,
+// when loading, set the same ones before Load(), (the blob only has the seed).
+//
+// saving only makes sense if the keys and values are plain data, a String key
+// still points wherever it pointed when it was frozen.
+//
+#define Frozen_Hash_Map(Key_Type, Value_Type)                       \
+    struct {                                                        \
+        /* exactly 'count' of these, no gaps. */                    \
+        struct {                                                    \
+            u64        hash;                                        \
+            Key_Type   key;                                         \
+            Value_Type value;                                       \
+        } *entries;                                                 \
+        u64 count;                                                  \
+        /* the last few, keys with the exact same hash as another */\
+        /* key, sorted by hash. (theres usually none.)            */\
+        u64 overflow_count;                                         \
+                                                                    \
+        /* one per bucket, see Frozen_Hash_Map_Slot(). */           \
+        u32 *displacements;                                         \
+        u64 bucket_count;                                           \
+        u64 displacement_seed;                                      \
+                                                                    \
+        Hash_Function        hash_function;                         \
+        Equality_Function    eq_function;                           \
+        u64                  seed;                                  \
+        Seeded_Hash_Function seeded_hash_function;                  \
+                                                                    \
+        /* everything above points in here. */                      \
+        Frozen_Hash_Map_Header *blob;                               \
+        u64 blob_size;                                              \
+        Frozen_Hash_Map_Blob_Kind blob_kind;                        \
+    }
+
+// the start of the blob, everything after it is found with the offsets.
+typedef struct {
+    u64 magic;
+    u64 entry_size;
+    u64 key_size;
+    u64 value_size;
+
+    u64 count;
+    u64 overflow_count;
+    u64 bucket_count;
+    u64 seed;
+    u64 displacement_seed;
+
+    u64 displacements_offset;
+    u64 entries_offset;
+} Frozen_Hash_Map_Header;
+
+// "BFROZEN1", (little endian).
+#define FROZEN_HASH_MAP_MAGIC           0x314E455A4F524642ULL
+
+// who Frozen_Hash_Map_Free() gives the blob back to.
+typedef enum {
+    Frozen_Hash_Map_Blob_Allocated = 0,
+    Frozen_Hash_Map_Blob_Mapped,
+    // from Frozen_Hash_Map_Load(), its yours.
+    Frozen_Hash_Map_Blob_Borrowed,
+} Frozen_Hash_Map_Blob_Kind;
+
+typedef struct {
+    void *entries;
+    u64 count;
+    u64 overflow_count;
+
+    u32 *displacements;
+    u64 bucket_count;
+    u64 displacement_seed;
+
+    Hash_Function        hash_function;
+    Equality_Function    eq_function;
+    u64                  seed;
+    Seeded_Hash_Function seeded_hash_function;
+
+    Frozen_Hash_Map_Header *blob;
+    u64 blob_size;
+    Frozen_Hash_Map_Blob_Kind blob_kind;
+} Generic_Frozen_Hash_Map;
+
+// the same as Get_Hash_Map_Type_Properties(), (there is no default value).
+#define Get_Frozen_Hash_Map_Type_Properties(frozen)                                         \
+    ((Hash_Map_Key_Value_Type_Properties) {                                                 \
+        .key_size   = sizeof((frozen)->entries->key),                                       \
+        .value_size = sizeof((frozen)->entries->value),                                     \
+                                                                                            \
+        .entry_size      = sizeof (*(frozen)->entries),                                     \
+        .entry_alignment = Alignof(*(frozen)->entries),                                     \
+                                                                                            \
+        .key_offset_in_entry   = offsetof(Typeof(*(frozen)->entries), key),                 \
+        .value_offset_in_entry = offsetof(Typeof(*(frozen)->entries), value),               \
+    })
+
+
+// on average how many keys share a displacement, less is faster to build, more is smaller.
+#ifndef FROZEN_HASH_MAP_BUCKET_SIZE
+    #define FROZEN_HASH_MAP_BUCKET_SIZE     2
+#endif
+
+// a displacement with this bit set is just the slot, (buckets with one key dont need to search).
+#define FROZEN_HASH_MAP_DIRECT_SLOT     (1u << 31)
+
+// x * n / 2^64, a 'mod n' without the divide.
+internal inline u64 Frozen_Hash_Map_Fast_Range(u64 x, u64 n) {
+    return (u64)(((__uint128_t)x * n) >> 64);
+}
+
+// mixed first, a user hash might only use the low bits.
+internal inline u64 Frozen_Hash_Map_Bucket(u64 hash, u64 bucket_count) {
+    return Frozen_Hash_Map_Fast_Range(Hash_u64(hash, HASH_SECRET_3), bucket_count);
+}
+
+// where a key with this hash lives, ('count' is the slots, the overflow isn't in there).
+internal inline u64 Frozen_Hash_Map_Slot(u32 *displacements, u64 bucket_count, u64 count, u64 displacement_seed, u64 hash) {
+    u32 displacement = displacements[Frozen_Hash_Map_Bucket(hash, bucket_count)];
+    if (displacement & FROZEN_HASH_MAP_DIRECT_SLOT) return displacement & ~FROZEN_HASH_MAP_DIRECT_SLOT;
+    return Frozen_Hash_Map_Fast_Range(Hash_u64(hash ^ displacement, displacement_seed), count);
+}
+
+
+// builds a frozen copy of the map, the map is unchanged.
+//
+// 'frozen' should be zeroed, (or Free()'d).
+#define Hash_Map_Freeze(hash_map, frozen)                                       \
+    do {                                                                        \
+        static_assert(sizeof(*(hash_map)->entries) == sizeof(*(frozen)->entries), "the frozen map needs the same key and value types"); \
+        Generic_Hash_Map_Freeze((Generic_Hash_Map*)(hash_map), (Generic_Frozen_Hash_Map*)(frozen), Get_Hash_Map_Type_Properties(hash_map), Get_Source_Code_Location()); \
+    } while (0)
+
+// returns a pointer to the value, or NULL if the key isn't there.
+#define Frozen_Hash_Map_Get(frozen, the_key)                                    \
+    ({                                                                          \
+        Typeof((frozen)->entries->key) key_on_stack = (the_key);                \
+        (Typeof((frozen)->entries->value)*) Generic_Frozen_Hash_Map_Get((Generic_Frozen_Hash_Map*)(frozen), &key_on_stack, Get_Frozen_Hash_Map_Type_Properties(frozen)); \
+    })
+
+#define Frozen_Hash_Map_Contains(frozen, the_key)   (Frozen_Hash_Map_Get((frozen), (the_key)) != NULL)
+
+// writes the blob to a file, returns false if it couldn't.
+#define Frozen_Hash_Map_Save(frozen, filepath)                                  \
+    Generic_Frozen_Hash_Map_Save((Generic_Frozen_Hash_Map*)(frozen), (filepath))
+
+// uses a blob from Save(), (or the same bytes from anywhere else), without copying it.
+//
+// returns false if its not a frozen map with these key and value types,
+// or if the blob is broken, (cut off, or an offset or slot pointing outside it).
+// the blob has to stay around, and be aligned like the entries.
+#define Frozen_Hash_Map_Load(frozen, blob, blob_size)                           \
+    Generic_Frozen_Hash_Map_Load((Generic_Frozen_Hash_Map*)(frozen), (blob), (blob_size), Get_Frozen_Hash_Map_Type_Properties(frozen))
+
+// Load(), but mmap()'s the file, (or reads it, if thats not a thing).
+#define Frozen_Hash_Map_Load_File(frozen, filepath)                             \
+    Generic_Frozen_Hash_Map_Load_File((Generic_Frozen_Hash_Map*)(frozen), (filepath), Get_Frozen_Hash_Map_Type_Properties(frozen))
+
+#define Frozen_Hash_Map_Free(frozen)                                            \
+    Generic_Frozen_Hash_Map_Free((Generic_Frozen_Hash_Map*)(frozen))
+
+
+void  Generic_Hash_Map_Freeze          (Generic_Hash_Map *hash_map, Generic_Frozen_Hash_Map *frozen, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location);
+void *Generic_Frozen_Hash_Map_Get      (Generic_Frozen_Hash_Map *frozen, void *key,                    Hash_Map_Key_Value_Type_Properties properties);
+bool  Generic_Frozen_Hash_Map_Save     (Generic_Frozen_Hash_Map *frozen, const char *filepath);
+bool  Generic_Frozen_Hash_Map_Load     (Generic_Frozen_Hash_Map *frozen, void *blob, u64 blob_size,    Hash_Map_Key_Value_Type_Properties properties);
+bool  Generic_Frozen_Hash_Map_Load_File(Generic_Frozen_Hash_Map *frozen, const char *filepath,         Hash_Map_Key_Value_Type_Properties properties);
+void  Generic_Frozen_Hash_Map_Free     (Generic_Frozen_Hash_Map *frozen);
+
+
+
+// ===================================================
+//                     LRU Cache
+// ===================================================
+
+//
+// A Hash_Map with a fixed capacity, when its full, putting a new
+// key throws out the one that was used the longest time ago.
+//
+// The keys and values live in arrays of 'capacity' slots, allocated once, and
+// the use order is a doubly linked list of slot indexes, so theres no allocating
+// per key, and Get, Put and the eviction are all O(1).
+//
+// ```
+//     LRU_Cache(u64, Result) cache = { .capacity = 1024 };
+//
+//     Result *result = LRU_Cache_Get(&cache, input); // NULL on a miss.
+//     if (!result) {
+//         result  = LRU_Cache_Put(&cache, input);    // might evict something.
+//         *result = compute(input);
+//     }
+//
+//     printf("%zu hits, %zu misses\n", cache.hits, cache.misses);
+//     LRU_Cache_Free(&cache);
+// ```
+//
+// the key -> slot map is just a Hash_Map, so set its hash
+// function like any other, (.map.hash_function = Hash_Map_Hash_String).
+//
+// set '.on_evict' to hear about keys getting thrown out, (to free whatever
+// the value owns), its called before the slot gets reused, and for everything
+// thats left in Clear() and Free(). Remove() dosen't call it, you allready know.
+//
+// '.use_clock' swaps the list for the CLOCK approximation, a hit just sets a byte
+// instead of moving the slot to the front of the list, and eviction sweeps a hand
+// around the slots, giving anything that was used since last time a second chance.
+// its not exactly least recently used, but Get() only writes one byte, good for
+// caches that are read a lot more than there written.
+//
+
+#define LRU_CACHE_NO_SLOT   ((u32)-1)
+
+// 'key' and 'value' point into the cache, there about to be written over.
+typedef void (*LRU_Cache_Evict_Function)(void *key, void *value, void *user_data);
+
+typedef struct {
+    u32 prev;
+    // for a free slot, its the next free one.
+    u32 next;
+} LRU_Cache_Link;
+
+#define LRU_Cache(Key_Type, Value_Type)                                         \
+    struct {                                                                    \
+        /* set these before the first Put() */                                  \
+        u32 capacity;                                                           \
+        bool use_clock;                                                         \
+        LRU_Cache_Evict_Function on_evict;                                      \
+        void *user_data;                                                        \
+        /* Settable allocator, used for the map too */                          \
+        Arena *allocator;                                                       \
+                                                                                \
+        u32 count;                                                              \
+        Key_Type   *keys;                                                       \
+        Value_Type *values;                                                     \
+        LRU_Cache_Link *links;                                                  \
+        /* one byte a slot, only for CLOCK */                                   \
+        u8 *referenced;                                                         \
+                                                                                \
+        /* most and least recently used, (the list isn't kept with CLOCK) */    \
+        u32 head, tail;                                                         \
+        u32 free_list;                                                          \
+        /* slots past this have never been used */                              \
+        u32 used;                                                               \
+        u32 clock_hand;                                                         \
+                                                                                \
+        u64 hits;                                                               \
+        u64 misses;                                                             \
+        u64 evictions;                                                          \
+                                                                                \
+        /* key -> slot, its last so the generic struct can leave it off */      \
+        Hash_Map(Key_Type, u32) map;                                            \
+    }
+
+// this struct shares the same shape as every lru cache, (minus the map).
+typedef struct {
+    u32 capacity;
+    bool use_clock;
+    LRU_Cache_Evict_Function on_evict;
+    void *user_data;
+    Arena *allocator;
+
+    u32 count;
+    void *keys;
+    void *values;
+    LRU_Cache_Link *links;
+    u8 *referenced;
+
+    u32 head, tail;
+    u32 free_list;
+    u32 used;
+    u32 clock_hand;
+
+    u64 hits;
+    u64 misses;
+    u64 evictions;
+} Generic_LRU_Cache;
+
+
+#define Get_LRU_Cache_Key_Properties(cache)     ( (Array_Item_Type_Properties_Struct){ sizeof(*(cache)->keys),   Alignof(*(cache)->keys)   } )
+#define Get_LRU_Cache_Value_Properties(cache)   ( (Array_Item_Type_Properties_Struct){ sizeof(*(cache)->values), Alignof(*(cache)->values) } )
+
+// NULL on a miss, a hit makes it the most recently used.
+//
+// the pointer is good until the next Put() or Remove().
+#define LRU_Cache_Get(cache, the_key)                                                       \
+    ({                                                                                      \
+        u32 *_slot = Hash_Map_Get(&(cache)->map, (the_key));                                \
+        Generic_LRU_Cache_Lookup((Generic_LRU_Cache*)(cache), _slot);                       \
+        _slot ? &(cache)->values[*_slot] : NULL;                                            \
+    })
+
+// pointer to the keys value, if the key is new its zeroed, and
+// if the cache is full the least recently used one gets evicted.
+#define LRU_Cache_Put(cache, the_key)                                                       \
+    ({                                                                                      \
+        Typeof(*(cache)->keys) _lru_key = (the_key);                                        \
+        u32 *_slot = Hash_Map_Get(&(cache)->map, _lru_key);                                 \
+        u32 _index;                                                                         \
+        if (_slot) {                                                                        \
+            _index = *_slot;                                                                \
+            Generic_LRU_Cache_Use((Generic_LRU_Cache*)(cache), _index);                     \
+        } else {                                                                            \
+            if (!(cache)->keys) {                                                           \
+                (cache)->map.allocator = (cache)->allocator;                                \
+                Hash_Map_Reserve(&(cache)->map, (cache)->capacity);                         \
+            }                                                                               \
+            bool _evicted = false;                                                          \
+            _index = Generic_LRU_Cache_Take_Slot((Generic_LRU_Cache*)(cache), Get_LRU_Cache_Key_Properties(cache), Get_LRU_Cache_Value_Properties(cache), &_evicted, Get_Source_Code_Location());   \
+            if (_evicted) Hash_Map_Remove(&(cache)->map, (cache)->keys[_index]);            \
+            (cache)->keys[_index] = _lru_key;                                               \
+            Mem_Zero(&(cache)->values[_index], sizeof(*(cache)->values));                   \
+            *Hash_Map_Put(&(cache)->map, _lru_key) = _index;                                \
+        }                                                                                   \
+        &(cache)->values[_index];                                                           \
+    })
+
+// returns false if the key wasn't in there, '.on_evict' isn't called.
+#define LRU_Cache_Remove(cache, the_key)                                                    \
+    ({                                                                                      \
+        Typeof(*(cache)->keys) _lru_key = (the_key);                                        \
+        u32 *_slot = Hash_Map_Get(&(cache)->map, _lru_key);                                 \
+        if (_slot) {                                                                        \
+            Generic_LRU_Cache_Release_Slot((Generic_LRU_Cache*)(cache), *_slot);            \
+            Hash_Map_Remove(&(cache)->map, _lru_key);                                       \
+        }                                                                                   \
+        _slot != NULL;                                                                      \
+    })
+
+// dosen't count as a use, or a hit or miss.
+#define LRU_Cache_Contains(cache, the_key)      Hash_Map_Contains(&(cache)->map, (the_key))
+
+// removes everything, '.on_evict' gets called for all of it.
+#define LRU_Cache_Clear(cache)                                                              \
+    do {                                                                                    \
+        if ((cache)->on_evict) {                                                            \
+            Hash_Map_For_Each(_slot, &(cache)->map) {                                       \
+                (cache)->on_evict(&(cache)->keys[*_slot], &(cache)->values[*_slot], (cache)->user_data);   \
+            }                                                                               \
+        }                                                                                   \
+        Hash_Map_Clear(&(cache)->map);                                                      \
+        Generic_LRU_Cache_Clear((Generic_LRU_Cache*)(cache));                               \
+    } while (0)
+
+// clears it first, (so '.on_evict' is called), only frees the memory if you haven't set an allocator.
+#define LRU_Cache_Free(cache)                                                               \
+    do {                                                                                    \
+        LRU_Cache_Clear(cache);                                                             \
+        if (!(cache)->allocator) Hash_Map_Free(&(cache)->map);                              \
+        Generic_LRU_Cache_Free((Generic_LRU_Cache*)(cache));                                \
+    } while (0)
+
+
+// counts a hit or a miss, (slot is NULL), and uses the slot on a hit.
+void Generic_LRU_Cache_Lookup(Generic_LRU_Cache *cache, u32 *slot);
+// makes it the most recently used, (or sets its referenced byte, for CLOCK).
+void Generic_LRU_Cache_Use(Generic_LRU_Cache *cache, u32 slot);
+// a slot for a new key, allocates everything on the first call.
+// if it had to evict someone, 'evicted' gets set, and the old key is still in the slot.
+u32  Generic_LRU_Cache_Take_Slot(Generic_LRU_Cache *cache, Array_Item_Type_Properties_Struct key_properties, Array_Item_Type_Properties_Struct value_properties, bool *evicted, Source_Code_Location caller_location);
+void Generic_LRU_Cache_Release_Slot(Generic_LRU_Cache *cache, u32 slot);
+// keeps the memory and the counters.
+void Generic_LRU_Cache_Clear(Generic_LRU_Cache *cache);
+void Generic_LRU_Cache_Free(Generic_LRU_Cache *cache);
+
+
+
+// ===================================================
+//               Bloom & Cuckoo Filters
+// ===================================================
+
+//
+// For when most lookups are misses, and a miss is expensive, (a big Hash_Map,
+// something on disk). A filter says 'definitely not in there', or 'maybe',
+// so most of the misses never get to the real lookup.
+//
+// Both get sized from how many keys you expect, and how many false positives
+// are ok, and both take the same hash's as the Hash_Map, (or the key, and they hash it).
+//
+// ```
+//     Bloom_Filter seen = ZEROED; // set .allocator or .seed first if you want.
+//     Bloom_Filter_Init(&seen, 1000000, 0.01); // about 1% of misses say 'maybe'.
+//
+//     Bloom_Filter_Add(&seen, id);
+//     if (Bloom_Filter_Maybe_Contains(&seen, id)) { ...do the real lookup... }
+//
+//     // already have a hash? (strings and such).
+//     Bloom_Filter_Add_Hash(&seen, Hash_String(name, seen.seed));
+//
+//     Bloom_Filter_Free(&seen);
+// ```
+//
+// The bloom filter is blocked, every key sets 8 bits in one 64 byte block, (one bit
+// per u64), so a lookup is one cache miss, and the bits are tested with SIMD.
+// You cant take anything out of it though.
+//
+// The cuckoo filter can remove keys, it stores a small fingerprint of every key in
+// one of two buckets of 4. only remove keys you added, or you'll take out someone else.
+//
+// ```
+//     Cuckoo_Filter live = ZEROED;
+//     Cuckoo_Filter_Init(&live, 1000000, 0.001);
+//
+//     if (!Cuckoo_Filter_Add(&live, id)) { ...its full... }
+//     Cuckoo_Filter_Maybe_Contains(&live, id);
+//     Cuckoo_Filter_Remove(&live, id);
+//
+//     Cuckoo_Filter_Free(&live);
+// ```
+//
+
+#define BLOOM_FILTER_BLOCK_WORDS    8
+#define CUCKOO_FILTER_BUCKET_SIZE   4
+// how many times a fingerprint gets kicked to the other bucket before giving up.
+#ifndef CUCKOO_FILTER_MAX_KICKS
+    #define CUCKOO_FILTER_MAX_KICKS     500
+#endif
+
+typedef struct {
+    // block_count blocks of 8 u64's, each one is a cache line.
+    u64 *blocks;
+    u64 block_count;
+    // how many keys went in.
+    u64 count;
+
+    u64 seed;
+    // Settable allocator
+    Arena *allocator;
+} Bloom_Filter;
+
+typedef struct {
+    // bucket_count buckets of 4 fingerprints, 0 is an empty slot.
+    u8 *buckets;
+    // always a power of 2, the other bucket is just a xor away.
+    u64 bucket_count;
+    // 1, 2 or 4 bytes, picked from the false positive rate.
+    u32 fingerprint_size;
+    u64 count;
+
+    u64 seed;
+    // Settable allocator
+    Arena *allocator;
+
+    // the last fingerprint that got kicked out and couldn't find a home,
+    // the filter is full when this is used.
+    bool has_victim;
+    u32  victim_fingerprint;
+    u64  victim_bucket;
+} Cuckoo_Filter;
+
+
+// 'false_positive_rate' is between 0 and 1, 0.01 is 1%.
+void Bloom_Filter_Init(Bloom_Filter *filter, u64 expected_count, f64 false_positive_rate);
+void Bloom_Filter_Add_Hash(Bloom_Filter *filter, u64 hash);
+bool Bloom_Filter_Maybe_Contains_Hash(Bloom_Filter *filter, u64 hash);
+void Bloom_Filter_Clear(Bloom_Filter *filter);
+// only call this if you haven't set an allocator.
+void Bloom_Filter_Free(Bloom_Filter *filter);
+
+// hash's the bytes of the key, the same way the Hash_Map dose.
+#define Bloom_Filter_Add(filter, key)                                                                       \
+    ({                                                                                                      \
+        Typeof(key) key_on_stack = (key);                                                                   \
+        Bloom_Filter_Add_Hash((filter), Hash_Map_Default_Seeded_Hash_Function(&key_on_stack, sizeof(key_on_stack), (filter)->seed));   \
+    })
+#define Bloom_Filter_Maybe_Contains(filter, key)                                                            \
+    ({                                                                                                      \
+        Typeof(key) key_on_stack = (key);                                                                   \
+        Bloom_Filter_Maybe_Contains_Hash((filter), Hash_Map_Default_Seeded_Hash_Function(&key_on_stack, sizeof(key_on_stack), (filter)->seed));    \
+    })
+
+
+void Cuckoo_Filter_Init(Cuckoo_Filter *filter, u64 expected_count, f64 false_positive_rate);
+// returns false if the filter is full. (if this was the key that filled it, its still in there.)
+bool Cuckoo_Filter_Add_Hash(Cuckoo_Filter *filter, u64 hash);
+bool Cuckoo_Filter_Maybe_Contains_Hash(Cuckoo_Filter *filter, u64 hash);
+// returns false if the fingerprint wasn't there.
+bool Cuckoo_Filter_Remove_Hash(Cuckoo_Filter *filter, u64 hash);
+void Cuckoo_Filter_Clear(Cuckoo_Filter *filter);
+// only call this if you haven't set an allocator.
+void Cuckoo_Filter_Free(Cuckoo_Filter *filter);
+
+#define Cuckoo_Filter_Add(filter, key)                                                                      \
+    ({                                                                                                      \
+        Typeof(key) key_on_stack = (key);                                                                   \
+        Cuckoo_Filter_Add_Hash((filter), Hash_Map_Default_Seeded_Hash_Function(&key_on_stack, sizeof(key_on_stack), (filter)->seed));     \
+    })
+#define Cuckoo_Filter_Maybe_Contains(filter, key)                                                           \
+    ({                                                                                                      \
+        Typeof(key) key_on_stack = (key);                                                                   \
+        Cuckoo_Filter_Maybe_Contains_Hash((filter), Hash_Map_Default_Seeded_Hash_Function(&key_on_stack, sizeof(key_on_stack), (filter)->seed));   \
+    })
+#define Cuckoo_Filter_Remove(filter, key)                                                                   \
+    ({                                                                                                      \
+        Typeof(key) key_on_stack = (key);                                                                   \
+        Cuckoo_Filter_Remove_Hash((filter), Hash_Map_Default_Seeded_Hash_Function(&key_on_stack, sizeof(key_on_stack), (filter)->seed));  \
+    })
+
+
+
+// ===================================================
+//              Concurrent Hash Map
+// ===================================================
+
+//
+// A Hash_Map that lots of threads can use at once.
+//
+// its split into shards, each one is a normal Hash_Map with its own RW_Lock,
+// so threads only wait on each other when they want the same shard. the top
+// bits of the hash pick the shard, (the maps inside use the low bits).
+//
+// you never get a pointer into the map, (someone else could move it),
+// values are copied in and out while the shard is locked.
+//
+// ```
+//     Concurrent_Hash_Map(u64, u32) counts = { .default_value = 0 };
+//     Concurrent_Hash_Map_Init(&counts, 64);  // a power of 2, more threads want more shards
+//
+//     // from any thread.
+//     Concurrent_Hash_Map_Put(&counts, 12, 5);
+//
+//     u32 value;
+//     if (Concurrent_Hash_Map_Get(&counts, 12, &value)) { ... }
+//     u32 other = Concurrent_Hash_Map_Get_Or_Default(&counts, 13);
+//     Concurrent_Hash_Map_Remove(&counts, 12);
+//
+//     // a copy of everything, one shard at a time, (so only each shard is consistent).
+//     Hash_Map(u64, u32) copy = ZEROED;
+//     Concurrent_Hash_Map_Snapshot(&counts, &copy);
+//     Hash_Map_For_Each(it, &copy) { ... }
+//
+//     Concurrent_Hash_Map_Free(&counts);
+// ```
+//
+// set the hash / eq functions, seed, layout and default value before Init(),
+// they get copied into every shard. there is no allocator, arenas aren't thread safe.
+//
+#define Concurrent_Hash_Map(Key_Type, Value_Type)                   \
+    struct {                                                        \
+        /* each shard gets its own cache line, no false sharing. */ \
+        struct {                                                    \
+            alignas(64) RW_Lock lock;                               \
+            Hash_Map(Key_Type, Value_Type) map;                     \
+        } *shards;                                                  \
+        u64 shard_count;                                            \
+                                                                    \
+        Hash_Function        hash_function;                         \
+        Equality_Function    eq_function;                           \
+        u64                  seed;                                  \
+        Seeded_Hash_Function seeded_hash_function;                  \
+        Hash_Map_Layout      layout;                                \
+                                                                    \
+        Value_Type default_value;                                   \
+    }
+
+typedef struct {
+    void *shards;
+    u64 shard_count;
+
+    Hash_Function        hash_function;
+    Equality_Function    eq_function;
+    u64                  seed;
+    Seeded_Hash_Function seeded_hash_function;
+    Hash_Map_Layout      layout;
+
+    u8 default_value_maybe[];
+} Generic_Concurrent_Hash_Map;
+
+typedef struct {
+    Hash_Map_Key_Value_Type_Properties map;
+
+    u64 shard_size;
+    u64 shard_alignment;
+    u64 map_offset_in_shard;
+    u64 default_value_offset;
+} Concurrent_Hash_Map_Properties;
+
+#define Get_Concurrent_Hash_Map_Properties(concurrent_map)                                  \
+    ((Concurrent_Hash_Map_Properties) {                                                     \
+        .map                  = Get_Hash_Map_Type_Properties(&(concurrent_map)->shards->map), \
+        .shard_size           = sizeof (*(concurrent_map)->shards),                         \
+        .shard_alignment      = Alignof(*(concurrent_map)->shards),                         \
+        .map_offset_in_shard  = offsetof(Typeof(*(concurrent_map)->shards), map),           \
+        .default_value_offset = offsetof(Typeof(*(concurrent_map)), default_value),         \
+    })
+
+#define Concurrent_Hash_Map_Key_Type(concurrent_map)     Typeof((concurrent_map)->shards->map.entries->key)
+#define Concurrent_Hash_Map_Value_Type(concurrent_map)   Typeof((concurrent_map)->shards->map.entries->value)
+
+
+// shard_count has to be a power of 2.
+#define Concurrent_Hash_Map_Init(concurrent_map, shard_count)                   \
+    Generic_Concurrent_Hash_Map_Init((Generic_Concurrent_Hash_Map*)(concurrent_map), (shard_count), Get_Concurrent_Hash_Map_Properties(concurrent_map), Get_Source_Code_Location())
+
+// copies the value into 'value_out', returns false if the key isn't there.
+#define Concurrent_Hash_Map_Get(concurrent_map, the_key, value_out)             \
+    ({                                                                          \
+        Concurrent_Hash_Map_Key_Type(concurrent_map)    key_on_stack = (the_key);   \
+        Concurrent_Hash_Map_Value_Type(concurrent_map) *value_out_ptr = (value_out); \
+        Generic_Concurrent_Hash_Map_Get((Generic_Concurrent_Hash_Map*)(concurrent_map), &key_on_stack, value_out_ptr, Get_Concurrent_Hash_Map_Properties(concurrent_map)); \
+    })
+
+// sets the value for this key, adding it if its not there.
+#define Concurrent_Hash_Map_Put(concurrent_map, the_key, the_value)             \
+    ({                                                                          \
+        Concurrent_Hash_Map_Key_Type(concurrent_map)   key_on_stack   = (the_key);  \
+        Concurrent_Hash_Map_Value_Type(concurrent_map) value_on_stack = (the_value); \
+        Generic_Concurrent_Hash_Map_Put((Generic_Concurrent_Hash_Map*)(concurrent_map), &key_on_stack, &value_on_stack, Get_Concurrent_Hash_Map_Properties(concurrent_map), Get_Source_Code_Location()); \
+    })
+
+// returns the value, (a copy), adds the default value if the key isn't there.
+#define Concurrent_Hash_Map_Get_Or_Default(concurrent_map, the_key)             \
+    ({                                                                          \
+        Concurrent_Hash_Map_Key_Type(concurrent_map)   key_on_stack = (the_key);    \
+        Concurrent_Hash_Map_Value_Type(concurrent_map) value_out;               \
+        Generic_Concurrent_Hash_Map_Get_Or_Default((Generic_Concurrent_Hash_Map*)(concurrent_map), &key_on_stack, &value_out, Get_Concurrent_Hash_Map_Properties(concurrent_map), Get_Source_Code_Location()); \
+        value_out;                                                              \
+    })
+
+// returns weather or not the key was in the map.
+#define Concurrent_Hash_Map_Remove(concurrent_map, the_key)                     \
+    ({                                                                          \
+        Concurrent_Hash_Map_Key_Type(concurrent_map) key_on_stack = (the_key);  \
+        Generic_Concurrent_Hash_Map_Remove((Generic_Concurrent_Hash_Map*)(concurrent_map), &key_on_stack, Get_Concurrent_Hash_Map_Properties(concurrent_map)); \
+    })
+
+// adds up the count of every shard, could be out of date by the time you look at it.
+#define Concurrent_Hash_Map_Count(concurrent_map)                               \
+    Generic_Concurrent_Hash_Map_Count((Generic_Concurrent_Hash_Map*)(concurrent_map), Get_Concurrent_Hash_Map_Properties(concurrent_map))
+
+// puts a copy of everything into a normal Hash_Map with the same key and value types,
+// (it dosen't clear it first), each shard is read locked while its copied.
+#define Concurrent_Hash_Map_Snapshot(concurrent_map, hash_map)                  \
+    do {                                                                        \
+        static_assert(sizeof(*(hash_map)->entries) == sizeof(*(concurrent_map)->shards->map.entries), "the snapshot needs the same key and value types"); \
+        Generic_Concurrent_Hash_Map_Snapshot((Generic_Concurrent_Hash_Map*)(concurrent_map), (Generic_Hash_Map*)(hash_map), Get_Concurrent_Hash_Map_Properties(concurrent_map), Get_Source_Code_Location()); \
+    } while (0)
+
+// frees every shard, dont use it from any other thread while this is happening.
+#define Concurrent_Hash_Map_Free(concurrent_map)                                \
+    Generic_Concurrent_Hash_Map_Free((Generic_Concurrent_Hash_Map*)(concurrent_map), Get_Concurrent_Hash_Map_Properties(concurrent_map))
+
+
+void Generic_Concurrent_Hash_Map_Init          (Generic_Concurrent_Hash_Map *concurrent_map, u64 shard_count,           Concurrent_Hash_Map_Properties properties, Source_Code_Location caller_location);
+bool Generic_Concurrent_Hash_Map_Get           (Generic_Concurrent_Hash_Map *concurrent_map, void *key, void *value_out, Concurrent_Hash_Map_Properties properties);
+void Generic_Concurrent_Hash_Map_Put           (Generic_Concurrent_Hash_Map *concurrent_map, void *key, void *value,     Concurrent_Hash_Map_Properties properties, Source_Code_Location caller_location);
+void Generic_Concurrent_Hash_Map_Get_Or_Default(Generic_Concurrent_Hash_Map *concurrent_map, void *key, void *value_out, Concurrent_Hash_Map_Properties properties, Source_Code_Location caller_location);
+bool Generic_Concurrent_Hash_Map_Remove        (Generic_Concurrent_Hash_Map *concurrent_map, void *key,                  Concurrent_Hash_Map_Properties properties);
+u64  Generic_Concurrent_Hash_Map_Count         (Generic_Concurrent_Hash_Map *concurrent_map,                             Concurrent_Hash_Map_Properties properties);
+void Generic_Concurrent_Hash_Map_Snapshot      (Generic_Concurrent_Hash_Map *concurrent_map, Generic_Hash_Map *hash_map, Concurrent_Hash_Map_Properties properties, Source_Code_Location caller_location);
+void Generic_Concurrent_Hash_Map_Free          (Generic_Concurrent_Hash_Map *concurrent_map,                             Concurrent_Hash_Map_Properties properties);
+
+
+
+// ===================================================
+//                       String
+// ===================================================
+
+// returns true if c is one of the ASCII whitespace characters.
+bool Is_Whitespace(char c);
+#define To_Upper(c) (('a' <= (c) && (c) <= 'z') ? ((c) - 'a' + 'A') : (c))
+#define To_Lower(c) (('A' <= (c) && (c) <= 'Z') ? ((c) - 'A' + 'a') : (c))
+
+
+typedef struct {
+    char *data;
+    u64 length;
+} String;
+
+typedef Array(String) String_Array;
+
+
+// Formatting for printf()
+#define S_Fmt    "%.*s"
+#define S_Arg(s) (int) (s).length, (s).data
+
+String  String_From_C_Str(const char *str);
+#define S(c_str)    String_From_C_Str(c_str)
+
+
+// will use BESTED_MALLOC() if allocator is NULL
+const char *String_To_C_Str(String s, Arena *allocator);
+const char *temp_String_To_C_Str(String s);
+
+
+typedef struct {
+    // the allocator to use, will use BESTED_MALLOC() if null.
+    Arena* allocator;
+    // weather or not to null terminate the string.
+    bool null_terminate;
+} String_Duplicate_Opt;
+
+// if arena == NULL, uses BESTED_MALLOC.
+//
+// by default dose not null_terminate
+#define String_Duplicate(string, ...) _String_Duplicate((string), (String_Duplicate_Opt){ __VA_ARGS__ })
+String _String_Duplicate(String s, String_Duplicate_Opt opt);
+
+// in place.
+void    String_To_Upper(String *s);
+
+bool    String_Eq           (String s1, String s2);
+bool    String_Starts_With  (String s, String prefix);
+bool    String_Ends_With    (String s, String postfix);
+
+bool    String_Contains_Char        (String s, char c);
+// finds the first occurrence of c in s, -1 on failure
+s64     String_Find_Index_Of_Char   (String s, char c);
+// finds the first occurrence of needle in s, -1 on failure
+// if needle.size == 0, returns -1.
+s64     String_Find_Index_Of        (String s, String needle);
+
+// finds the line at index, and returns a String of the line, strips '\n'
+String  String_get_single_line(String s, u64 index);
+
+// advance the data, subtract the size, in place.
+// dose not check for null, or do any bounds checking. thats on you.
+void    String_Advance  (String *s, s64 count);
+// advance the data, subtract the size, returns a new copy.
+// dose not check for null, or do any bounds checking. thats on you.
+String  String_Advanced (String s, s64 count);
+
+typedef bool (*char_to_bool_func)(char);
+// remove ASCII whitespace characters from the right of the String.
+String  String_Trim_Right(String s);
+// returns a String with the front chopped off, according to the test function.
+// use Is_Whitespace to chop the whitespace off of the front.
+String  String_Chop_While(String s, char_to_bool_func test_char_function);
+
+
+typedef struct {
+    // left side of the split, may be entire
+    // string if separator was not present.
+    String left;
+    // right side of the split. may be empty.
+    String right;
+    // weather the separator was in the string at all.
+    bool ok;
+} Split_Once_Result;
+
+// splits the string once.
+//
+// if the separator is not in the string, the left side
+// returns the whole string, and the right string is empty.
+Split_Once_Result Split_Once(String string, String separator);
+
+// appends the string split by separator parts into the result array.
+//
+// returns the number of sections.
+u64 String_Split_By(String string, String separator, String_Array *result);
+
+
+String String_Path_to_Filename(String s);
+String String_Remove_Extention(String s);
+
+typedef enum {
+    SGNL_Remove_Comments = 1 << 0,
+    SGNL_Trim            = 1 << 1,
+    SGNL_Skip_Empty      = 1 << 2,
+    SGNL_All             = SGNL_Remove_Comments | SGNL_Trim | SGNL_Skip_Empty,
+} String_Get_Next_Line_Flag;
+
+// gets the next line in parseing, and advances parseing and line_num to match
+// bool's toggle removeing comments that start with '#',
+// trimming the output (from the right), and skiping over empty lines.
+//
+// 'result == parseing' signifies the end of the file.
+// OR result.size == 0 if skip_empty is toggled.
+String  String_Get_Next_Line(String *parseing, u64 *line_num, String_Get_Next_Line_Flag flags);
+
+
+const char *temp_sprintf       (const char *format, ...) __attribute__ ((format (printf, 1, 2)));
+// is null terminated
+String      temp_String_sprintf(const char *format, ...) __attribute__ ((format (printf, 1, 2)));
+
+
+
+// ===================================================
+//                    String Builder
+// ===================================================
+
+#define STRING_BUILDER_NUM_BUFFERS      32
+static_assert(Is_Pow_2(STRING_BUILDER_NUM_BUFFERS), "For Speed");
+
+// how much to alloc by default when a new segment of memory is needed.
+#ifndef STRING_BUILDER_BUFFER_DEFAULT_SIZE
+    // 4096 bytes is equal to the default page size in windows and linux. probably.
+    #define STRING_BUILDER_BUFFER_DEFAULT_SIZE      (4 * KILOBYTE)
+#endif
+
+// This macro is called when something goes wrong. Recommended to just use assert.
+//
+// If the macro dose nothing, (or doesn't exist,) the results of some operations
+// will return NULL/base values. or do no work at all. use at your own risk.
+#ifndef STRING_BUILDER_PANIC
+    #define STRING_BUILDER_PANIC(error_text)        ASSERT(false && error_text)
+#endif
+
+
+// String Builder internal structure
+// holds the segments of the being built string.
+typedef struct {
+    char *data;
+    u64 count;
+    u64 capacity;
+} Character_Buffer;
+
+// String Builder internal structure
+// Holds a bunch character buffers, and a pointer to the next Segment as well,
+// Acts like a linked list node.
+typedef struct Segment {
+    struct Segment *next;
+    Character_Buffer buffers[STRING_BUILDER_NUM_BUFFERS];
+} Segment;
+
+// A data-structure that can efficiently grow a string.
+// good for medium to large strings. small strings (< 4096 bytes) are not recommended, as this structure will allocate once.
+typedef struct String_Builder {
+    // how much to allocate when a new segment is needed.
+    u64 base_new_allocation;
+
+    // the current segment were working on.
+    // if its pointing to NULL, (aka you just zero initalized it), it will be set to a pointer to 'first_segment_holder'
+    Segment *current_segment;
+
+    // last buffer in use.
+    u64 buffer_index;
+    // the first in a linked list.
+    Segment first_segment_holder;
+
+    // set an allocator to use it to allocate, otherwise uses 'BESTED_MALLOC()'.
+    Arena *allocator;
+} String_Builder;
+
+
+// current size of the string being built.
+//
+// this calculation runs though all of the segments, so dont spam it maybe.
+u64 String_Builder_Count(String_Builder *sb);
+// how much space the builder has.
+// NOTE. some space will be wasted, for performance reasons.
+u64 String_Builder_Total_Capacity(String_Builder *sb);
+
+void String_Builder_Clear(String_Builder *sb);
+
+// Dose not check for NULL byte
+void String_Builder_Ptr_And_Size(String_Builder *sb, void *ptr, u64 size);
+// Dose not check for NULL byte
+void String_Builder_String(String_Builder *sb, String s);
+
+u64 String_Builder_printf(String_Builder *sb, const char *format, ...) __attribute__ ((format (printf, 2, 3)));
+
+#define String_Builder_Struct_Bytes(sb, struct_ptr) String_Builder_Ptr_And_Size((sb), (void*) (struct_ptr), sizeof(*(struct_ptr)))
+#define String_Builder_Array_Bytes(sb, ptr, count)  String_Builder_Ptr_And_Size((sb), (void*)(ptr), sizeof(*(ptr)) * (count))
+
+
+// A trailing NULL byte is appended, so you can pass it into functions that expect a C String
+String String_Builder_To_String(String_Builder *sb);
+
+// Dose not write a trailing NULL byte, (as apposed to SB_to_SV)
+void String_Builder_To_File(String_Builder *sb, FILE *file);
+
+// only call if your not useing an allocator.
+void String_Builder_Free(String_Builder *sb);
+
+
+
+// ===================================================
+//                 String Interner
+// ===================================================
+
+//
+// Keeps one copy of every string you give it, and hands back a small id for it.
+//
+// after that, two interned strings are the same string if there ids are the same,
+// no hashing or Mem_Cmp(), and an id makes a way better map key than a String,
+// (4 bytes, and the default hash is a single multiply).
+//
+// ```
+//     String_Interner interner = ZEROED;
+//
+//     String_Id hello = String_Interner_Intern(&interner, S("hello"));
+//     ASSERT(hello == String_Interner_Intern(&interner, S("hello")));
+//
+//     // the one copy, it lives until String_Interner_Free().
+//     String same = String_Interner_Get(&interner, hello);
+//
+//     // zero if its never been interned.
+//     String_Id maybe = String_Interner_Find(&interner, S("world"));
+//
+//     // a tokenizers worth at once, the lookups are batched.
+//     String_Interner_Intern_Many(&interner, tokens.items, tokens.count, ids);
+//
+//     String_Interner_Free(&interner);
+// ```
+//
+// set '.thread_safe' before its first use if more than one thread is going to
+// use it. lookups only take the read lock, new strings take the write lock.
+//
+
+// zero is never a real string.
+typedef u32 String_Id;
+
+// how a String_Interner finds the id for a string, the hash only gets worked out once.
+Hash_Map_Define(String_Interner_Map, String, String_Id, Hash_String, String_Eq)
+
+typedef struct {
+    // the bytes of every string, (null terminated, so they work as c strings).
+    Arena arena;
+    // the strings, indexed by id - 1, these point into the arena.
+    String_Array strings;
+    // string -> id, the keys point into the arena too.
+    String_Interner_Map ids;
+
+    // set this before the first use, if its shared between threads.
+    bool thread_safe;
+    RW_Lock lock;
+} String_Interner;
+
+
+// returns the id for this string, copying it in if its new.
+String_Id String_Interner_Intern(String_Interner *interner, String s);
+// returns the id for this string, or zero if its not in there.
+String_Id String_Interner_Find  (String_Interner *interner, String s);
+// the interned copy, id has to be from this interner.
+String    String_Interner_Get   (String_Interner *interner, String_Id id);
+
+// intern 'count' strings, putting the ids into 'ids_out'.
+//
+// looks up a batch at a time, so the cache misses overlap, (and the
+// lock is taken once per batch, not once per string).
+void String_Interner_Intern_Many(String_Interner *interner, String *strings, u64 count, String_Id *ids_out);
+
+// the interned copy of this string, (adding it if its new).
+#define String_Interner_Canonical(interner, s)                                      \
+    ({                                                                              \
+        String_Interner *interner_ptr = (interner);                                 \
+        String_Interner_Get(interner_ptr, String_Interner_Intern(interner_ptr, (s))); \
+    })
+
+// how many unique strings have been interned.
+u64  String_Interner_Count(String_Interner *interner);
+
+// every String from this interner is gone after this.
+void String_Interner_Free(String_Interner *interner);
+
+
+
+// ===================================================
+//                      Misc
+// ===================================================
+
+// these are just useful, dont have to make these every single project.
+typedef Array(s64)    Int_Array;
+
+
+// will return malloc'd string if arena is NULL,
+String Read_Entire_File(String filename, Arena *arena);
+
+// only works on unix.
+u64 nanoseconds_since_unspecified_epoch(void);
+
+bool check_if_file_exists(const char *filepath);
+
+
+
+// ===================================================
+//                 Debug Helpers
+// ===================================================
+
+// extremely annoyed that we have to pass pointers in here.
+//
+// _Generic() is just terrible.
+
+const char *print_s64   (void *_x);
+const char *print_u64   (void *_x);
+
+const char *print_s32   (void *_x);
+const char *print_u32   (void *_x);
+
+const char *print_s16   (void *_x);
+const char *print_u16   (void *_x);
+
+const char *print_s8    (void *_x);
+const char *print_u8    (void *_x);
+
+const char *print_f32   (void *_x);
+const char *print_f64   (void *_x);
+
+const char *print_bool  (void *_x);
+const char *print_string(void *_x);
+
+
+
+
+#define generic_to_str(x)                                                       \
+    _Generic(x,                                                                 \
+        s64: print_s64(&x),  u64: print_u64(&x),                                \
+        s32: print_s32(&x),  u32: print_u32(&x),                                \
+        s16: print_s16(&x),  u16: print_u16(&x),                                \
+        s8 : print_s8 (&x),  u8 : print_u8 (&x),                                \
+        f32: print_f32(&x),  f64: print_f64(&x),                                \
+        bool: print_bool(&x),                                                   \
+        String: print_string(&x),                                               \
+        char *: x, /* were just gonna assume this is null terminated... */      \
+        default: "?UNKNOWN_TYPE?"                                               \
+    )
+
+
+#define debug(x)  do { Typeof(x) _x = (x); printf("DEBUG: %s = %s\n", #x, generic_to_str(_x)); } while (0)
+
+#define debug_break() asm("int3")
+
+
+
+
+
+
+#endif // BESTED_H
+
+
+
+
+
+#ifdef BESTED_IMPLEMENTATION
+
+
+#include <string.h>
+#include <stdarg.h>
+#include <sched.h> // for sched_yield()
+
+
+
+// ===================================================
+//               Source Code Location
+// ===================================================
+
+bool source_code_location_eq(Source_Code_Location a, Source_Code_Location b) {
+    if (a.line != b.line) return false;
+    // this should work, the pointer would be the same.
+    if (a.file != b.file) return false;
+    // strcmp(a.file, b.file) == 0;
+    return true;
+}
+
+
+
+// ===================================================
+//        Useful Memory Manipulation Functions
+// ===================================================
+
+bool Mem_Is_Aligned(void *ptr, u64 alignment) {
+    static_assert(sizeof(u64) >= sizeof(void*), "doing math with pointers");
+    return ((u64)ptr) % alignment == 0;
+}
+
+u64 Mem_Align_Forward(u64 size, u64 alignment) {
+    return Div_Ceil(size, alignment)  * alignment;
+}
+u64 Mem_Align_Back(u64 size, u64 alignment) {
+    return Div_Floor(size, alignment) * alignment;
+}
+
+void *Mem_Byte_Offset(void *ptr, s64 bytes) {
+    u8 *ptr_u8 = (u8*)ptr;
+    return (void*)(ptr_u8 + bytes);
+}
+
+s64 Mem_Ptr_Diff(void *ptr1, void *ptr2) {
+    static_assert(sizeof(u64) >= sizeof(void*), "I HATE 128-Bit pointers");
+    u64 ptr1_u64 = Ptr_To_U64(ptr1);
+    u64 ptr2_u64 = Ptr_To_U64(ptr2);
+
+    if (ptr1_u64 >= ptr2_u64) {
+        return (s64) (ptr1_u64 - ptr2_u64);
+    } else {
+        u64 result = ptr2_u64 - ptr1_u64;
+        return -((s64) result);
+    }
+}
+
+
+void *Mem_Copy(void *dest, void *src, u64 size) {
+    return memcpy(dest, src, size);
+}
+
+void *Mem_Move(void *dest, void *src, u64 size) {
+    return memmove(dest, src, size);
+}
+
+void *Mem_Set (void *ptr, u8 value, u64 size) {
+    return memset(ptr, value, size);
+}
+
+s32 Mem_Cmp (void *ptr1, void *ptr2, u64 count) {
+    return memcmp(ptr1, ptr2, count);
+}
+
+
+
+// ===================================================
+//                      Atomics
+// ===================================================
+
+// spin for a bit, then start giving the cpu away, if theres more threads
+// than cores the one holding the lock might be waiting for our core.
+internal void RW_Lock_Backoff(u32 *spins) {
+    if (*spins < 64) {
+        *spins += 1;
+        Spin_Loop_Hint();
+    } else {
+        sched_yield();
+    }
+}
+
+void RW_Lock_Read_Lock(RW_Lock *lock) {
+    ASSERT(lock);
+    u32 spins = 0;
+    while (true) {
+        u32 current = Atomic_Load(lock);
+        if (!(current & RW_LOCK_WRITER) && Atomic_Compare_And_Exchange(lock, &current, current + 1)) return;
+        RW_Lock_Backoff(&spins);
+    }
+}
+void RW_Lock_Read_Unlock(RW_Lock *lock) {
+    ASSERT(lock);
+    u32 before = Atomic_Sub(lock, 1);
+    ASSERT((before & ~RW_LOCK_WRITER) > 0 && "unlocked a read lock that wasn't locked");
+}
+
+void RW_Lock_Write_Lock(RW_Lock *lock) {
+    ASSERT(lock);
+    // get the writer bit first, then wait for the readers to leave.
+    u32 spins = 0;
+    while (true) {
+        u32 current = Atomic_Load(lock);
+        if (!(current & RW_LOCK_WRITER) && Atomic_Compare_And_Exchange(lock, &current, current | RW_LOCK_WRITER)) break;
+        RW_Lock_Backoff(&spins);
+    }
+    while (Atomic_Load(lock) != RW_LOCK_WRITER) RW_Lock_Backoff(&spins);
+}
+void RW_Lock_Write_Unlock(RW_Lock *lock) {
+    ASSERT(lock);
+    ASSERT(Atomic_Load(lock) == RW_LOCK_WRITER && "unlocked a write lock that wasn't locked");
+    Atomic_Store(lock, 0);
+}
+
+
+
+// ===================================================
+//                      Arena
+// ===================================================
+
+internal Region *Arena_Internal_New_Region(u64 capacity_in_bytes) {
+    Region *new_region = (Region*) BESTED_MALLOC(sizeof(Region) + capacity_in_bytes);
+    if (new_region) {
+        new_region->next                = NULL;
+        new_region->count_in_bytes      = 0;
+        new_region->capacity_in_bytes   = capacity_in_bytes;
+        new_region->do_not_free_this    = false;
+    }
+    return new_region;
+}
+
+internal void Arena_Internal_Free_Region(Region *region) {
+    if (!region->do_not_free_this) BESTED_FREE(region);
+}
+
+// inline because there is really nothing in this function.
+// just some funny casts, and a call to Mem_Set()
+internal inline void *Arena_Internal_Get_New_Memory_At_Last_Region(Arena *arena, u64 size_in_bytes, u64 alignment, bool clear_to_zero) {
+    u64 aligned_ptr_u64 = Mem_Align_Forward(Ptr_To_U64(arena->last->data + arena->last->count_in_bytes), alignment);
+    // u64 aligned_ptr_u64 = Ptr_To_U64(arena->last->data + arena->last->count_in_bytes);
+
+    s64 how_far_forward = Mem_Ptr_Diff(U64_To_Ptr(aligned_ptr_u64), arena->last->data + arena->last->count_in_bytes);
+    ASSERT(how_far_forward >= 0);
+
+    // lets hope this doesn't happen.
+    if (arena->last->count_in_bytes + how_far_forward + size_in_bytes > arena->last->capacity_in_bytes) {
+        return NULL;
+    }
+
+
+    if (clear_to_zero) Mem_Zero(U64_To_Ptr(aligned_ptr_u64), size_in_bytes);
+
+    arena->last->count_in_bytes += size_in_bytes + (u64) how_far_forward;
+    ASSERT(arena->last->count_in_bytes <= arena->last->capacity_in_bytes);
+    return U64_To_Ptr(aligned_ptr_u64);
+}
+
+
+void *_Arena_Alloc(Arena *arena, u64 size_in_bytes, Arena_Alloc_Opt opt, Source_Code_Location caller_location) {
+    // TODO track allocations.
+
+    u64 default_size = (arena->minimum_allocation_size != 0) ? arena->minimum_allocation_size : ARENA_REGION_DEFAULT_CAPACITY;
+
+    // add the extra alignment because if you have to allocate the thing,
+    // the alignment of the Region is kinda random, with + alignment, the allocation will always succeed.
+    u64 to_alloc_if_no_room = Max(default_size, size_in_bytes + opt.alignment);
+
+    // if the arena currently holds no memory
+    if (arena->last == NULL) {
+        if (arena->first != NULL) {
+            ARENA_PANIC(caller_location, "arena->first != NULL, only these library functions should touch the insides of an arena.");
+            return NULL;
+        }
+
+        if (arena->panic_when_trying_to_allocate_new_page) {
+            ARENA_PANIC(caller_location, "Arena_alloc: attempted to allocate new memory, but that has been disallowed. (when there was no memory to begin with.)");
+            return NULL;
+        }
+
+        arena->last = Arena_Internal_New_Region(to_alloc_if_no_room);
+        if (arena->last == NULL) {
+            if (arena->dont_panic_when_allocation_failure) return NULL;
+            ARENA_PANIC(caller_location, "Arena_alloc: attempted to allocate new memory, got null. (when there was no memory to begin with.)");
+            return NULL;
+        }
+
+        arena->first = arena->last;
+
+        void *new_memory = Arena_Internal_Get_New_Memory_At_Last_Region(arena, size_in_bytes, opt.alignment, opt.clear_to_zero);
+        if (!new_memory) {
+            ARENA_PANIC(caller_location, "new_memory from internal allocator returned null wtf.");
+        }
+        return new_memory;
+    }
+
+    // find room, or find the end
+    while ((arena->last->count_in_bytes + size_in_bytes + opt.alignment > arena->last->capacity_in_bytes) && (arena->last->next != NULL)) {
+        arena->last = arena->last->next;
+        if (arena->last) {
+            // if we just discoverd this, it must be zero'd.
+            // this helps with our mark implementation as well.
+            arena->last->count_in_bytes = 0;
+        }
+    }
+
+    if (arena->last->count_in_bytes + size_in_bytes + opt.alignment <= arena->last->capacity_in_bytes) {
+        // if there is space alloc
+        void *new_memory = Arena_Internal_Get_New_Memory_At_Last_Region(arena, size_in_bytes, opt.alignment, opt.clear_to_zero);
+        if (!new_memory) {
+            ARENA_PANIC(caller_location, "new_memory from internal allocator returned null wtf.");
+        }
+        return new_memory;
+
+    } else {
+        // we need a new region
+
+        if (arena->last->next != NULL) {
+            ARENA_PANIC(caller_location, "arena->last->next != NULL, only these library functions should touch the insides of an arena, and they should never produce this state.");
+            return NULL;
+        }
+
+        if (arena->panic_when_trying_to_allocate_new_page) {
+            ARENA_PANIC(caller_location, "Arena_alloc: attempted to allocate new memory, but that has been disallowed.");
+            return NULL;
+        }
+
+        Region *last_last = arena->last;
+
+        arena->last = Arena_Internal_New_Region(to_alloc_if_no_room);
+        if (arena->last == NULL) {
+            if (arena->dont_panic_when_allocation_failure) return NULL;
+            ARENA_PANIC(caller_location, "Arena_alloc: attempted to allocate new memory, got null.");
+        }
+        last_last->next = arena->last;
+
+
+        void *new_memory = Arena_Internal_Get_New_Memory_At_Last_Region(arena, size_in_bytes, opt.alignment, opt.clear_to_zero);
+        if (!new_memory) {
+            ARENA_PANIC(caller_location, "new_memory from internal allocator returned null wtf.");
+        }
+        return new_memory;
+    }
+}
+
+
+
+Arena_Mark Arena_Get_Mark(Arena *arena) {
+    Arena_Mark result = {
+        .last = arena->last,
+        .count = arena->last ? arena->last->count_in_bytes : 0,
+    };
+    return result;
+}
+void Arena_Set_To_Mark(Arena *arena, Arena_Mark mark) {
+    arena->last = mark.last ? mark.last : arena->first;
+    if (arena->last) {
+        arena->last->count_in_bytes = mark.count;
+    }
+}
+
+
+void _Arena_Initialize_First_Page(Arena *arena, u64 first_page_size_in_bytes, Source_Code_Location caller_location) {
+    if (arena->first != NULL) return;
+
+    u64 tmp_min_alloc_size = arena->minimum_allocation_size;
+    arena->minimum_allocation_size = first_page_size_in_bytes;
+
+    _Arena_Alloc(
+        arena, 0,
+        (Arena_Alloc_Opt){.alignment = Default_Alignment, .clear_to_zero = false, },
+        caller_location
+    );
+
+    arena->minimum_allocation_size = tmp_min_alloc_size;
+}
+
+
+void _Arena_Add_Buffer_As_Storage_Space(Arena *arena, void *buffer, u64 buffer_size_in_bytes, Source_Code_Location caller_location) {
+    if (buffer == NULL) {
+        ARENA_PANIC(caller_location, "Arena_Add_Buffer_As_Storeage_Space: buffer != NULL, why did you pass this to us.");
+        return;
+    }
+    if (buffer_size_in_bytes <= sizeof(Region)) {
+        ARENA_PANIC(caller_location, "Arena_Add_Buffer_As_Storeage_Space: buffer_size_in_bytes <= sizeof(Region), The passed in buffer must be big enough to contain the Region, preferably much bigger");
+        return;
+    }
+
+    u64 real_allocatable_space = buffer_size_in_bytes - sizeof(Region);
+
+    Region *new_region = (Region*) buffer;
+    new_region->count_in_bytes      = 0;
+    new_region->capacity_in_bytes   = real_allocatable_space;
+    new_region->next                = NULL;
+    new_region->do_not_free_this    = true;
+
+
+    if (arena->last == NULL) {
+        if (arena->first != NULL) {
+            ARENA_PANIC(caller_location, "Arena_Add_Buffer_As_Storeage_Space: arena->first != NULL, when arena->last == NULL, something went wrong internally");
+        }
+        arena->first = new_region;
+        arena->last  = new_region;
+
+    } else {
+        Region *p;
+        for (p = arena->last; p->next != NULL; p = p->next);
+        p->next = new_region;
+    }
+}
+
+
+const char *Arena_sprintf(Arena *arena, const char *format, ...) {
+    char *buf    = NULL;
+    u64 buf_size = 0;
+
+    if (arena->last != NULL) {
+        buf      = (char*) (arena->last->data + arena->last->count_in_bytes);
+        buf_size = arena->last->capacity_in_bytes - arena->last->count_in_bytes;
+    }
+
+    va_list args;
+
+    va_start(args, format);
+        s64 formatted_size = vsnprintf(buf, buf_size, format, args);
+    va_end(args);
+
+    if (formatted_size < 0) {
+        // TODO ? accept file and line here? i never use this function anyway...
+        ARENA_PANIC(Get_Source_Code_Location(), "Arena_sprintf: format was not successful");
+        return NULL;
+    }
+
+    // i dont know if this should be <= or just <, hmm...
+    if ((u64)formatted_size < buf_size) {
+        // the string fits!
+        // advance the count. +1 because we need the null terminator for this one.
+        arena->last->count_in_bytes += (u64)formatted_size+1;
+        return buf;
+
+
+    } else {
+        // else we need to allocate some space.
+
+        buf      = (char*)Arena_Alloc(arena, (u64)formatted_size+1, .clear_to_zero = false);
+        // buf      = (char*)Arena_Alloc_Clear(arena, (u64)formatted_size+1, false);
+        buf_size = (u64)formatted_size+1;
+
+        // only happens when Arena_Alloc either returns null because it was
+        // allowed to return null, or it panic'd (and the panic function was
+        // replaced with something that doesn't abort), either way the user
+        // of this function will expect this to maybe be null.
+        if (!buf) return NULL;
+
+        va_start(args, format);
+            vsnprintf(buf, buf_size, format, args);
+        va_end(args);
+
+        return buf;
+    }
+}
+
+
+void Arena_Clear(Arena *arena) {
+    if (arena->first == NULL) return;
+
+    for (Region *r = arena->first; r != arena->last; r = r->next) {
+        r->count_in_bytes = 0;
+    }
+    arena->last->count_in_bytes = 0;
+
+    arena->last = arena->first;
+}
+
+void Arena_Free (Arena *arena) {
+    // this is slightly more complicated than it would be,
+    // but you cant use the thing you just free'd, for some reason,
+    // because it get's messed with by 'free'
+    Region *r = arena->first;
+    while (r) {
+        Region *next = r->next;
+        Arena_Internal_Free_Region(r);
+        r = next;
+    }
+
+    arena->first = NULL;
+    arena->last  = NULL;
+}
+
+
+
+// ===================================================
+//                      Pool
+// ===================================================
+
+Arena *Pool_Get(Arena_Pool *pool) {
+    while (true) {
+        for (u32 i = 0; i < NUM_POOL_ARENAS; i++) {
+            if (Has_Bit(Atomic_Load(&pool->in_use_flags), i)) continue;
+
+            Pool_Flag_Type before = Atomic_Or(&pool->in_use_flags, Bit(i));
+            if (Has_Bit(before, i)) continue; // someone got to it first,
+
+            Arena *new_arena = &pool->arena_pool[i];
+            Arena_Clear(new_arena);
+            return new_arena;
+        }
+
+        Atomic(bool) *lock = &pool->creating_new_pool_in_chain_lock;
+        Atomic_Capture_Lock(lock) {
+            if (!pool->next_pool) {
+                pool->next_pool = (Arena_Pool*)BESTED_MALLOC(sizeof(Arena_Pool));
+                Mem_Zero(pool->next_pool, sizeof(Arena_Pool));
+            }
+            pool = pool->next_pool;
+        }
+    }
+
+    UNREACHABLE();
+}
+
+void Pool_Release(Arena_Pool *pool, Arena *to_release) {
+    while (pool) {
+        s64 maybe_index = Mem_Ptr_Diff(to_release, pool->arena_pool);
+
+        if (Is_Between(maybe_index, 0, (s64) ((NUM_POOL_ARENAS-1) * sizeof(Arena)))) {
+            ASSERT(maybe_index % sizeof(Arena) == 0);
+            s64 index = maybe_index / sizeof(Arena);
+
+            ASSERT(Has_Bit( Atomic_Load(&pool->in_use_flags) , index));
+            Atomic_Xor(&pool->in_use_flags, Bit(index)); // clear the flag atomically.
+            return;
+        }
+
+        Atomic(bool) *lock = &pool->creating_new_pool_in_chain_lock;
+        Atomic_Capture_Lock(lock) {
+            pool = pool->next_pool;
+        }
+    }
+    // Ran out of pools to check, to_release must not be an arena from this pool.
+    UNREACHABLE();
+}
+
+void Pool_Free_Arenas(Arena_Pool *pool) {
+    // the user just passed up the original pool.
+    // dont free it, but free everything else
+
+    Arena_Pool *original_pool = pool;
+
+    // free all the arena's.
+    while (pool) {
+        for (u32 i = 0; i < NUM_POOL_ARENAS; i++) {
+            Arena_Free(&pool->arena_pool[i]);
+        }
+        pool = pool->next_pool;
+    }
+
+    // free the pointers to the pools.
+    pool = original_pool->next_pool;
+    while (pool) {
+        Arena_Pool *next_pool = pool->next_pool;
+        BESTED_FREE(pool);
+        pool = next_pool;
+    }
+
+    // clear this entire struct, make ready to use again,
+    // it should be ready to use again
+    //
+    // removes settings from all arena's
+    //
+    // probably should change this behaviour if pool ever gets
+    // any settings, like the arena has
+    Mem_Zero_Struct(original_pool);
+}
+
+
+
+// ===================================================
+//                Dynamic Arrays
+// ===================================================
+
+#if ARRAY_USE_MREMAP
+    #include <sys/mman.h>
+    #include <unistd.h>
+
+    // only declared with _GNU_SOURCE, and we probably
+    // weren't the first ones to include a system header.
+    #ifndef MREMAP_MAYMOVE
+        #define MREMAP_MAYMOVE 1
+        extern void *mremap(void *old_address, size_t old_size, size_t new_size, int flags, ...);
+    #endif
+
+internal u64 Array_Internal_Page_Size(void) {
+    local_persist u64 page_size = 0;
+    if (page_size == 0) page_size = (u64) sysconf(_SC_PAGESIZE);
+    return page_size;
+}
+
+// returns NULL if the kernel said no.
+internal void *Array_Internal_Grow_Memory_Mapped(void *old_items, u64 old_size_in_bytes, u64 used_size_in_bytes, u64 new_size_in_bytes) {
+    u64 page_size = Array_Internal_Page_Size();
+    new_size_in_bytes = Mem_Align_Forward(new_size_in_bytes, page_size);
+
+    // allready mapped, let the kernel move the pages, no copying.
+    if (old_items && old_size_in_bytes >= ARRAY_MREMAP_THRESHOLD) {
+        void *result = mremap(old_items, Mem_Align_Forward(old_size_in_bytes, page_size), new_size_in_bytes, MREMAP_MAYMOVE);
+        return (result == MAP_FAILED) ? NULL : result;
+    }
+
+    // crossing the threshold, this is the last time this array gets copied.
+    void *result = mmap(NULL, new_size_in_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (result == MAP_FAILED) return NULL;
+
+    if (used_size_in_bytes > 0) Mem_Copy(result, old_items, used_size_in_bytes);
+    BESTED_FREE(old_items);
+    return result;
+}
+#endif // ARRAY_USE_MREMAP
+
+void Array_Free_Items(void *items, u64 capacity_in_bytes) {
+#if ARRAY_USE_MREMAP
+    if (items && capacity_in_bytes >= ARRAY_MREMAP_THRESHOLD) {
+        munmap(items, Mem_Align_Forward(capacity_in_bytes, Array_Internal_Page_Size()));
+        return;
+    }
+#else
+    (void) capacity_in_bytes;
+#endif
+    BESTED_FREE(items);
+}
+
+
+void Array_Maybe_Grow(Generic_Array *array, Array_Item_Type_Properties_Struct item_properties, u64 new_count, bool clear_to_zero, Source_Code_Location caller_location) {
+    ASSERT(array); // would be kinda weird.
+
+    // if the new count is less, we dont need to do anything. not even clear anything.
+    if (new_count <= array->count) return;
+
+    if (new_count > array->capacity) {
+        u64 old_capacity = array->capacity;
+
+        array->capacity = array->capacity ? array->capacity * 2 : ARRAY_INITAL_CAPACITY;
+        while (array->capacity < new_count) array->capacity *= 2;
+
+        void *new_array = NULL;
+        if (array->allocator) {
+
+            // special case where the last thing to allocate was this current array,
+            // in this case we dont need to do any Mem_Copy, just advance the count_in_bytes.
+            if (array->allocator->last) {
+                bool last_allocation_was_this_array = (array->allocator->last->data + array->allocator->last->count_in_bytes) - (array->count * item_properties.item_size) == array->items;
+                if (last_allocation_was_this_array) {
+                    u64 number_of_new_elements = array->capacity - array->count;
+                    u64 new_amount_to_allocate = number_of_new_elements * item_properties.item_size;
+                    bool new_array_can_fit_into_current_region = array->allocator->last->count_in_bytes + new_amount_to_allocate <= array->allocator->last->capacity_in_bytes;
+
+                    if (new_array_can_fit_into_current_region) {
+                        // TODO maybe call this function, this is some dangerous manipulation.
+                        // Arena_Alloc(array->allocator, new_amount_to_allocate);
+                        array->allocator->last->count_in_bytes += new_amount_to_allocate;
+                        goto skip_allocation;
+                    }
+                }
+            }
+
+            // need to do this, need to set file and line properly.
+            //
+            // void *_Arena_Alloc(Arena *arena, u64 size_in_bytes, Arena_Alloc_Opt opt, const char *file, s32 line);
+            new_array = _Arena_Alloc(
+                array->allocator, item_properties.item_size * array->capacity,
+                (Arena_Alloc_Opt){.alignment = item_properties.item_align, .clear_to_zero = false, },
+                caller_location
+            );
+        } else {
+#if ARRAY_USE_MREMAP
+            if (item_properties.item_size * array->capacity >= ARRAY_MREMAP_THRESHOLD) {
+                new_array = Array_Internal_Grow_Memory_Mapped(
+                    array->items,
+                    item_properties.item_size * old_capacity,
+                    item_properties.item_size * array->count,
+                    item_properties.item_size * array->capacity
+                );
+                if (new_array == NULL) {
+                    PANIC(SCL_Fmt" got null when trying to grow memory mapped array", SCL_Arg(caller_location));
+                }
+
+                // the old items are allready in there.
+                array->items = new_array;
+                goto skip_allocation;
+            }
+#endif
+            new_array = BESTED_ALIGNED_ALLOC(item_properties.item_align, item_properties.item_size * array->capacity);
+        }
+
+        // malloc may return null, or the arena can be set
+        // to return NULL instead of panic'ing for an allocation.
+        //
+        // no nice way to handle this, and this situation
+        // is so rare, I dont care about it.
+        //
+        // eat this panic.
+        if (new_array == NULL) {
+            PANIC(SCL_Fmt" got null when trying to grow array", SCL_Arg(caller_location));
+        }
+
+        Mem_Copy(new_array, array->items, item_properties.item_size * array->count);
+
+        if (!array->allocator) Array_Free_Items(array->items, item_properties.item_size * old_capacity);
+        array->items = new_array;
+    }
+
+skip_allocation:
+    if (clear_to_zero) {
+        u64 new_to_add = new_count - array->count;
+        Mem_Zero((u8*)array->items + (item_properties.item_size * array->count), item_properties.item_size * new_to_add);
+    }
+}
+
+
+void Array_Shift(Generic_Array *array, Array_Item_Type_Properties_Struct item_properties, u64 from_index) {
+    ASSERT(array); // would be kinda weird.
+
+    Mem_Move(array->items, (u8*)array->items + from_index, (array->count - from_index) * item_properties.item_size);
+    array->count -= from_index;
+}
+
+
+// ===================================================
+//                 Array Retain Where
+// ===================================================
+
+#if defined(__SSSE3__)
+    #include <tmmintrin.h>
+#endif
+
+// entry 'mask' has the index of every set bit in 'mask', one byte each, lowest first.
+global_variable const u64 Array_Internal_Compact_Table[256] = {
+    0x0000000000000000ULL, 0x0000000000000000ULL, 0x0000000000000001ULL, 0x0000000000000100ULL,
+    0x0000000000000002ULL, 0x0000000000000200ULL, 0x0000000000000201ULL, 0x0000000000020100ULL,
+    0x0000000000000003ULL, 0x0000000000000300ULL, 0x0000000000000301ULL, 0x0000000000030100ULL,
+    0x0000000000000302ULL, 0x0000000000030200ULL, 0x0000000000030201ULL, 0x0000000003020100ULL,
+    0x0000000000000004ULL, 0x0000000000000400ULL, 0x0000000000000401ULL, 0x0000000000040100ULL,
+    0x0000000000000402ULL, 0x0000000000040200ULL, 0x0000000000040201ULL, 0x0000000004020100ULL,
+    0x0000000000000403ULL, 0x0000000000040300ULL, 0x0000000000040301ULL, 0x0000000004030100ULL,
+    0x0000000000040302ULL, 0x0000000004030200ULL, 0x0000000004030201ULL, 0x0000000403020100ULL,
+    0x0000000000000005ULL, 0x0000000000000500ULL, 0x0000000000000501ULL, 0x0000000000050100ULL,
+    0x0000000000000502ULL, 0x0000000000050200ULL, 0x0000000000050201ULL, 0x0000000005020100ULL,
+    0x0000000000000503ULL, 0x0000000000050300ULL, 0x0000000000050301ULL, 0x0000000005030100ULL,
+    0x0000000000050302ULL, 0x0000000005030200ULL, 0x0000000005030201ULL, 0x0000000503020100ULL,
+    0x0000000000000504ULL, 0x0000000000050400ULL, 0x0000000000050401ULL, 0x0000000005040100ULL,
+    0x0000000000050402ULL, 0x0000000005040200ULL, 0x0000000005040201ULL, 0x0000000504020100ULL,
+    0x0000000000050403ULL, 0x0000000005040300ULL, 0x0000000005040301ULL, 0x0000000504030100ULL,
+    0x0000000005040302ULL, 0x0000000504030200ULL, 0x0000000504030201ULL, 0x0000050403020100ULL,
+    0x0000000000000006ULL, 0x0000000000000600ULL, 0x0000000000000601ULL, 0x0000000000060100ULL,
+    0x0000000000000602ULL, 0x0000000000060200ULL, 0x0000000000060201ULL, 0x0000000006020100ULL,
+    0x0000000000000603ULL, 0x0000000000060300ULL, 0x0000000000060301ULL, 0x0000000006030100ULL,
+    0x0000000000060302ULL, 0x0000000006030200ULL, 0x0000000006030201ULL, 0x0000000603020100ULL,
+    0x0000000000000604ULL, 0x0000000000060400ULL, 0x0000000000060401ULL, 0x0000000006040100ULL,
+    0x0000000000060402ULL, 0x0000000006040200ULL, 0x0000000006040201ULL, 0x0000000604020100ULL,
+    0x0000000000060403ULL, 0x0000000006040300ULL, 0x0000000006040301ULL, 0x0000000604030100ULL,
+    0x0000000006040302ULL, 0x0000000604030200ULL, 0x0000000604030201ULL, 0x0000060403020100ULL,
+    0x0000000000000605ULL, 0x0000000000060500ULL, 0x0000000000060501ULL, 0x0000000006050100ULL,
+    0x0000000000060502ULL, 0x0000000006050200ULL, 0x0000000006050201ULL, 0x0000000605020100ULL,
+    0x0000000000060503ULL, 0x0000000006050300ULL, 0x0000000006050301ULL, 0x0000000605030100ULL,
+    0x0000000006050302ULL, 0x0000000605030200ULL, 0x0000000605030201ULL, 0x0000060503020100ULL,
+    0x0000000000060504ULL, 0x0000000006050400ULL, 0x0000000006050401ULL, 0x0000000605040100ULL,
+    0x0000000006050402ULL, 0x0000000605040200ULL, 0x0000000605040201ULL, 0x0000060504020100ULL,
+    0x0000000006050403ULL, 0x0000000605040300ULL, 0x0000000605040301ULL, 0x0000060504030100ULL,
+    0x0000000605040302ULL, 0x0000060504030200ULL, 0x0000060504030201ULL, 0x0006050403020100ULL,
+    0x0000000000000007ULL, 0x0000000000000700ULL, 0x0000000000000701ULL, 0x0000000000070100ULL,
+    0x0000000000000702ULL, 0x0000000000070200ULL, 0x0000000000070201ULL, 0x0000000007020100ULL,
+    0x0000000000000703ULL, 0x0000000000070300ULL, 0x0000000000070301ULL, 0x0000000007030100ULL,
+    0x0000000000070302ULL, 0x0000000007030200ULL, 0x0000000007030201ULL, 0x0000000703020100ULL,
+    0x0000000000000704ULL, 0x0000000000070400ULL, 0x0000000000070401ULL, 0x0000000007040100ULL,
+    0x0000000000070402ULL, 0x0000000007040200ULL, 0x0000000007040201ULL, 0x0000000704020100ULL,
+    0x0000000000070403ULL, 0x0000000007040300ULL, 0x0000000007040301ULL, 0x0000000704030100ULL,
+    0x0000000007040302ULL, 0x0000000704030200ULL, 0x0000000704030201ULL, 0x0000070403020100ULL,
+    0x0000000000000705ULL, 0x0000000000070500ULL, 0x0000000000070501ULL, 0x0000000007050100ULL,
+    0x0000000000070502ULL, 0x0000000007050200ULL, 0x0000000007050201ULL, 0x0000000705020100ULL,
+    0x0000000000070503ULL, 0x0000000007050300ULL, 0x0000000007050301ULL, 0x0000000705030100ULL,
+    0x0000000007050302ULL, 0x0000000705030200ULL, 0x0000000705030201ULL, 0x0000070503020100ULL,
+    0x0000000000070504ULL, 0x0000000007050400ULL, 0x0000000007050401ULL, 0x0000000705040100ULL,
+    0x0000000007050402ULL, 0x0000000705040200ULL, 0x0000000705040201ULL, 0x0000070504020100ULL,
+    0x0000000007050403ULL, 0x0000000705040300ULL, 0x0000000705040301ULL, 0x0000070504030100ULL,
+    0x0000000705040302ULL, 0x0000070504030200ULL, 0x0000070504030201ULL, 0x0007050403020100ULL,
+    0x0000000000000706ULL, 0x0000000000070600ULL, 0x0000000000070601ULL, 0x0000000007060100ULL,
+    0x0000000000070602ULL, 0x0000000007060200ULL, 0x0000000007060201ULL, 0x0000000706020100ULL,
+    0x0000000000070603ULL, 0x0000000007060300ULL, 0x0000000007060301ULL, 0x0000000706030100ULL,
+    0x0000000007060302ULL, 0x0000000706030200ULL, 0x0000000706030201ULL, 0x0000070603020100ULL,
+    0x0000000000070604ULL, 0x0000000007060400ULL, 0x0000000007060401ULL, 0x0000000706040100ULL,
+    0x0000000007060402ULL, 0x0000000706040200ULL, 0x0000000706040201ULL, 0x0000070604020100ULL,
+    0x0000000007060403ULL, 0x0000000706040300ULL, 0x0000000706040301ULL, 0x0000070604030100ULL,
+    0x0000000706040302ULL, 0x0000070604030200ULL, 0x0000070604030201ULL, 0x0007060403020100ULL,
+    0x0000000000070605ULL, 0x0000000007060500ULL, 0x0000000007060501ULL, 0x0000000706050100ULL,
+    0x0000000007060502ULL, 0x0000000706050200ULL, 0x0000000706050201ULL, 0x0000070605020100ULL,
+    0x0000000007060503ULL, 0x0000000706050300ULL, 0x0000000706050301ULL, 0x0000070605030100ULL,
+    0x0000000706050302ULL, 0x0000070605030200ULL, 0x0000070605030201ULL, 0x0007060503020100ULL,
+    0x0000000007060504ULL, 0x0000000706050400ULL, 0x0000000706050401ULL, 0x0000070605040100ULL,
+    0x0000000706050402ULL, 0x0000070605040200ULL, 0x0000070605040201ULL, 0x0007060504020100ULL,
+    0x0000000706050403ULL, 0x0000070605040300ULL, 0x0000070605040301ULL, 0x0007060504030100ULL,
+    0x0000070605040302ULL, 0x0007060504030200ULL, 0x0007060504030201ULL, 0x0706050403020100ULL,
+};
+
+#define Array_Internal_Keep(op, a, b)                                                       \
+    ((op) == Array_Keep_Equal   ? (a) == (b) : (op) == Array_Keep_Not_Equal  ? (a) != (b) : \
+     (op) == Array_Keep_Less    ? (a) <  (b) : (op) == Array_Keep_Less_Equal ? (a) <= (b) : \
+     (op) == Array_Keep_Greater ? (a) >  (b) :                                 (a) >= (b))
+
+// one at a time, for the last few, u64's, or no SSE2. same as Array_Retain().
+#define Array_Internal_Retain_Where_Loop(Type, OP)                                          \
+    for (; read < count; read++) {                                                          \
+        Type item = ((Type*)items)[read];                                                   \
+        ((Type*)items)[write] = item;                                                       \
+        write += item OP (Type)scalar;                                                      \
+    }
+// (a loop per op, so the compare isn't looked up every item.)
+#define Array_Internal_Retain_Where_Scalar(Type)                                            \
+    do {                                                                                    \
+        switch (op) {                                                                       \
+            case Array_Keep_Equal:         Array_Internal_Retain_Where_Loop(Type, ==); break; \
+            case Array_Keep_Not_Equal:     Array_Internal_Retain_Where_Loop(Type, !=); break; \
+            case Array_Keep_Less:          Array_Internal_Retain_Where_Loop(Type, < ); break; \
+            case Array_Keep_Less_Equal:    Array_Internal_Retain_Where_Loop(Type, <=); break; \
+            case Array_Keep_Greater:       Array_Internal_Retain_Where_Loop(Type, > ); break; \
+            case Array_Keep_Greater_Equal: Array_Internal_Retain_Where_Loop(Type, >=); break; \
+        }                                                                                   \
+    } while (0)
+
+// how many bits are set in a byte, (__builtin_popcount() is a function call without -mpopcnt).
+internal inline u32 Array_Internal_Count_Bits(u32 byte) {
+    byte = byte - ((byte >> 1) & 0x55);
+    byte = (byte & 0x33) + ((byte >> 2) & 0x33);
+    return (byte + (byte >> 4)) & 0x0F;
+}
+
+#if defined(__SSE2__)
+
+// 'item_size' is allways a constant, so all the switches fold away.
+__attribute__((always_inline))
+internal inline u64 Array_Internal_Retain_Where_Lanes(u8 *items, u64 count, u64 *read_out, const u64 item_size, bool is_signed, Array_Keep_Op op, u64 scalar) {
+    const u64 items_per_lane = 16 / item_size;
+    const u32 full_mask      = (1u << items_per_lane) - 1;
+
+    // the compares are signed, so flip the top bit of both sides for unsigned ones.
+    __m128i flip, value;
+    switch (item_size) {
+        case 1:  flip = _mm_set1_epi8 (is_signed ? 0 : (char) 0x80);       value = _mm_set1_epi8 ((char)scalar);  break;
+        case 2:  flip = _mm_set1_epi16(is_signed ? 0 : (short)0x8000);     value = _mm_set1_epi16((short)scalar); break;
+        default: flip = _mm_set1_epi32(is_signed ? 0 : (int)  0x80000000); value = _mm_set1_epi32((int)scalar);   break;
+    }
+    value = _mm_xor_si128(value, flip);
+
+    // everything is an equal or a greater than, maybe backwards, maybe flipped.
+    bool    use_equal = (op == Array_Keep_Equal || op == Array_Keep_Not_Equal);
+    bool    backwards = (op == Array_Keep_Less  || op == Array_Keep_Greater_Equal);
+    __m128i invert    = (op == Array_Keep_Not_Equal || op == Array_Keep_Less_Equal || op == Array_Keep_Greater_Equal) ? _mm_set1_epi8(-1) : _mm_setzero_si128();
+
+    u64 read = 0, write = 0;
+    for (; read + items_per_lane <= count; read += items_per_lane) {
+        __m128i lane = _mm_loadu_si128((__m128i*)(items + read * item_size));
+        __m128i x    = _mm_xor_si128(lane, flip);
+        __m128i a    = backwards ? value : x;
+        __m128i b    = backwards ? x : value;
+
+        __m128i keep;
+        switch (item_size) {
+            case 1:  keep = use_equal ? _mm_cmpeq_epi8 (x, value) : _mm_cmpgt_epi8 (a, b); break;
+            case 2:  keep = use_equal ? _mm_cmpeq_epi16(x, value) : _mm_cmpgt_epi16(a, b); break;
+            default: keep = use_equal ? _mm_cmpeq_epi32(x, value) : _mm_cmpgt_epi32(a, b); break;
+        }
+        keep = _mm_xor_si128(keep, invert);
+
+        // one bit per item.
+        u32 mask;
+        switch (item_size) {
+            case 1:  mask = (u32)_mm_movemask_epi8(keep);                                    break;
+            case 2:  mask = (u32)_mm_movemask_epi8(_mm_packs_epi16(keep, _mm_setzero_si128())); break;
+            default: mask = (u32)_mm_movemask_ps(_mm_castsi128_ps(keep));                     break;
+        }
+
+        // write is never past read, so storing a whole lane only ever hits things allready read.
+        if (mask == full_mask) {
+            _mm_storeu_si128((__m128i*)(items + write * item_size), lane);
+            write += items_per_lane;
+            continue;
+        }
+        if (mask == 0) continue;
+
+#if defined(__SSSE3__)
+        // 8 items at a time, (only the 1 byte ones have more than that in a lane).
+        for (u64 half = 0; half < items_per_lane; half += 8) {
+            u32 half_mask = (mask >> half) & 0xFF;
+
+            // turn the item indexes into byte indexes, then one shuffle packs them.
+            __m128i control = _mm_loadl_epi64((__m128i*)&Array_Internal_Compact_Table[half_mask]);
+            switch (item_size) {
+                case 1:  break;
+                case 2:
+                    control = _mm_unpacklo_epi8(control, control);
+                    control = _mm_add_epi8(_mm_add_epi8(control, control), _mm_set1_epi16(0x0100));
+                    break;
+                default:
+                    control = _mm_unpacklo_epi8(control, control);
+                    control = _mm_unpacklo_epi16(control, control);
+                    control = _mm_add_epi8(control, control);
+                    control = _mm_add_epi8(control, control);
+                    control = _mm_add_epi8(control, _mm_set1_epi32(0x03020100));
+                    break;
+            }
+            __m128i packed = _mm_shuffle_epi8(half ? _mm_srli_si128(lane, 8) : lane, control);
+            if (item_size == 1) {
+                _mm_storel_epi64((__m128i*)(items + write), packed);
+            } else {
+                _mm_storeu_si128((__m128i*)(items + write * item_size), packed);
+            }
+            write += Array_Internal_Count_Bits(half_mask);
+        }
+#else
+        // no shuffle, (only 4 byte items get here), so its Array_Retain() with the mask,
+        // straight out of the register. (a loop over the table would change length every lane, and mispredict.)
+        for (u32 i = 0; i < 4; i++) {
+            ((u32*)items)[write] = (u32)_mm_cvtsi128_si32(lane);
+            lane   = _mm_srli_si128(lane, 4);
+            write += (mask >> i) & 1;
+        }
+#endif
+    }
+
+    *read_out = read;
+    return write;
+}
+
+#endif // __SSE2__
+
+u64 Array_Retain_Where_Generic(void *items, u64 count, u64 item_size, bool is_signed, Array_Keep_Op op, u64 scalar) {
+    ASSERT(item_size == 1 || item_size == 2 || item_size == 4 || item_size == 8);
+    if (count == 0) return 0;
+    ASSERT(items);
+
+    u64 read = 0, write = 0;
+#if defined(__SSE2__)
+    switch (item_size) {
+    #if defined(__SSSE3__)
+        // without a shuffle, packing 16 or 8 of these one at a time is slower than just Array_Retain().
+        case 1: write = Array_Internal_Retain_Where_Lanes(items, count, &read, 1, is_signed, op, scalar); break;
+        case 2: write = Array_Internal_Retain_Where_Lanes(items, count, &read, 2, is_signed, op, scalar); break;
+    #endif
+        case 4: write = Array_Internal_Retain_Where_Lanes(items, count, &read, 4, is_signed, op, scalar); break;
+    }
+#endif
+
+    // the rest, one at a time, (or everything, for 8 byte items).
+    s32 kind = is_signed ? -(s32)item_size : (s32)item_size;
+    switch (kind) {
+        case  1: Array_Internal_Retain_Where_Scalar(u8);  break;
+        case  2: Array_Internal_Retain_Where_Scalar(u16); break;
+        case  4: Array_Internal_Retain_Where_Scalar(u32); break;
+        case  8: Array_Internal_Retain_Where_Scalar(u64); break;
+        case -1: Array_Internal_Retain_Where_Scalar(s8);  break;
+        case -2: Array_Internal_Retain_Where_Scalar(s16); break;
+        case -4: Array_Internal_Retain_Where_Scalar(s32); break;
+        case -8: Array_Internal_Retain_Where_Scalar(s64); break;
+    }
+    return write;
+}
+
+
+
+// ===================================================
+//                Structure Of Arrays
+// ===================================================
+
+void SoA_Maybe_Grow(Generic_SoA *soa, Array_Item_Type_Properties_Struct *columns, u64 column_count, u64 new_count, bool clear_to_zero, Source_Code_Location caller_location) {
+    ASSERT(soa);
+    ASSERT(columns && column_count > 0);
+
+    // same as Array_Maybe_Grow(), nothing to do, not even clear anything.
+    if (new_count <= soa->count) return;
+
+    if (new_count > soa->capacity) {
+        u64 new_capacity = soa->capacity ? soa->capacity * 2 : ARRAY_INITAL_CAPACITY;
+        while (new_capacity < new_count) new_capacity *= 2;
+
+        // all the columns go into one block, one after the other,
+        // each one aligned for its own type.
+        u64 block_size      = 0;
+        u64 block_alignment = 1;
+        for (u64 i = 0; i < column_count; i++) {
+            block_size      = Mem_Align_Forward(block_size, columns[i].item_align) + columns[i].item_size * new_capacity;
+            block_alignment = Max(block_alignment, columns[i].item_align);
+        }
+
+        void *block = NULL;
+        if (soa->allocator) {
+            block = _Arena_Alloc(
+                soa->allocator, block_size,
+                (Arena_Alloc_Opt){.alignment = block_alignment, .clear_to_zero = false, },
+                caller_location
+            );
+        } else {
+            // aligned_alloc() wants the size to be a multiple of the alignment.
+            block = BESTED_ALIGNED_ALLOC(block_alignment, Mem_Align_Forward(block_size, block_alignment));
+        }
+
+        // same deal as Array_Maybe_Grow(), eat this panic.
+        if (block == NULL) {
+            PANIC(SCL_Fmt" got null when trying to grow structure of arrays", SCL_Arg(caller_location));
+        }
+
+        // the first column always starts at the front of the block,
+        // so thats the pointer we free.
+        void *old_block = soa->columns[0];
+
+        u64 offset = 0;
+        for (u64 i = 0; i < column_count; i++) {
+            offset = Mem_Align_Forward(offset, columns[i].item_align);
+
+            void *new_column = (u8*)block + offset;
+            if (soa->count > 0) Mem_Copy(new_column, soa->columns[i], columns[i].item_size * soa->count);
+            soa->columns[i] = new_column;
+
+            offset += columns[i].item_size * new_capacity;
+        }
+
+        if (!soa->allocator) BESTED_FREE(old_block);
+        soa->capacity = new_capacity;
+    }
+
+    if (clear_to_zero) {
+        u64 new_to_add = new_count - soa->count;
+        for (u64 i = 0; i < column_count; i++) {
+            Mem_Zero((u8*)soa->columns[i] + columns[i].item_size * soa->count, columns[i].item_size * new_to_add);
+        }
+    }
+}
+
+void SoA_Free(Generic_SoA *soa, u64 column_count) {
+    ASSERT(soa);
+
+    // the first column is the whole block.
+    BESTED_FREE(soa->columns[0]);
+    for (u64 i = 0; i < column_count; i++) soa->columns[i] = NULL;
+
+    soa->count    = 0;
+    soa->capacity = 0;
+}
+
+
+
+// ===================================================
+//                  Bucket Array
+// ===================================================
+
+void Bucket_Array_Maybe_Grow(Generic_Bucket_Array *array, Array_Item_Type_Properties_Struct item_properties, u64 new_count, bool clear_to_zero, Source_Code_Location caller_location) {
+    ASSERT(array);
+
+    if (new_count <= array->count) return;
+
+    const u64 N = BUCKET_ARRAY_ITEMS_PER_BUCKET;
+    u64 bucket_size_in_bytes = item_properties.item_size * N;
+
+    u64 buckets_needed = Div_Ceil(new_count, N);
+    while (array->bucket_count < buckets_needed) {
+
+        // grow the directory, only the bucket pointers get copied here.
+        if (array->bucket_count == array->buckets_capacity) {
+            u64 new_capacity = array->buckets_capacity ? array->buckets_capacity * 2 : BUCKET_ARRAY_INITAL_DIRECTORY_CAPACITY;
+            while (new_capacity < buckets_needed) new_capacity *= 2;
+
+            void **new_buckets = NULL;
+            if (array->allocator) {
+                new_buckets = _Arena_Alloc(
+                    array->allocator, new_capacity * sizeof(void*),
+                    (Arena_Alloc_Opt){.alignment = Alignof(void*), .clear_to_zero = false, },
+                    caller_location
+                );
+            } else {
+                new_buckets = BESTED_ALIGNED_ALLOC(Alignof(void*), new_capacity * sizeof(void*));
+            }
+
+            if (new_buckets == NULL) {
+                PANIC(SCL_Fmt" got null when trying to grow bucket array directory", SCL_Arg(caller_location));
+            }
+
+            if (array->bucket_count > 0) Mem_Copy(new_buckets, array->buckets, array->bucket_count * sizeof(void*));
+
+            if (!array->allocator) BESTED_FREE(array->buckets);
+            array->buckets          = new_buckets;
+            array->buckets_capacity = new_capacity;
+        }
+
+        void *new_bucket = NULL;
+        if (array->allocator) {
+            new_bucket = _Arena_Alloc(
+                array->allocator, bucket_size_in_bytes,
+                (Arena_Alloc_Opt){.alignment = item_properties.item_align, .clear_to_zero = false, },
+                caller_location
+            );
+        } else {
+            new_bucket = BESTED_ALIGNED_ALLOC(item_properties.item_align, bucket_size_in_bytes);
+        }
+
+        if (new_bucket == NULL) {
+            PANIC(SCL_Fmt" got null when trying to allocate a new bucket", SCL_Arg(caller_location));
+        }
+
+        array->buckets[array->bucket_count] = new_bucket;
+        array->bucket_count += 1;
+    }
+
+    if (clear_to_zero) {
+        // the new items might be spread over a few buckets.
+        u64 index = array->count;
+        while (index < new_count) {
+            u64 in_bucket = index % N;
+            u64 to_clear  = Min(N - in_bucket, new_count - index);
+            Mem_Zero((u8*)array->buckets[index / N] + in_bucket * item_properties.item_size, to_clear * item_properties.item_size);
+            index += to_clear;
+        }
+    }
+}
+
+void Generic_Bucket_Array_Free(Generic_Bucket_Array *array) {
+    ASSERT(array);
+
+    for (u64 i = 0; i < array->bucket_count; i++) {
+        BESTED_FREE(array->buckets[i]);
+    }
+    BESTED_FREE(array->buckets);
+
+    array->buckets          = NULL;
+    array->count            = 0;
+    array->bucket_count     = 0;
+    array->buckets_capacity = 0;
+}
+
+
+
+// ===================================================
+//              Ring Buffer / Deque
+// ===================================================
+
+// where 'n' items starting at 'start' (from the front) live in the buffer.
+internal Ring_Buffer_Spans Ring_Buffer_Internal_Get_Spans(Generic_Ring_Buffer *ring_buffer, Array_Item_Type_Properties_Struct item_properties, u64 start, u64 n) {
+    Ring_Buffer_Spans result = ZEROED;
+    if (n == 0) return result;
+
+    u64 first_index = Ring_Buffer_Index(ring_buffer, start);
+    u64 until_end   = ring_buffer->capacity - first_index;
+
+    result.first        = (u8*)ring_buffer->items + first_index * item_properties.item_size;
+    result.first_count  = Min(n, until_end);
+
+    if (result.first_count < n) {
+        result.second       = ring_buffer->items;
+        result.second_count = n - result.first_count;
+    }
+    return result;
+}
+
+void Ring_Buffer_Maybe_Grow(Generic_Ring_Buffer *ring_buffer, Array_Item_Type_Properties_Struct item_properties, u64 new_count, Source_Code_Location caller_location) {
+    ASSERT(ring_buffer);
+
+    if (new_count <= ring_buffer->capacity) return;
+
+    u64 new_capacity = ring_buffer->capacity ? ring_buffer->capacity * 2 : RING_BUFFER_INITAL_CAPACITY;
+    while (new_capacity < new_count) new_capacity *= 2;
+
+    void *new_items = NULL;
+    if (ring_buffer->allocator) {
+        new_items = _Arena_Alloc(
+            ring_buffer->allocator, item_properties.item_size * new_capacity,
+            (Arena_Alloc_Opt){.alignment = item_properties.item_align, .clear_to_zero = false, },
+            caller_location
+        );
+    } else {
+        new_items = BESTED_ALIGNED_ALLOC(item_properties.item_align, item_properties.item_size * new_capacity);
+    }
+
+    // same deal as Array_Maybe_Grow(), eat this panic.
+    if (new_items == NULL) {
+        PANIC(SCL_Fmt" got null when trying to grow ring buffer", SCL_Arg(caller_location));
+    }
+
+    // straighten it out while we copy, the front goes to index 0.
+    Ring_Buffer_Spans spans = Ring_Buffer_Internal_Get_Spans(ring_buffer, item_properties, 0, ring_buffer->count);
+    if (spans.first_count)  Mem_Copy(new_items, spans.first, spans.first_count * item_properties.item_size);
+    if (spans.second_count) Mem_Copy((u8*)new_items + spans.first_count * item_properties.item_size, spans.second, spans.second_count * item_properties.item_size);
+
+    if (!ring_buffer->allocator) BESTED_FREE(ring_buffer->items);
+
+    ring_buffer->items    = new_items;
+    ring_buffer->head     = 0;
+    ring_buffer->capacity = new_capacity;
+}
+
+Ring_Buffer_Spans Generic_Ring_Buffer_Push_Back_Many(Generic_Ring_Buffer *ring_buffer, Array_Item_Type_Properties_Struct item_properties, u64 n, Source_Code_Location caller_location) {
+    ASSERT(ring_buffer);
+
+    Ring_Buffer_Maybe_Grow(ring_buffer, item_properties, ring_buffer->count + n, caller_location);
+
+    Ring_Buffer_Spans result = Ring_Buffer_Internal_Get_Spans(ring_buffer, item_properties, ring_buffer->count, n);
+    ring_buffer->count += n;
+    return result;
+}
+
+Ring_Buffer_Spans Generic_Ring_Buffer_Pop_Front_Many(Generic_Ring_Buffer *ring_buffer, Array_Item_Type_Properties_Struct item_properties, u64 n) {
+    ASSERT(ring_buffer);
+
+    n = Min(n, ring_buffer->count);
+
+    Ring_Buffer_Spans result = Ring_Buffer_Internal_Get_Spans(ring_buffer, item_properties, 0, n);
+    // the memory is still there, until someone pushes over it.
+    if (n > 0) ring_buffer->head = Ring_Buffer_Index(ring_buffer, n);
+    ring_buffer->count -= n;
+    return result;
+}
+
+void Generic_Ring_Buffer_Free(Generic_Ring_Buffer *ring_buffer) {
+    ASSERT(ring_buffer);
+
+    BESTED_FREE(ring_buffer->items);
+    ring_buffer->items    = NULL;
+    ring_buffer->head     = 0;
+    ring_buffer->count    = 0;
+    ring_buffer->capacity = 0;
+}
+
+
+
+// ===================================================
+//                      Bitset
+// ===================================================
+
+// the widest thing we can do the bulk operations with.
+#if defined(__AVX2__)
+    #include <immintrin.h>
+
+    #define BITSET_WORDS_PER_LANE               4
+    typedef __m256i Bitset_Lane;
+    #define Bitset_Lane_Load(ptr)               _mm256_loadu_si256((Bitset_Lane*)(ptr))
+    #define Bitset_Lane_Store(ptr, lane)        _mm256_storeu_si256((Bitset_Lane*)(ptr), (lane))
+    #define Bitset_Lane_And(a, b)               _mm256_and_si256((a), (b))
+    #define Bitset_Lane_Or(a, b)                _mm256_or_si256((a), (b))
+    #define Bitset_Lane_Xor(a, b)               _mm256_xor_si256((a), (b))
+    // yes, intel's andnot flips the first argument.
+    #define Bitset_Lane_And_Not(a, b)           _mm256_andnot_si256((b), (a))
+    #define Bitset_Lane_Is_Zero(a)              _mm256_testz_si256((a), (a))
+
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+
+    #define BITSET_WORDS_PER_LANE               2
+    typedef __m128i Bitset_Lane;
+    #define Bitset_Lane_Load(ptr)               _mm_loadu_si128((Bitset_Lane*)(ptr))
+    #define Bitset_Lane_Store(ptr, lane)        _mm_storeu_si128((Bitset_Lane*)(ptr), (lane))
+    #define Bitset_Lane_And(a, b)               _mm_and_si128((a), (b))
+    #define Bitset_Lane_Or(a, b)                _mm_or_si128((a), (b))
+    #define Bitset_Lane_Xor(a, b)               _mm_xor_si128((a), (b))
+    #define Bitset_Lane_And_Not(a, b)           _mm_andnot_si128((b), (a))
+    // no ptest without SSE4.1, so compare every byte with zero.
+    #define Bitset_Lane_Is_Zero(a)              (_mm_movemask_epi8(_mm_cmpeq_epi8((a), _mm_setzero_si128())) == 0xFFFF)
+
+#else
+    // no SIMD, just do a word at a time.
+    #define BITSET_WORDS_PER_LANE               1
+    typedef u64 Bitset_Lane;
+    #define Bitset_Lane_Load(ptr)               (*(ptr))
+    #define Bitset_Lane_Store(ptr, lane)        (*(ptr) = (lane))
+    #define Bitset_Lane_And(a, b)               ((a) &  (b))
+    #define Bitset_Lane_Or(a, b)                ((a) |  (b))
+    #define Bitset_Lane_Xor(a, b)               ((a) ^  (b))
+    #define Bitset_Lane_And_Not(a, b)           ((a) & ~(b))
+    #define Bitset_Lane_Is_Zero(a)              ((a) == 0)
+#endif
+
+
+// keeps the 'bits past count are 0' promise.
+internal inline void Bitset_Internal_Clear_Tail(Bitset *bitset) {
+    u64 bits_in_last_word = bitset->count % BITSET_BITS_PER_WORD;
+    if (bits_in_last_word != 0) {
+        bitset->words[bitset->word_count - 1] &= (1ULL << bits_in_last_word) - 1;
+    }
+}
+
+void _Bitset_Resize(Bitset *bitset, u64 new_count, Source_Code_Location caller_location) {
+    ASSERT(bitset);
+
+    u64 new_word_count = Div_Ceil(new_count, BITSET_BITS_PER_WORD);
+
+    // clears the new words for us, (when shrinking, the tail gets cleared below).
+    Array_Maybe_Grow((Generic_Array*)bitset, (Array_Item_Type_Properties_Struct){ sizeof(u64), Alignof(u64) }, new_word_count, true, caller_location);
+
+    bitset->word_count = new_word_count;
+    bitset->count      = new_count;
+    Bitset_Internal_Clear_Tail(bitset);
+}
+
+void Bitset_Clear_All(Bitset *bitset) {
+    ASSERT(bitset);
+    Mem_Zero(bitset->words, bitset->word_count * sizeof(u64));
+}
+
+void Bitset_Set_All(Bitset *bitset) {
+    ASSERT(bitset);
+    Mem_Set(bitset->words, 0xFF, bitset->word_count * sizeof(u64));
+    Bitset_Internal_Clear_Tail(bitset);
+}
+
+u64 Bitset_Count(Bitset *bitset) {
+    ASSERT(bitset);
+
+    // the compiler turns this into popcnt, (or something vectorized if it can).
+    u64 result = 0;
+    for (u64 i = 0; i < bitset->word_count; i++) {
+        result += (u64) __builtin_popcountll(bitset->words[i]);
+    }
+    return result;
+}
+
+u64 Bitset_Find_Next_Set(Bitset *bitset, u64 from) {
+    ASSERT(bitset);
+    if (from >= bitset->count) return bitset->count;
+
+    u64 word_index = from / BITSET_BITS_PER_WORD;
+    // mask off the bits before 'from'.
+    u64 word = bitset->words[word_index] & (~0ULL << (from % BITSET_BITS_PER_WORD));
+
+    while (word == 0) {
+        word_index += 1;
+        if (word_index >= bitset->word_count) return bitset->count;
+        word = bitset->words[word_index];
+    }
+
+    // the tail bits are always 0, so this is always in range.
+    return word_index * BITSET_BITS_PER_WORD + (u64) __builtin_ctzll(word);
+}
+
+u64 Bitset_Find_Next_Unset(Bitset *bitset, u64 from) {
+    ASSERT(bitset);
+    if (from >= bitset->count) return bitset->count;
+
+    u64 word_index = from / BITSET_BITS_PER_WORD;
+    u64 word = ~bitset->words[word_index] & (~0ULL << (from % BITSET_BITS_PER_WORD));
+
+    while (word == 0) {
+        word_index += 1;
+        if (word_index >= bitset->word_count) return bitset->count;
+        word = ~bitset->words[word_index];
+    }
+
+    // the tail bits are 0, so they look unset, dont return one of those.
+    return Min(word_index * BITSET_BITS_PER_WORD + (u64) __builtin_ctzll(word), bitset->count);
+}
+
+
+// the body of all the bulk operations, lanes first, then the words that are left.
+#define BITSET_INTERNAL_BULK_OPERATION(dest, src, LANE_OPERATION, WORD_OPERATOR)                        \
+    do {                                                                                                \
+        ASSERT((dest) && (src));                                                                        \
+        u64 _n = Min((dest)->word_count, (src)->word_count);                                           \
+        u64 _i = 0;                                                                                     \
+        for (; _i + BITSET_WORDS_PER_LANE <= _n; _i += BITSET_WORDS_PER_LANE) {                         \
+            Bitset_Lane _a = Bitset_Lane_Load((dest)->words + _i);                                      \
+            Bitset_Lane _b = Bitset_Lane_Load((src )->words + _i);                                      \
+            Bitset_Lane_Store((dest)->words + _i, LANE_OPERATION(_a, _b));                              \
+        }                                                                                               \
+        for (; _i < _n; _i++) {                                                                         \
+            (dest)->words[_i] = (dest)->words[_i] WORD_OPERATOR (src)->words[_i];                       \
+        }                                                                                               \
+    } while (0)
+
+void Bitset_And(Bitset *dest, Bitset *src) {
+    BITSET_INTERNAL_BULK_OPERATION(dest, src, Bitset_Lane_And, &);
+
+    // anything src doesn't have is a 0.
+    if (src->word_count < dest->word_count) {
+        Mem_Zero(dest->words + src->word_count, (dest->word_count - src->word_count) * sizeof(u64));
+    }
+}
+
+void Bitset_Or(Bitset *dest, Bitset *src) {
+    BITSET_INTERNAL_BULK_OPERATION(dest, src, Bitset_Lane_Or, |);
+    // src might be longer, and have set bits past our count.
+    Bitset_Internal_Clear_Tail(dest);
+}
+
+void Bitset_Xor(Bitset *dest, Bitset *src) {
+    BITSET_INTERNAL_BULK_OPERATION(dest, src, Bitset_Lane_Xor, ^);
+    Bitset_Internal_Clear_Tail(dest);
+}
+
+void Bitset_And_Not(Bitset *dest, Bitset *src) {
+    BITSET_INTERNAL_BULK_OPERATION(dest, src, Bitset_Lane_And_Not, & ~);
+}
+
+void Bitset_Free(Bitset *bitset) {
+    ASSERT(bitset);
+
+    Array_Free_Items(bitset->words, bitset->word_capacity * sizeof(u64));
+    bitset->words         = NULL;
+    bitset->word_count    = 0;
+    bitset->word_capacity = 0;
+    bitset->count         = 0;
+}
+
+
+
+// ===================================================
+//                     Slot Map
+// ===================================================
+
+Slot_Map_Handle Generic_Slot_Map_Insert(Generic_Slot_Map *slot_map, Array_Item_Type_Properties_Struct item_properties, Source_Code_Location caller_location) {
+    ASSERT(slot_map);
+    ASSERT(slot_map->count < UINT32_MAX && "the indexes are only 32 bits");
+
+    // everything uses the same allocator.
+    slot_map->slot_of_item.allocator = slot_map->allocator;
+    slot_map->slots.allocator        = slot_map->allocator;
+
+    u32 slot;
+    if (slot_map->free_list) {
+        slot = slot_map->free_list - 1;
+        slot_map->free_list = slot_map->slots.items[slot].index;
+    } else {
+        ASSERT(slot_map->slots.count < UINT32_MAX);
+        Array_Maybe_Grow((Generic_Array*)&slot_map->slots, Get_Item_Type_Properties(&slot_map->slots), slot_map->slots.count + 1, true, caller_location);
+        slot = slot_map->slots.count++;
+    }
+
+    Array_Maybe_Grow((Generic_Array*)slot_map, item_properties, slot_map->count + 1, false, caller_location);
+    Array_Maybe_Grow((Generic_Array*)&slot_map->slot_of_item, Get_Item_Type_Properties(&slot_map->slot_of_item), slot_map->count + 1, false, caller_location);
+
+    u32 index = slot_map->count;
+    slot_map->count              += 1;
+    slot_map->slot_of_item.count += 1;
+    slot_map->slot_of_item.items[index] = slot;
+
+    Slot_Map_Slot *s = &slot_map->slots.items[slot];
+    s->generation += 1; // now its odd, (in use).
+    s->index       = index;
+
+    return ((Slot_Map_Handle)s->generation << 32) | slot;
+}
+
+bool Generic_Slot_Map_Remove(Generic_Slot_Map *slot_map, Array_Item_Type_Properties_Struct item_properties, Slot_Map_Handle handle) {
+    ASSERT(slot_map);
+
+    u32 slot       = Slot_Map_Handle_Slot(handle);
+    u32 generation = Slot_Map_Handle_Generation(handle);
+    if (!(generation & 1) || slot >= slot_map->slots.count) return false;
+
+    Slot_Map_Slot *s = &slot_map->slots.items[slot];
+    if (s->generation != generation) return false;
+
+    // move the last item into the hole, and tell its slot where it went.
+    u32 index = s->index;
+    u32 last  = slot_map->count - 1;
+    if (index != last) {
+        Mem_Copy((u8*)slot_map->items + index * item_properties.item_size, (u8*)slot_map->items + last * item_properties.item_size, item_properties.item_size);
+
+        u32 moved_slot = slot_map->slot_of_item.items[last];
+        slot_map->slot_of_item.items[index] = moved_slot;
+        slot_map->slots.items[moved_slot].index = index;
+    }
+    slot_map->count              -= 1;
+    slot_map->slot_of_item.count -= 1;
+
+    // even again, (free). if the generation is about to wrap around,
+    // just retire the slot, so an ancient handle can never come back to life.
+    s->generation += 1;
+    if (s->generation != UINT32_MAX - 1) {
+        s->index = slot_map->free_list;
+        slot_map->free_list = slot + 1;
+    }
+    return true;
+}
+
+void Generic_Slot_Map_Clear(Generic_Slot_Map *slot_map) {
+    ASSERT(slot_map);
+
+    // free every slot thats in use.
+    for (u64 i = 0; i < slot_map->count; i++) {
+        u32 slot = slot_map->slot_of_item.items[i];
+        Slot_Map_Slot *s = &slot_map->slots.items[slot];
+
+        s->generation += 1;
+        if (s->generation != UINT32_MAX - 1) {
+            s->index = slot_map->free_list;
+            slot_map->free_list = slot + 1;
+        }
+    }
+    slot_map->count              = 0;
+    slot_map->slot_of_item.count = 0;
+}
+
+void Generic_Slot_Map_Free(Generic_Slot_Map *slot_map, Array_Item_Type_Properties_Struct item_properties) {
+    ASSERT(slot_map);
+
+    Array_Free_Items(slot_map->items, slot_map->capacity * item_properties.item_size);
+    slot_map->items     = NULL;
+    slot_map->count     = 0;
+    slot_map->capacity  = 0;
+    slot_map->free_list = 0;
+
+    Array_Free(&slot_map->slot_of_item);
+    Array_Free(&slot_map->slots);
+}
+
+
+
+// ===================================================
+//                Dynamic Hash Map
+// ===================================================
+
+// the control bytes live right after the entries, in the same allocation.
+internal inline u8 *Hash_Map_Control_Bytes(Generic_Hash_Map *hash_map, Hash_Map_Key_Value_Type_Properties properties) {
+    return (u8*)hash_map->entries + Mem_Align_Forward(hash_map->capacity * properties.entry_size, HASH_MAP_GROUP_SIZE);
+}
+
+// how many bytes a table with this capacity needs.
+internal u64 Hash_Map_Table_Size(Hash_Map_Layout layout, u64 capacity, Hash_Map_Key_Value_Type_Properties properties) {
+    switch (layout) {
+        case Hash_Map_Layout_Default:       return capacity * properties.entry_size;
+        case Hash_Map_Layout_Control_Bytes: return Mem_Align_Forward(capacity * properties.entry_size, HASH_MAP_GROUP_SIZE) + capacity;
+        case Hash_Map_Layout_Robin_Hood:    return capacity * properties.entry_size;
+        case Hash_Map_Layout_Split:         return Hash_Map_Split_Values_Offset(capacity, properties.key_size, properties.entry_alignment) + capacity * properties.value_size;
+        case Hash_Map_Layout_Ordered:       return Mem_Align_Forward(Hash_Map_Max_Load(layout, capacity) * properties.entry_size, sizeof(u64)) + capacity * Hash_Map_Ordered_Index_Width(capacity);
+    }
+    UNREACHABLE();
+}
+
+// how many slots there are to look at, for the ordered layout thats just the entries used so far.
+internal inline u64 Hash_Map_Slot_End(Generic_Hash_Map *hash_map) {
+    if (hash_map->layout == Hash_Map_Layout_Ordered) return hash_map->count + hash_map->dead_count;
+    return hash_map->capacity;
+}
+
+
+//
+// Hash_Map_Layout_Ordered
+//
+// a 'slot' is an index into the entries, (which are just like the default layout),
+// and the index table after them is what actually gets probed.
+//
+
+// all ones, for whatever the width is.
+#define HASH_MAP_ORDERED_DEAD(width)    ((width) == 8 ? ~0ULL : (1ULL << ((width) * 8)) - 1)
+
+internal inline u8 *Hash_Map_Ordered_Indices(Generic_Hash_Map *hash_map, Hash_Map_Key_Value_Type_Properties properties) {
+    return (u8*)hash_map->entries + Mem_Align_Forward(Hash_Map_Max_Load(Hash_Map_Layout_Ordered, hash_map->capacity) * properties.entry_size, sizeof(u64));
+}
+
+internal inline u64 Hash_Map_Ordered_Index_Get(u8 *indices, u64 width, u64 slot) {
+    switch (width) {
+        case 1:  return ((u8 *)indices)[slot];
+        case 2:  return ((u16*)indices)[slot];
+        case 4:  return ((u32*)indices)[slot];
+        default: return ((u64*)indices)[slot];
+    }
+}
+internal inline void Hash_Map_Ordered_Index_Set(u8 *indices, u64 width, u64 slot, u64 index) {
+    switch (width) {
+        case 1:  ((u8 *)indices)[slot] = (u8 ) index; break;
+        case 2:  ((u16*)indices)[slot] = (u16) index; break;
+        case 4:  ((u32*)indices)[slot] = (u32) index; break;
+        default: ((u64*)indices)[slot] = (u64) index; break;
+    }
+}
+
+// point a free slot in the index table at this entry.
+internal void Hash_Map_Ordered_Link(Generic_Hash_Map *hash_map, u64 entry_index, u64 hash, Hash_Map_Key_Value_Type_Properties properties) {
+    u8 *indices = Hash_Map_Ordered_Indices(hash_map, properties);
+    u64 width   = Hash_Map_Ordered_Index_Width(hash_map->capacity);
+    u64 dead    = HASH_MAP_ORDERED_DEAD(width);
+    u64 mask    = hash_map->capacity - 1;
+
+    u64 slot = hash & mask;
+    for (u64 increment = 1; ; increment++) {
+        u64 index = Hash_Map_Ordered_Index_Get(indices, width, slot);
+        if (index == 0 || index == dead) {
+            Hash_Map_Ordered_Index_Set(indices, width, slot, entry_index + 1);
+            return;
+        }
+        slot = (slot + increment) & mask;
+        ASSERT(increment < 4096);
+    }
+}
+
+// find the index table slot that points at this entry, and make it dead.
+internal void Hash_Map_Ordered_Unlink(Generic_Hash_Map *hash_map, u64 entry_index, u64 hash, Hash_Map_Key_Value_Type_Properties properties) {
+    u8 *indices = Hash_Map_Ordered_Indices(hash_map, properties);
+    u64 width   = Hash_Map_Ordered_Index_Width(hash_map->capacity);
+    u64 mask    = hash_map->capacity - 1;
+
+    u64 slot = hash & mask;
+    for (u64 increment = 1; ; increment++) {
+        u64 index = Hash_Map_Ordered_Index_Get(indices, width, slot);
+        ASSERT(index != 0 && "the entry has to be in the index table");
+        if (index == entry_index + 1) {
+            Hash_Map_Ordered_Index_Set(indices, width, slot, HASH_MAP_ORDERED_DEAD(width));
+            return;
+        }
+        slot = (slot + increment) & mask;
+    }
+}
+
+
+//
+// Every layout is just an array of slots, these are the
+// only functions that know what a slot looks like.
+//
+
+// only for the layouts that have {hash, key, value} entries.
+internal inline void *Hash_Map_Slot_Entry(Generic_Hash_Map *hash_map, u64 slot, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(hash_map->layout != Hash_Map_Layout_Split);
+    return (u8*)hash_map->entries + slot * properties.entry_size;
+}
+// where the full hash is stored, for the control byte layout this is still in the entry.
+internal inline u64 *Hash_Map_Slot_Hash_Ptr(Generic_Hash_Map *hash_map, u64 slot, Hash_Map_Key_Value_Type_Properties properties) {
+    if (hash_map->layout == Hash_Map_Layout_Split) return (u64*)hash_map->entries + slot;
+    return &HASH_MAP_HASH_FROM_ENTRY(Hash_Map_Slot_Entry(hash_map, slot, properties));
+}
+internal inline void *Hash_Map_Slot_Key(Generic_Hash_Map *hash_map, u64 slot, Hash_Map_Key_Value_Type_Properties properties) {
+    if (hash_map->layout == Hash_Map_Layout_Split) {
+        return (u8*)hash_map->entries + Hash_Map_Split_Keys_Offset(hash_map->capacity, properties.entry_alignment) + slot * properties.key_size;
+    }
+    return (u8*)Hash_Map_Slot_Entry(hash_map, slot, properties) + properties.key_offset_in_entry;
+}
+internal inline void *Hash_Map_Slot_Value(Generic_Hash_Map *hash_map, u64 slot, Hash_Map_Key_Value_Type_Properties properties) {
+    if (hash_map->layout == Hash_Map_Layout_Split) {
+        // a Hash_Set has no values, its 'value' is the key.
+        if (properties.value_size == 0) return Hash_Map_Slot_Key(hash_map, slot, properties);
+        return (u8*)hash_map->entries + Hash_Map_Split_Values_Offset(hash_map->capacity, properties.key_size, properties.entry_alignment) + slot * properties.value_size;
+    }
+    return (u8*)Hash_Map_Slot_Entry(hash_map, slot, properties) + properties.value_offset_in_entry;
+}
+
+// the hash of whatever is in the slot, Hash_Map_UNALLOCATED and Hash_Map_DEAD included.
+internal inline u64 Hash_Map_Slot_Hash(Generic_Hash_Map *hash_map, u64 slot, Hash_Map_Key_Value_Type_Properties properties) {
+    if (hash_map->layout == Hash_Map_Layout_Control_Bytes) {
+        u8 control = Hash_Map_Control_Bytes(hash_map, properties)[slot];
+        if (control == HASH_MAP_CONTROL_EMPTY) return Hash_Map_UNALLOCATED;
+        if (control == HASH_MAP_CONTROL_DEAD)  return Hash_Map_DEAD;
+    }
+    return *Hash_Map_Slot_Hash_Ptr(hash_map, slot, properties);
+}
+
+// copy the key and value from one table to another.
+internal inline void Hash_Map_Slot_Copy(Generic_Hash_Map *to, u64 to_slot, Generic_Hash_Map *from, u64 from_slot, Hash_Map_Key_Value_Type_Properties properties) {
+    if (to->layout == Hash_Map_Layout_Split) {
+        Mem_Copy(Hash_Map_Slot_Key  (to, to_slot, properties), Hash_Map_Slot_Key  (from, from_slot, properties), properties.key_size);
+        Mem_Copy(Hash_Map_Slot_Value(to, to_slot, properties), Hash_Map_Slot_Value(from, from_slot, properties), properties.value_size);
+        return;
+    }
+    Mem_Copy(Hash_Map_Slot_Entry(to, to_slot, properties), Hash_Map_Slot_Entry(from, from_slot, properties), properties.entry_size);
+}
+
+// for robin hood, moves everything from 'slot' up to the next empty slot down one.
+internal void Hash_Map_Robin_Hood_Make_Hole(Generic_Hash_Map *hash_map, u64 slot, Hash_Map_Key_Value_Type_Properties properties) {
+    u64 mask = hash_map->capacity - 1;
+
+    u64 empty = slot;
+    while (*Hash_Map_Slot_Hash_Ptr(hash_map, empty, properties) != Hash_Map_UNALLOCATED) empty = (empty + 1) & mask;
+
+    for (u64 to = empty; to != slot; ) {
+        u64 from = (to - 1) & mask;
+        Mem_Copy(Hash_Map_Slot_Entry(hash_map, to, properties), Hash_Map_Slot_Entry(hash_map, from, properties), properties.entry_size);
+        to = from;
+    }
+}
+
+// marks the slot as used by something with this hash, dose not touch the key or value.
+//
+// for robin hood the slot might have something in it, it gets moved along.
+internal inline void Hash_Map_Slot_Fill(Generic_Hash_Map *hash_map, u64 slot, u64 hash, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(!Hash_Map_Hash_Is_Bad(hash));
+
+    if (hash_map->layout == Hash_Map_Layout_Ordered) {
+        // allways the next entry, the index table is what decides where it is.
+        ASSERT(slot == hash_map->count + hash_map->dead_count);
+        ASSERT(slot < Hash_Map_Max_Load(hash_map->layout, hash_map->capacity));
+        Hash_Map_Ordered_Link(hash_map, slot, hash, properties);
+        *Hash_Map_Slot_Hash_Ptr(hash_map, slot, properties) = hash;
+        hash_map->count += 1;
+        return;
+    }
+
+    if (hash_map->layout == Hash_Map_Layout_Robin_Hood && *Hash_Map_Slot_Hash_Ptr(hash_map, slot, properties) != Hash_Map_UNALLOCATED) {
+        Hash_Map_Robin_Hood_Make_Hole(hash_map, slot, properties);
+    }
+
+    if (hash_map->layout == Hash_Map_Layout_Control_Bytes) {
+        u8 *control = &Hash_Map_Control_Bytes(hash_map, properties)[slot];
+        if (*control == HASH_MAP_CONTROL_DEAD) hash_map->dead_count -= 1;
+        *control = HASH_MAP_CONTROL_FROM_HASH(hash);
+    } else {
+        if (*Hash_Map_Slot_Hash_Ptr(hash_map, slot, properties) == Hash_Map_DEAD) hash_map->dead_count -= 1;
+    }
+    *Hash_Map_Slot_Hash_Ptr(hash_map, slot, properties) = hash;
+    hash_map->count += 1;
+}
+
+// remove whatever is in the slot.
+internal void Hash_Map_Slot_Kill(Generic_Hash_Map *hash_map, u64 slot, Hash_Map_Key_Value_Type_Properties properties) {
+    hash_map->count -= 1;
+
+    if (hash_map->layout == Hash_Map_Layout_Control_Bytes) {
+        u8 *control_bytes = Hash_Map_Control_Bytes(hash_map, properties);
+        u8 *group = control_bytes + (slot & ~(u64)(HASH_MAP_GROUP_SIZE - 1));
+
+        // if the group still has an empty slot, no probe ever went past
+        // this group, so nobody needs a tombstone here.
+        if (Hash_Map_Group_Match(group, HASH_MAP_CONTROL_EMPTY)) {
+            control_bytes[slot] = HASH_MAP_CONTROL_EMPTY;
+            return;
+        }
+        control_bytes[slot] = HASH_MAP_CONTROL_DEAD;
+        hash_map->dead_count += 1;
+        return;
+    }
+
+    if (hash_map->layout == Hash_Map_Layout_Ordered) {
+        // the entry stays where it is, (so the order dosen't change), until the next rehash.
+        u64 *hash = Hash_Map_Slot_Hash_Ptr(hash_map, slot, properties);
+        Hash_Map_Ordered_Unlink(hash_map, slot, *hash, properties);
+        *hash = Hash_Map_DEAD;
+        hash_map->dead_count += 1;
+        return;
+    }
+
+    if (hash_map->layout == Hash_Map_Layout_Robin_Hood) {
+        // backward shift, pull the next ones back until one is allready home.
+        u64 mask = hash_map->capacity - 1;
+        while (true) {
+            u64 next      = (slot + 1) & mask;
+            u64 next_hash = *Hash_Map_Slot_Hash_Ptr(hash_map, next, properties);
+            if (next_hash == Hash_Map_UNALLOCATED || Hash_Map_Probe_Distance(next_hash, next, mask) == 0) break;
+
+            Mem_Copy(Hash_Map_Slot_Entry(hash_map, slot, properties), Hash_Map_Slot_Entry(hash_map, next, properties), properties.entry_size);
+            slot = next;
+        }
+        *Hash_Map_Slot_Hash_Ptr(hash_map, slot, properties) = Hash_Map_UNALLOCATED;
+        return;
+    }
+
+    *Hash_Map_Slot_Hash_Ptr(hash_map, slot, properties) = Hash_Map_DEAD;
+    hash_map->dead_count += 1;
+}
+
+// the slot a value pointer belongs to, ASSERT()'s that its one of ours.
+internal u64 Hash_Map_Slot_Of_Value(Generic_Hash_Map *hash_map, void *value_ptr, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(hash_map);
+    ASSERT(value_ptr);
+
+    // should map down into entry.
+    s64 slot;
+    if (hash_map->layout == Hash_Map_Layout_Split) {
+        u8 *values = (u8*)Hash_Map_Slot_Value(hash_map, 0, properties);
+        // (for a Hash_Set thats the keys)
+        u64 stride = properties.value_size ? properties.value_size : properties.key_size;
+        slot = ((u8*)value_ptr - values) / (s64)stride;
+    } else {
+        slot = ((u8*)value_ptr - properties.value_offset_in_entry - (u8*)hash_map->entries) / (s64)properties.entry_size;
+    }
+
+    // make sure this is in the range of the hash map.
+    ASSERT(Is_Between(slot, 0, (s64)hash_map->capacity-1));
+    // make sure we got the right thing. make sure were not about to write somewhere stupid.
+    ASSERT(Hash_Map_Slot_Value(hash_map, slot, properties) == value_ptr);
+
+    return (u64) slot;
+}
+
+
+// the control byte probe, 16 slots at a time.
+//
+// the groups are aligned, and we jump between them with triangular numbers,
+// (+1, +2, +3...) which visits every group when the group count is a power of 2.
+internal u64 Hash_Map_Control_Bytes_Find_Slot(Generic_Hash_Map *hash_map, void *key, u64 hash, Hash_Map_Key_Value_Type_Properties properties, Equality_Function equality_function, u64 *insert_slot) {
+    u8 *control_bytes = Hash_Map_Control_Bytes(hash_map, properties);
+    u8  control       = HASH_MAP_CONTROL_FROM_HASH(hash);
+
+    u64 group_mask  = hash_map->capacity / HASH_MAP_GROUP_SIZE - 1;
+    u64 group_index = (hash >> 7) & group_mask;
+
+    if (insert_slot) *insert_slot = HASH_MAP_NO_SLOT;
+
+    for (u64 step = 1; ; step++) {
+        u8 *group = control_bytes + group_index * HASH_MAP_GROUP_SIZE;
+        Hash_Map_Count_Probe();
+
+        for (u32 matches = Hash_Map_Group_Match(group, control); matches; matches &= matches - 1) {
+            u64 slot = group_index * HASH_MAP_GROUP_SIZE + __builtin_ctz(matches);
+            void *entry = Hash_Map_Slot_Entry(hash_map, slot, properties);
+            if (HASH_MAP_HASH_FROM_ENTRY(entry) == hash && equality_function(key, (u8*)entry + properties.key_offset_in_entry, properties.key_size)) {
+                return slot;
+            }
+        }
+
+        u32 available = Hash_Map_Group_Match_Available(group);
+        if (insert_slot && *insert_slot == HASH_MAP_NO_SLOT && available) {
+            // first dead or empty slot we saw, might as well reuse it.
+            *insert_slot = group_index * HASH_MAP_GROUP_SIZE + __builtin_ctz(available);
+        }
+
+        // an empty slot means the key was never put past here.
+        if (Hash_Map_Group_Match(group, HASH_MAP_CONTROL_EMPTY)) return HASH_MAP_NO_SLOT;
+
+        // we always keep some empty slots around, so this never happens.
+        ASSERT(step <= group_mask + 1);
+        group_index = (group_index + step) & group_mask;
+    }
+}
+
+// returns the slot that holds this key, or HASH_MAP_NO_SLOT if it isn't there.
+//
+// if 'insert_slot' isn't NULL, it gets set to where this key
+// should go, (or HASH_MAP_NO_SLOT if the map has no memory yet).
+internal u64 Hash_Map_Find_Slot(Generic_Hash_Map *hash_map, void *key, u64 hash, Hash_Map_Key_Value_Type_Properties properties, u64 *insert_slot) {
+    ASSERT(hash_map);
+    ASSERT(key);
+
+    // don't give this an invalid hash.
+    ASSERT(!Hash_Map_Hash_Is_Bad(hash));
+
+    if (insert_slot) *insert_slot = HASH_MAP_NO_SLOT;
+    Hash_Map_Count_Lookup();
+    if (hash_map->capacity == 0) return HASH_MAP_NO_SLOT;
+
+    // gonna need this to check if keys are equal.
+    Equality_Function equality_function = hash_map->eq_function ? hash_map->eq_function : Hash_Map_Default_Equality_Function;
+
+    // must be true, or my probe strategy will not cover every cell.
+    ASSERT(Is_Pow_2(hash_map->capacity));
+
+    if (hash_map->layout == Hash_Map_Layout_Control_Bytes) {
+        return Hash_Map_Control_Bytes_Find_Slot(hash_map, key, hash, properties, equality_function, insert_slot);
+    }
+
+    if (hash_map->layout == Hash_Map_Layout_Ordered) {
+        u8 *indices = Hash_Map_Ordered_Indices(hash_map, properties);
+        u64 width   = Hash_Map_Ordered_Index_Width(hash_map->capacity);
+        u64 dead    = HASH_MAP_ORDERED_DEAD(width);
+        u64 mask    = hash_map->capacity - 1;
+
+        u64 slot = hash & mask;
+        for (u64 increment = 1; ; increment++) {
+            u64 index = Hash_Map_Ordered_Index_Get(indices, width, slot);
+            Hash_Map_Count_Probe();
+            if (index == 0) break;
+
+            if (index != dead) {
+                u64 entry_index = index - 1;
+                if (*Hash_Map_Slot_Hash_Ptr(hash_map, entry_index, properties) == hash && equality_function(key, Hash_Map_Slot_Key(hash_map, entry_index, properties), properties.key_size)) {
+                    return entry_index;
+                }
+            }
+
+            slot = (slot + increment) & mask;
+            ASSERT(increment < 4096);
+        }
+
+        // new things go on the end.
+        if (insert_slot) *insert_slot = hash_map->count + hash_map->dead_count;
+        return HASH_MAP_NO_SLOT;
+    }
+
+    if (hash_map->layout == Hash_Map_Layout_Robin_Hood) {
+        u64 mask = hash_map->capacity - 1;
+        u64 slot = hash & mask;
+
+        for (u64 distance = 0; ; distance++) {
+            u64 slot_hash = *Hash_Map_Slot_Hash_Ptr(hash_map, slot, properties);
+            Hash_Map_Count_Probe();
+
+            // an empty slot, or one thats closer to home than we would be.
+            // either way the key would have been put before here.
+            //
+            // robin hood never has dead slots, except in the old table of an
+            // incremental resize, they dont tell us anything so just walk over them.
+            if (slot_hash == Hash_Map_UNALLOCATED || (slot_hash != Hash_Map_DEAD && Hash_Map_Probe_Distance(slot_hash, slot, mask) < distance)) {
+                if (insert_slot) *insert_slot = slot;
+                return HASH_MAP_NO_SLOT;
+            }
+
+            if (slot_hash == hash && equality_function(key, Hash_Map_Slot_Key(hash_map, slot, properties), properties.key_size)) {
+                return slot;
+            }
+
+            slot = (slot + 1) & mask;
+        }
+    }
+
+    u64 increment = 1;
+    u64 slot      = hash % hash_map->capacity;
+    u64 first_dead_slot = HASH_MAP_NO_SLOT;
+
+    // the default and split layouts probe the same way, only where the hash and key live is different.
+    while (true) {
+        u64 slot_hash = *Hash_Map_Slot_Hash_Ptr(hash_map, slot, properties);
+        Hash_Map_Count_Probe();
+
+        // this is a valid position to put something in. break
+        if (slot_hash == Hash_Map_UNALLOCATED) break;
+
+        // we can put it here, but the key might still be further along.
+        if (slot_hash == Hash_Map_DEAD && first_dead_slot == HASH_MAP_NO_SLOT) first_dead_slot = slot;
+
+        // check if this is the same key.
+        if (slot_hash == hash && equality_function(key, Hash_Map_Slot_Key(hash_map, slot, properties), properties.key_size)) {
+            return slot;
+        }
+
+        slot = (slot + increment) % hash_map->capacity;
+        increment += 1;
+        ASSERT(increment < 4096); // what are the odds for 4096 hash collisions in a row? something bad must have happened.
+    }
+
+    // reuse a dead slot if we saw one, keeps the probes short.
+    if (insert_slot) *insert_slot = (first_dead_slot != HASH_MAP_NO_SLOT) ? first_dead_slot : slot;
+    return HASH_MAP_NO_SLOT;
+}
+
+// where a key that we know isn't in the map should go, used when growing,
+// (no need to compare keys, everything is unique).
+internal u64 Hash_Map_Find_Empty_Slot(Generic_Hash_Map *hash_map, u64 hash, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(hash_map->capacity > 0);
+
+    // Hash_Map_Slot_Fill() sorts out the index table.
+    if (hash_map->layout == Hash_Map_Layout_Ordered) return hash_map->count + hash_map->dead_count;
+
+    if (hash_map->layout == Hash_Map_Layout_Control_Bytes) {
+        u8 *control_bytes = Hash_Map_Control_Bytes(hash_map, properties);
+        u64 group_mask  = hash_map->capacity / HASH_MAP_GROUP_SIZE - 1;
+        u64 group_index = (hash >> 7) & group_mask;
+
+        for (u64 step = 1; ; step++) {
+            u32 available = Hash_Map_Group_Match_Available(control_bytes + group_index * HASH_MAP_GROUP_SIZE);
+            if (available) return group_index * HASH_MAP_GROUP_SIZE + __builtin_ctz(available);
+
+            ASSERT(step <= group_mask + 1);
+            group_index = (group_index + step) & group_mask;
+        }
+    }
+
+    if (hash_map->layout == Hash_Map_Layout_Robin_Hood) {
+        // not empty, but the right place to go, Hash_Map_Slot_Fill() moves the rest along.
+        u64 mask = hash_map->capacity - 1;
+        u64 slot = hash & mask;
+        for (u64 distance = 0; ; distance++) {
+            u64 slot_hash = *Hash_Map_Slot_Hash_Ptr(hash_map, slot, properties);
+            if (slot_hash == Hash_Map_UNALLOCATED || Hash_Map_Probe_Distance(slot_hash, slot, mask) < distance) return slot;
+            slot = (slot + 1) & mask;
+        }
+    }
+
+    u64 increment = 1;
+    u64 slot      = hash % hash_map->capacity;
+    while (*Hash_Map_Slot_Hash_Ptr(hash_map, slot, properties) != Hash_Map_UNALLOCATED) {
+        slot = (slot + increment) % hash_map->capacity;
+        increment += 1;
+        ASSERT(increment < 4096);
+    }
+    return slot;
+}
+
+// sets every slot to empty.
+internal void Hash_Map_Clear_Slots(Generic_Hash_Map *hash_map, Hash_Map_Key_Value_Type_Properties properties) {
+    if (hash_map->capacity == 0) return;
+
+    if (hash_map->layout == Hash_Map_Layout_Control_Bytes) {
+        // just one memset, the entries dont matter.
+        Mem_Set(Hash_Map_Control_Bytes(hash_map, properties), HASH_MAP_CONTROL_EMPTY, hash_map->capacity);
+        return;
+    }
+    if (hash_map->layout == Hash_Map_Layout_Ordered) {
+        // nothing past count + dead_count gets looked at, just the index table.
+        Mem_Zero(Hash_Map_Ordered_Indices(hash_map, properties), hash_map->capacity * Hash_Map_Ordered_Index_Width(hash_map->capacity));
+        return;
+    }
+    if (hash_map->layout == Hash_Map_Layout_Split) {
+        // the hashes are all together, and Hash_Map_UNALLOCATED is zero.
+        Mem_Zero(hash_map->entries, hash_map->capacity * sizeof(u64));
+        return;
+    }
+
+    // set all entries to unallocated.
+    for (u64 i = 0; i < hash_map->capacity; i++) {
+        *Hash_Map_Slot_Hash_Ptr(hash_map, i, properties) = Hash_Map_UNALLOCATED;
+    }
+}
+
+// hash's that are equal to Hash_Map_UNALLOCATED or Hash_Map_DEAD are not good.
+//
+// takes the functions, not the map, so a Frozen_Hash_Map can use it too.
+internal u64 Hash_Map_Hash_Key(Hash_Function hash_function, Seeded_Hash_Function seeded_hash_function, u64 seed, void *key, u64 key_size) {
+    ASSERT(key);
+
+    u64 key_hash;
+    if (hash_function) {
+        key_hash = hash_function(key, key_size);
+    } else if (seeded_hash_function) {
+        key_hash = seeded_hash_function(key, key_size, seed);
+    } else {
+        key_hash = Hash_Map_Default_Seeded_Hash_Function(key, key_size, seed);
+    }
+
+    if (Hash_Map_Hash_Is_Bad(key_hash)) {
+        // some random number, to place the key randomly in the resulting hashmap.
+        return HASH_MAP_BAD_HASH_REPLACEMENT;
+    }
+
+    return key_hash;
+}
+
+internal inline u64 Hash_Map_Safely_Get_Hash(Generic_Hash_Map *hash_map, void *key, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(hash_map);
+    return Hash_Map_Hash_Key(hash_map->hash_function, hash_map->seeded_hash_function, hash_map->seed, key, properties.key_size);
+}
+
+
+//
+// '.incremental_resize'
+//
+// the old table is left exactly how it was, (so probes through it still work),
+// and things only ever leave it:
+//     - a resize step copies slots into the new table, from 'next_slot' upwards.
+//     - removing something that hasn't been moved yet just marks it dead.
+//
+// so a key is either in the new table, or alive in the old table at or past 'next_slot',
+// anything before 'next_slot' is a stale copy, (it might have been removed since).
+//
+// 'count' is everything in both tables, 'dead_count' is just the new table.
+//
+
+// a header for the old table, so all the slot functions work on it.
+internal inline Generic_Hash_Map Hash_Map_Old_Table(Generic_Hash_Map *hash_map) {
+    Generic_Hash_Map old_table = *hash_map;
+    old_table.entries  = hash_map->resizing.entries;
+    old_table.capacity = hash_map->resizing.capacity;
+    return old_table;
+}
+
+// the slot in the old table that still holds this key, or HASH_MAP_NO_SLOT.
+internal u64 Hash_Map_Old_Table_Find_Slot(Generic_Hash_Map *hash_map, void *key, u64 hash, Hash_Map_Key_Value_Type_Properties properties) {
+    if (!Hash_Map_Is_Resizing(hash_map)) return HASH_MAP_NO_SLOT;
+
+    Generic_Hash_Map old_table = Hash_Map_Old_Table(hash_map);
+    u64 slot = Hash_Map_Find_Slot(&old_table, key, hash, properties, NULL);
+
+    // allready moved, the one in the new table is the real one. (HASH_MAP_NO_SLOT is never less)
+    if (slot < hash_map->resizing.next_slot) return HASH_MAP_NO_SLOT;
+    return slot;
+}
+
+// removes something from the old table, without moving anything, (not even for robin hood).
+internal void Hash_Map_Old_Table_Kill(Generic_Hash_Map *hash_map, u64 slot, Hash_Map_Key_Value_Type_Properties properties) {
+    Generic_Hash_Map old_table = Hash_Map_Old_Table(hash_map);
+
+    if (hash_map->layout == Hash_Map_Layout_Control_Bytes) {
+        Hash_Map_Control_Bytes(&old_table, properties)[slot] = HASH_MAP_CONTROL_DEAD;
+    } else {
+        *Hash_Map_Slot_Hash_Ptr(&old_table, slot, properties) = Hash_Map_DEAD;
+    }
+    hash_map->count -= 1;
+}
+
+// true if the value pointer is somewhere in the old table.
+internal bool Hash_Map_Old_Table_Owns(Generic_Hash_Map *hash_map, void *value_ptr, Hash_Map_Key_Value_Type_Properties properties) {
+    if (!Hash_Map_Is_Resizing(hash_map)) return false;
+
+    u8 *start = hash_map->resizing.entries;
+    u64 size  = Hash_Map_Table_Size(hash_map->layout, hash_map->resizing.capacity, properties);
+    return (u8*)value_ptr >= start && (u8*)value_ptr < start + size;
+}
+
+// moves up to 'slot_count' slots of the old table into the new one, and frees it once its empty.
+internal void Hash_Map_Resize_Step(Generic_Hash_Map *hash_map, u64 slot_count, Hash_Map_Key_Value_Type_Properties properties) {
+    if (!Hash_Map_Is_Resizing(hash_map)) return;
+
+    Generic_Hash_Map old_table = Hash_Map_Old_Table(hash_map);
+
+    u64 start = hash_map->resizing.next_slot;
+    u64 end   = start + Min(slot_count, old_table.capacity - start);
+
+    for (u64 i = start; i < end; i++) {
+        u64 this_hash = Hash_Map_Slot_Hash(&old_table, i, properties);
+        if (Hash_Map_Hash_Is_Bad(this_hash)) continue;
+
+        // the same as Hash_Map_Rehash(), nothing in the new table can have this key.
+        u64 new_slot = Hash_Map_Find_Empty_Slot(hash_map, this_hash, properties);
+        Hash_Map_Slot_Fill(hash_map, new_slot, this_hash, properties);
+        Hash_Map_Slot_Copy(hash_map, new_slot, &old_table, i, properties);
+
+        // it was allready counted when it was in the old table.
+        hash_map->count -= 1;
+    }
+    hash_map->resizing.next_slot = end;
+
+    if (end == old_table.capacity) {
+        if (!hash_map->allocator) BESTED_FREE(old_table.entries);
+        hash_map->resizing = (Hash_Map_Resize_State){0};
+    }
+}
+
+// move everything thats left, for when we cant have two tables.
+internal void Hash_Map_Finish_Resize(Generic_Hash_Map *hash_map, Hash_Map_Key_Value_Type_Properties properties) {
+    Hash_Map_Resize_Step(hash_map, ~0ULL, properties);
+    ASSERT(!Hash_Map_Is_Resizing(hash_map));
+}
+
+
+// the smallest capacity that can fit this many items.
+internal u64 Hash_Map_Capacity_For(Generic_Hash_Map *hash_map, u64 be_able_to_fit_at_least) {
+    u64 capacity = HASH_MAP_INITAL_CAPACITY;
+    // the control bytes need at least one whole group.
+    if (hash_map->layout == Hash_Map_Layout_Control_Bytes) capacity = Max(capacity, (u64)HASH_MAP_GROUP_SIZE);
+
+    while (be_able_to_fit_at_least >= Hash_Map_Max_Load(hash_map->layout, capacity)) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+// move everything into a new table with this capacity, drops all the dead slots.
+//
+// the capacity can be the same, (just getting rid of the dead), or smaller.
+internal void Hash_Map_Rehash(Generic_Hash_Map *hash_map, u64 new_capacity, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location) {
+    ASSERT(hash_map);
+    ASSERT(Is_Pow_2(new_capacity));
+
+    // one old table at a time.
+    Hash_Map_Finish_Resize(hash_map, properties);
+    ASSERT(hash_map->count < Hash_Map_Max_Load(hash_map->layout, new_capacity));
+
+    // the old table, so we can still look at it after we get the new one.
+    Generic_Hash_Map old_table = *hash_map;
+
+    if (old_table.capacity == 0) ASSERT(old_table.entries == NULL);
+    else                         ASSERT(old_table.entries != NULL);
+
+    hash_map->capacity = new_capacity;
+
+    u64 table_size  = Hash_Map_Table_Size(hash_map->layout, hash_map->capacity, properties);
+    u64 table_align = Max(properties.entry_alignment, (u64)HASH_MAP_GROUP_SIZE);
+
+    // get the new memory.
+    bool allready_zero = false;
+    if (hash_map->allocator) {
+        // have to do this to set the caller location correctly.
+        hash_map->entries = _Arena_Alloc(
+            hash_map->allocator, table_size,
+            (Arena_Alloc_Opt){ .alignment = table_align, .clear_to_zero = false, },
+            caller_location
+        );
+#ifdef BESTED_DEFAULT_ALLOCATOR
+    } else if (table_align <= Alignof(max_align_t)) {
+        // big tables come straight from mmap(), and calloc() knows those pages are
+        // allready zero, so they dont all get touched up front, only when something lands there.
+        hash_map->entries = calloc(1, table_size);
+        allready_zero = true;
+#endif
+    } else {
+        hash_map->entries = BESTED_ALIGNED_ALLOC(table_align, table_size);
+    }
+
+    // arena's can be set so they dont panic when
+    // getting a NULL pointer from malloc,
+    //
+    // there is no neat way to say this function failed,
+    // so im just gonna panic here.
+    //
+    // if your in a situation where memory might run out,
+    // your machine is probably so low powered, a hash map
+    // wouldn't have that many items in it anyway.
+    // use a raw Arena instead.
+    if (hash_map->entries == NULL) {
+        PANIC(SCL_Fmt" got null pointer when trying to allocate memory for arena growth.", SCL_Arg(caller_location));
+    }
+
+    // reset fields that need resetting.
+    //
+    // Hash_Map_UNALLOCATED is zero, so only the control bytes need setting on zeroed memory.
+    if (!allready_zero || hash_map->layout == Hash_Map_Layout_Control_Bytes) Hash_Map_Clear_Slots(hash_map, properties);
+    hash_map->count = 0;
+    hash_map->dead_count = 0;
+
+    // now copy over the old entries
+    for (u64 i = 0; i < Hash_Map_Slot_End(&old_table); i++) {
+        u64 this_hash = Hash_Map_Slot_Hash(&old_table, i, properties);
+
+        // dont care about bad entries.
+        if (Hash_Map_Hash_Is_Bad(this_hash)) continue;
+
+        u64 new_slot = Hash_Map_Find_Empty_Slot(hash_map, this_hash, properties);
+
+        // mark it as used, (robin hood might move things out of the way), then copy the entry in.
+        Hash_Map_Slot_Fill(hash_map, new_slot, this_hash, properties);
+        Hash_Map_Slot_Copy(hash_map, new_slot, &old_table, i, properties);
+    }
+
+    ASSERT(hash_map->count == old_table.count);
+
+    if (!hash_map->allocator) {
+        // remember to clear the old entries.
+        //
+        // its ok to free a null pointer.
+        BESTED_FREE(old_table.entries);
+    }
+}
+
+// Hash_Map_Rehash(), but the old table sticks around, and the next
+// few inserts move it over with Hash_Map_Resize_Step().
+internal void Hash_Map_Start_Resize(Generic_Hash_Map *hash_map, u64 new_capacity, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location) {
+    ASSERT(hash_map);
+    ASSERT(hash_map->capacity > 0);
 
-void String_Builder_Clear(String_Builder *sb);
+    Hash_Map_Finish_Resize(hash_map, properties);
 
-// Dose not check for NULL byte
-void String_Builder_Ptr_And_Size(String_Builder *sb, void *ptr, u64 size);
-// Dose not check for NULL byte
-void String_Builder_String(String_Builder *sb, String s);
+    Hash_Map_Resize_State old_table = { .entries = hash_map->entries, .capacity = hash_map->capacity, .next_slot = 0 };
+    u64 count = hash_map->count;
 
-u64 String_Builder_printf(String_Builder *sb, const char *format, ...) __attribute__ ((format (printf, 2, 3)));
+    // rehashing nothing is just getting a new empty table.
+    hash_map->entries    = NULL;
+    hash_map->capacity   = 0;
+    hash_map->count      = 0;
+    hash_map->dead_count = 0;
+    Hash_Map_Rehash(hash_map, new_capacity, properties, caller_location);
 
-#define String_Builder_Struct_Bytes(sb, struct_ptr) String_Builder_Ptr_And_Size((sb), (void*) (struct_ptr), sizeof(*(struct_ptr)))
-#define String_Builder_Array_Bytes(sb, ptr, count)  String_Builder_Ptr_And_Size((sb), (void*)(ptr), sizeof(*(ptr)) * (count))
+    hash_map->count    = count;
+    hash_map->resizing = old_table;
+}
 
+// move into a table with this capacity, all at once or a bit at a time.
+internal void Hash_Map_Resize(Generic_Hash_Map *hash_map, u64 new_capacity, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location) {
+    // the ordered layout would need to keep track of how many entries the old table used, its not worth it.
+    if (hash_map->incremental_resize && hash_map->capacity > 0 && hash_map->layout != Hash_Map_Layout_Ordered) {
+        Hash_Map_Start_Resize(hash_map, new_capacity, properties, caller_location);
+    } else {
+        Hash_Map_Rehash(hash_map, new_capacity, properties, caller_location);
+    }
+}
 
-// A trailing NULL byte is appended, so you can pass it into functions that expect a C String
-String String_Builder_To_String(String_Builder *sb);
+internal void Hash_Map_Maybe_Grow(Generic_Hash_Map *hash_map, u64 be_able_to_fit_at_least, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location) {
+    ASSERT(hash_map);
 
-// Dose not write a trailing NULL byte, (as apposed to SB_to_SV)
-void String_Builder_To_File(String_Builder *sb, FILE *file);
+    if (be_able_to_fit_at_least < Hash_Map_Max_Load(hash_map->layout, hash_map->capacity)) return;
 
-// only call if your not useing an allocator.
-void String_Builder_Free(String_Builder *sb);
+    // at least double, so adding one at a time doesn't rehash every time.
+    u64 new_capacity = Max(Hash_Map_Capacity_For(hash_map, be_able_to_fit_at_least), hash_map->capacity * 2);
+    Hash_Map_Resize(hash_map, new_capacity, properties, caller_location);
+}
 
+// makes sure there is room for one more thing.
+//
+// dead slots take up room just like alive ones, (probes have to walk over them),
+// so if most of the used slots are dead, we rehash at the same capacity instead
+// of growing, otherwise insert / remove churn would keep doubling the map forever.
+void Generic_Hash_Map_Make_Room_For_One(Generic_Hash_Map *hash_map, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location) {
+    u64 used = hash_map->dead_count + hash_map->count + 1;
+    if (used < Hash_Map_Max_Load(hash_map->layout, hash_map->capacity)) return;
+
+    if (hash_map->dead_count > 0 && hash_map->dead_count >= hash_map->count) {
+        Hash_Map_Resize(hash_map, hash_map->capacity, properties, caller_location);
+    } else {
+        Hash_Map_Maybe_Grow(hash_map, used, properties, caller_location);
+    }
+}
 
 
-// ===================================================
-//                      Misc
-// ===================================================
 
-// these are just useful, dont have to make these every single project.
-typedef Array(s64)    Int_Array;
+// Generic_Hash_Map_Get(), when the hash is allready known.
+internal void *Hash_Map_Get_With_Hash(Generic_Hash_Map *hash_map, void *key, u64 key_hash, Hash_Map_Key_Value_Type_Properties properties) {
+    u64 slot = Hash_Map_Find_Slot(hash_map, key, key_hash, properties, NULL);
+    if (slot != HASH_MAP_NO_SLOT) return Hash_Map_Slot_Value(hash_map, slot, properties);
 
+    // might not have been moved yet.
+    u64 old_slot = Hash_Map_Old_Table_Find_Slot(hash_map, key, key_hash, properties);
+    if (old_slot == HASH_MAP_NO_SLOT) return NULL;
 
-// will return malloc'd string if arena is NULL,
-String Read_Entire_File(String filename, Arena *arena);
+    Generic_Hash_Map old_table = Hash_Map_Old_Table(hash_map);
+    return Hash_Map_Slot_Value(&old_table, old_slot, properties);
+}
 
-// only works on unix.
-u64 nanoseconds_since_unspecified_epoch(void);
+void *Generic_Hash_Map_Get(Generic_Hash_Map *hash_map, void *key, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(hash_map);
+    ASSERT(key);
 
-bool check_if_file_exists(const char *filepath);
+    u64 key_hash = Hash_Map_Safely_Get_Hash(hash_map, key, properties);
+    return Hash_Map_Get_With_Hash(hash_map, key, key_hash, properties);
+}
 
+internal void *Generic_Hash_Map_Put_Or_Get_Default_Helper(Generic_Hash_Map *hash_map, void *key, bool set_default, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location) {
+    ASSERT(hash_map);
+    ASSERT(key);
 
+    u64 key_hash = Hash_Map_Safely_Get_Hash(hash_map, key, properties);
 
-// ===================================================
-//                 Debug Helpers
-// ===================================================
+    // this might grow the map, or just get rid of the dead slots.
+    Generic_Hash_Map_Make_Room_For_One(hash_map, properties, caller_location);
 
-// extremely annoyed that we have to pass pointers in here.
-//
-// _Generic() is just terrible.
+    // must be space to put this new thing.
+    ASSERT(hash_map->capacity > 0);
 
-const char *print_s64   (void *_x);
-const char *print_u64   (void *_x);
+    // every insert pays for a bit of the resize, (if there is one).
+    Hash_Map_Resize_Step(hash_map, HASH_MAP_RESIZE_STEP, properties);
 
-const char *print_s32   (void *_x);
-const char *print_u32   (void *_x);
+    u64 insert_slot;
+    u64 slot = Hash_Map_Find_Slot(hash_map, key, key_hash, properties, &insert_slot);
 
-const char *print_s16   (void *_x);
-const char *print_u16   (void *_x);
+    if (slot == HASH_MAP_NO_SLOT) {
+        // its allready in here, just hasn't been moved yet. it will be.
+        u64 old_slot = Hash_Map_Old_Table_Find_Slot(hash_map, key, key_hash, properties);
+        if (old_slot != HASH_MAP_NO_SLOT) {
+            Generic_Hash_Map old_table = Hash_Map_Old_Table(hash_map);
+            return Hash_Map_Slot_Value(&old_table, old_slot, properties);
+        }
+    }
 
-const char *print_s8    (void *_x);
-const char *print_u8    (void *_x);
+    if (slot == HASH_MAP_NO_SLOT) {
+        // we just grew the array, there must be somewhere to put it.
+        ASSERT(insert_slot != HASH_MAP_NO_SLOT);
+        slot = insert_slot;
 
-const char *print_f32   (void *_x);
-const char *print_f64   (void *_x);
+        Hash_Map_Slot_Fill(hash_map, slot, key_hash, properties);
+        // set key
+        Mem_Copy(Hash_Map_Slot_Key(hash_map, slot, properties), key, properties.key_size);
+        if (set_default) {
+            // set default value.
+            Mem_Copy(Hash_Map_Slot_Value(hash_map, slot, properties), (u8*)hash_map + properties.default_value_offset_in_hash_map, properties.value_size);
+        }
+    }
 
-const char *print_bool  (void *_x);
-const char *print_string(void *_x);
+    return Hash_Map_Slot_Value(hash_map, slot, properties);
+}
 
+void *Generic_Hash_Map_Get_Or_Default(Generic_Hash_Map *hash_map, void *key, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location) {
+    ASSERT(hash_map);
+    ASSERT(key);
 
+    return Generic_Hash_Map_Put_Or_Get_Default_Helper(hash_map, key, true, properties, caller_location);
+}
 
+void *Generic_Hash_Map_Put(Generic_Hash_Map *hash_map, void *key, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location) {
+    ASSERT(hash_map);
+    ASSERT(key);
 
-#define generic_to_str(x)                                                       \
-    _Generic(x,                                                                 \
-        s64: print_s64(&x),  u64: print_u64(&x),                                \
-        s32: print_s32(&x),  u32: print_u32(&x),                                \
-        s16: print_s16(&x),  u16: print_u16(&x),                                \
-        s8 : print_s8 (&x),  u8 : print_u8 (&x),                                \
-        f32: print_f32(&x),  f64: print_f64(&x),                                \
-        bool: print_bool(&x),                                                   \
-        String: print_string(&x),                                               \
-        char *: x, /* were just gonna assume this is null terminated... */      \
-        default: "?UNKNOWN_TYPE?"                                               \
-    )
+    return Generic_Hash_Map_Put_Or_Get_Default_Helper(hash_map, key, false, properties, caller_location);
+}
 
 
-#define debug(x)  do { Typeof(x) _x = (x); printf("DEBUG: %s = %s\n", #x, generic_to_str(_x)); } while (0)
+bool Generic_Hash_Map_Contains(Generic_Hash_Map *hash_map, void *key, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(hash_map);
+    ASSERT(key);
 
-#define debug_break() asm("int3")
+    u64 key_hash = Hash_Map_Safely_Get_Hash(hash_map, key, properties);
+    if (Hash_Map_Find_Slot(hash_map, key, key_hash, properties, NULL) != HASH_MAP_NO_SLOT) return true;
+    return Hash_Map_Old_Table_Find_Slot(hash_map, key, key_hash, properties) != HASH_MAP_NO_SLOT;
+}
 
 
+// how many keys Hash_Map_Get_Many() has in flight at once,
+// enough to keep the memory system busy, not so many the prefetches get evicted.
+#define HASH_MAP_BATCH_SIZE     32
 
+// the first cache line a lookup for this hash is gonna touch.
+internal inline void *Hash_Map_Probe_Start(Generic_Hash_Map *hash_map, u64 hash, Hash_Map_Key_Value_Type_Properties properties) {
+    u64 slot = hash & (hash_map->capacity - 1);
 
+    switch (hash_map->layout) {
+        case Hash_Map_Layout_Control_Bytes: {
+            u64 group_index = (hash >> 7) & (hash_map->capacity / HASH_MAP_GROUP_SIZE - 1);
+            return Hash_Map_Control_Bytes(hash_map, properties) + group_index * HASH_MAP_GROUP_SIZE;
+        }
+        case Hash_Map_Layout_Split:         return Hash_Map_Slot_Hash_Ptr(hash_map, slot, properties);
+        case Hash_Map_Layout_Ordered:       return Hash_Map_Ordered_Indices(hash_map, properties) + slot * Hash_Map_Ordered_Index_Width(hash_map->capacity);
+        case Hash_Map_Layout_Default:
+        case Hash_Map_Layout_Robin_Hood:    return Hash_Map_Slot_Entry(hash_map, slot, properties);
+    }
+    UNREACHABLE();
+}
 
+// for the control bytes, once the group is here, the entry the first match points at.
+internal inline void Hash_Map_Prefetch_Control_Bytes_Match(Generic_Hash_Map *hash_map, u64 hash, Hash_Map_Key_Value_Type_Properties properties) {
+    u64 group_index = (hash >> 7) & (hash_map->capacity / HASH_MAP_GROUP_SIZE - 1);
+    u32 matches = Hash_Map_Group_Match(Hash_Map_Control_Bytes(hash_map, properties) + group_index * HASH_MAP_GROUP_SIZE, HASH_MAP_CONTROL_FROM_HASH(hash));
+    if (matches) __builtin_prefetch(Hash_Map_Slot_Entry(hash_map, group_index * HASH_MAP_GROUP_SIZE + __builtin_ctz(matches), properties));
+}
 
-#endif // BESTED_H
+// Get_Many() and Contains_Many(), either output can be NULL.
+internal void Hash_Map_Lookup_Many(Generic_Hash_Map *hash_map, void *keys, u64 count, void **values_out, bool *results_out, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(hash_map);
+    ASSERT(keys || count == 0);
 
+    u64 hashes[HASH_MAP_BATCH_SIZE];
 
+    for (u64 batch_start = 0; batch_start < count; batch_start += HASH_MAP_BATCH_SIZE) {
+        u64 batch_count = Min(count - batch_start, (u64)HASH_MAP_BATCH_SIZE);
+        u8 *batch_keys  = (u8*)keys + batch_start * properties.key_size;
 
+        // hash everything, and ask for the memory, dont wait for it.
+        for (u64 i = 0; i < batch_count; i++) {
+            hashes[i] = Hash_Map_Safely_Get_Hash(hash_map, batch_keys + i * properties.key_size, properties);
+        }
+        // gcc likes to throw away a __builtin_prefetch() thats behind a branch,
+        // so work out the address first, and prefetch it every time.
+        if (hash_map->capacity) {
+            for (u64 i = 0; i < batch_count; i++) {
+                __builtin_prefetch(Hash_Map_Probe_Start(hash_map, hashes[i], properties));
+                // split keeps the keys somewhere else.
+                if (hash_map->layout == Hash_Map_Layout_Split) {
+                    __builtin_prefetch(Hash_Map_Slot_Key(hash_map, hashes[i] & (hash_map->capacity - 1), properties));
+                }
+            }
+        }
 
+        // the control bytes have one more hop, the first groups are probably here by now.
+        if (hash_map->capacity && hash_map->layout == Hash_Map_Layout_Control_Bytes) {
+            for (u64 i = 0; i < batch_count; i++) Hash_Map_Prefetch_Control_Bytes_Match(hash_map, hashes[i], properties);
+        }
 
-#ifdef BESTED_IMPLEMENTATION
+        // now the normal lookups, most of the misses are allready on there way.
+        for (u64 i = 0; i < batch_count; i++) {
+            void *value = Hash_Map_Get_With_Hash(hash_map, batch_keys + i * properties.key_size, hashes[i], properties);
+            if (values_out)  values_out [batch_start + i] = value;
+            if (results_out) results_out[batch_start + i] = value != NULL;
+        }
+    }
+}
 
+void Generic_Hash_Map_Get_Many(Generic_Hash_Map *hash_map, void *keys, u64 count, void **values_out, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(values_out || count == 0);
+    Hash_Map_Lookup_Many(hash_map, keys, count, values_out, NULL, properties);
+}
 
-#include <string.h>
-#include <stdarg.h>
+void Generic_Hash_Map_Contains_Many(Generic_Hash_Map *hash_map, void *keys, u64 count, bool *results_out, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(results_out || count == 0);
+    Hash_Map_Lookup_Many(hash_map, keys, count, NULL, results_out, properties);
+}
 
+void Generic_Hash_Map_Clear(Generic_Hash_Map *hash_map, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(hash_map);
 
+    // nothing in the old table matters anymore.
+    if (Hash_Map_Is_Resizing(hash_map)) {
+        if (!hash_map->allocator) BESTED_FREE(hash_map->resizing.entries);
+        hash_map->resizing = (Hash_Map_Resize_State){0};
+    }
 
-// ===================================================
-//               Source Code Location
-// ===================================================
+    Hash_Map_Clear_Slots(hash_map, properties);
 
-bool source_code_location_eq(Source_Code_Location a, Source_Code_Location b) {
-    if (a.line != b.line) return false;
-    // this should work, the pointer would be the same.
-    if (a.file != b.file) return false;
-    // strcmp(a.file, b.file) == 0;
-    return true;
+    hash_map->count = 0;
+    hash_map->dead_count = 0;
 }
 
+void Generic_Hash_Map_Free(Generic_Hash_Map *hash_map) {
+    ASSERT(hash_map);
 
+    if (hash_map->allocator) {
+        fprintf(stderr, "=======================================================================================\n");
+        fprintf(stderr, "Are you serious?\n");
+        fprintf(stderr, "\n");
+        fprintf(stderr, "Did you just attempt to free a hash_map that was allready given an allocator?\n");
+        fprintf(stderr, "Not just any allocator either, the only thing hash_maps accept are arena allocators.\n");
+        fprintf(stderr, "\n");
+        fprintf(stderr, "You know I do this for you right?\n");
+        fprintf(stderr, "I give you all these tools and this is what you do with it?\n");
+        fprintf(stderr, "Make a mistake that could have easily been ignored, look into this function you just called.\n");
+        fprintf(stderr, "I can check if you have an allocator and just ignore it, but I wont.\n");
+        fprintf(stderr, "\n");
+        fprintf(stderr, "I'm not gonna even ASSERT(false).\n");
+        fprintf(stderr, "I'm gonna let the segmentation falt, or the subtle memory bug do the talking for me.\n");
+        fprintf(stderr, "\n");
+        fprintf(stderr, "I hope you have a terrible day.\n");
+        fprintf(stderr, "=======================================================================================\n");
+    }
+    BESTED_FREE(hash_map->entries);
+    hash_map->entries = NULL;
 
-// ===================================================
-//        Useful Memory Manipulation Functions
-// ===================================================
+    BESTED_FREE(hash_map->resizing.entries);
+    hash_map->resizing = (Hash_Map_Resize_State){0};
 
-bool Mem_Is_Aligned(void *ptr, u64 alignment) {
-    static_assert(sizeof(u64) >= sizeof(void*), "doing math with pointers");
-    return ((u64)ptr) % alignment == 0;
+    hash_map->count      = 0;
+    hash_map->dead_count = 0;
+    hash_map->capacity   = 0;
 }
 
-u64 Mem_Align_Forward(u64 size, u64 alignment) {
-    return Div_Ceil(size, alignment)  * alignment;
-}
-u64 Mem_Align_Back(u64 size, u64 alignment) {
-    return Div_Floor(size, alignment) * alignment;
-}
+void Generic_Hash_Map_Reserve(Generic_Hash_Map *hash_map, u64 num_to_reserve, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location) {
+    ASSERT(hash_map);
 
-void *Mem_Byte_Offset(void *ptr, s64 bytes) {
-    u8 *ptr_u8 = (u8*)ptr;
-    return (void*)(ptr_u8 + bytes);
+    Hash_Map_Maybe_Grow(hash_map, num_to_reserve, properties, caller_location);
 }
 
-s64 Mem_Ptr_Diff(void *ptr1, void *ptr2) {
-    static_assert(sizeof(u64) >= sizeof(void*), "I HATE 128-Bit pointers");
-    u64 ptr1_u64 = Ptr_To_U64(ptr1);
-    u64 ptr2_u64 = Ptr_To_U64(ptr2);
+void Generic_Hash_Map_Shrink_To_Fit(Generic_Hash_Map *hash_map, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location) {
+    ASSERT(hash_map);
 
-    if (ptr1_u64 >= ptr2_u64) {
-        return (s64) (ptr1_u64 - ptr2_u64);
-    } else {
-        u64 result = ptr2_u64 - ptr1_u64;
-        return -((s64) result);
+    if (hash_map->capacity == 0) return;
+
+    // shrinking is allways all at once.
+    Hash_Map_Finish_Resize(hash_map, properties);
+
+    if (hash_map->count == 0) {
+        // nothing in here, dont need any memory.
+        if (!hash_map->allocator) BESTED_FREE(hash_map->entries);
+        hash_map->entries    = NULL;
+        hash_map->capacity   = 0;
+        hash_map->dead_count = 0;
+        return;
     }
-}
 
+    u64 new_capacity = Hash_Map_Capacity_For(hash_map, hash_map->count);
 
-void *Mem_Copy(void *dest, void *src, u64 size) {
-    return memcpy(dest, src, size);
-}
+    // if its the same size and nothing is dead, there's nothing to do.
+    if (new_capacity == hash_map->capacity && hash_map->dead_count == 0) return;
 
-void *Mem_Move(void *dest, void *src, u64 size) {
-    return memmove(dest, src, size);
+    Hash_Map_Rehash(hash_map, new_capacity, properties, caller_location);
 }
 
-void *Mem_Set (void *ptr, u8 value, u64 size) {
-    return memset(ptr, value, size);
-}
+bool Generic_Hash_Map_Remove(Generic_Hash_Map *hash_map, void *key, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(hash_map);
+    ASSERT(key);
 
-s32 Mem_Cmp (void *ptr1, void *ptr2, u64 count) {
-    return memcmp(ptr1, ptr2, count);
+    u64 key_hash = Hash_Map_Safely_Get_Hash(hash_map, key, properties);
+
+    bool removed = true;
+    u64 slot = Hash_Map_Find_Slot(hash_map, key, key_hash, properties, NULL);
+    if (slot == HASH_MAP_NO_SLOT) {
+        u64 old_slot = Hash_Map_Old_Table_Find_Slot(hash_map, key, key_hash, properties);
+        if (old_slot == HASH_MAP_NO_SLOT) {
+            removed = false;
+        } else {
+            Hash_Map_Old_Table_Kill(hash_map, old_slot, properties);
+        }
+    } else {
+        ASSERT(key_hash == Hash_Map_Slot_Hash(hash_map, slot, properties));
+        Hash_Map_Slot_Kill(hash_map, slot, properties);
+    }
+
+    // removes pay for a bit of the resize too, so a map that stops growing still finishes it.
+    // (after, so 'key' can still point into the old table.)
+    Hash_Map_Resize_Step(hash_map, HASH_MAP_RESIZE_STEP, properties);
+    return removed;
 }
 
+bool Generic_Hash_Map_Remove_By_Value(Generic_Hash_Map *hash_map, void *value_ptr, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(hash_map);
+    ASSERT(value_ptr);
 
+    if (Hash_Map_Old_Table_Owns(hash_map, value_ptr, properties)) {
+        Generic_Hash_Map old_table = Hash_Map_Old_Table(hash_map);
+        u64 old_slot = Hash_Map_Slot_Of_Value(&old_table, value_ptr, properties);
 
-// ===================================================
-//                      Arena
-// ===================================================
+        if (old_slot < hash_map->resizing.next_slot) return false;
+        if (Hash_Map_Hash_Is_Bad(Hash_Map_Slot_Hash(&old_table, old_slot, properties))) return false;
 
-internal Region *Arena_Internal_New_Region(u64 capacity_in_bytes) {
-    Region *new_region = (Region*) BESTED_MALLOC(sizeof(Region) + capacity_in_bytes);
-    if (new_region) {
-        new_region->next                = NULL;
-        new_region->count_in_bytes      = 0;
-        new_region->capacity_in_bytes   = capacity_in_bytes;
-        new_region->do_not_free_this    = false;
+        Hash_Map_Old_Table_Kill(hash_map, old_slot, properties);
+        return true;
     }
-    return new_region;
+
+    u64 slot = Hash_Map_Slot_Of_Value(hash_map, value_ptr, properties);
+
+    // would be super weird if this was the case.
+    if (Hash_Map_Hash_Is_Bad(Hash_Map_Slot_Hash(hash_map, slot, properties))) return false;
+
+    Hash_Map_Slot_Kill(hash_map, slot, properties);
+    return true;
 }
 
-internal void Arena_Internal_Free_Region(Region *region) {
-    if (!region->do_not_free_this) BESTED_FREE(region);
+
+void *Generic_Hash_Map_Key_For(Generic_Hash_Map *hash_map, void *value_ptr, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(hash_map);
+    ASSERT(value_ptr);
+
+    if (Hash_Map_Old_Table_Owns(hash_map, value_ptr, properties)) {
+        Generic_Hash_Map old_table = Hash_Map_Old_Table(hash_map);
+        return Hash_Map_Slot_Key(&old_table, Hash_Map_Slot_Of_Value(&old_table, value_ptr, properties), properties);
+    }
+
+    u64 slot = Hash_Map_Slot_Of_Value(hash_map, value_ptr, properties);
+    return Hash_Map_Slot_Key(hash_map, slot, properties);
 }
 
-// inline because there is really nothing in this function.
-// just some funny casts, and a call to Mem_Set()
-internal inline void *Arena_Internal_Get_New_Memory_At_Last_Region(Arena *arena, u64 size_in_bytes, u64 alignment, bool clear_to_zero) {
-    u64 aligned_ptr_u64 = Mem_Align_Forward(Ptr_To_U64(arena->last->data + arena->last->count_in_bytes), alignment);
-    // u64 aligned_ptr_u64 = Ptr_To_U64(arena->last->data + arena->last->count_in_bytes);
+// returns if we should continue runing
+//
+// while resizing, the new table goes first, then whatever
+// hasn't been moved out of the old one yet.
+bool Generic_Hash_Map_For_Each_Iterator_Next(Generic_Hash_Map *hash_map, void **current_value, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(hash_map);
+    ASSERT(current_value);
+
+    Generic_Hash_Map old_table = Hash_Map_Old_Table(hash_map);
+    bool in_old_table = *current_value && Hash_Map_Old_Table_Owns(hash_map, *current_value, properties);
+
+    u64 slot;
+    if (in_old_table) {
+        slot = Hash_Map_Slot_Of_Value(&old_table, *current_value, properties) + 1;
+    } else if (*current_value == NULL) {
+        // this is the start of the iteration.
+        // return first element.
+        slot = 0;
+    } else {
+        // also move 1 along.
+        slot = Hash_Map_Slot_Of_Value(hash_map, *current_value, properties) + 1;
+    }
+
+    // while the entry is empty. continue.
+    if (!in_old_table) {
+        u64 end = Hash_Map_Slot_End(hash_map);
+        while (slot < end && Hash_Map_Hash_Is_Bad(Hash_Map_Slot_Hash(hash_map, slot, properties))) {
+            slot += 1;
+        }
 
-    s64 how_far_forward = Mem_Ptr_Diff(U64_To_Ptr(aligned_ptr_u64), arena->last->data + arena->last->count_in_bytes);
-    ASSERT(how_far_forward >= 0);
+        if (slot < end) {
+            *current_value = Hash_Map_Slot_Value(hash_map, slot, properties);
+            return true;
+        }
 
-    // lets hope this doesn't happen.
-    if (arena->last->count_in_bytes + how_far_forward + size_in_bytes > arena->last->capacity_in_bytes) {
-        return NULL;
+        if (!Hash_Map_Is_Resizing(hash_map)) return false;
+        // on to the old table, the moved part is all stale.
+        slot = hash_map->resizing.next_slot;
     }
 
+    while (slot < old_table.capacity && Hash_Map_Hash_Is_Bad(Hash_Map_Slot_Hash(&old_table, slot, properties))) {
+        slot += 1;
+    }
 
-    if (clear_to_zero) Mem_Zero(U64_To_Ptr(aligned_ptr_u64), size_in_bytes);
+    if (slot >= old_table.capacity) return false;
 
-    arena->last->count_in_bytes += size_in_bytes + (u64) how_far_forward;
-    ASSERT(arena->last->count_in_bytes <= arena->last->capacity_in_bytes);
-    return U64_To_Ptr(aligned_ptr_u64);
+    *current_value = Hash_Map_Slot_Value(&old_table, slot, properties);
+    return true;
 }
 
 
-void *_Arena_Alloc(Arena *arena, u64 size_in_bytes, Arena_Alloc_Opt opt, Source_Code_Location caller_location) {
-    // TODO track allocations.
 
-    u64 default_size = (arena->minimum_allocation_size != 0) ? arena->minimum_allocation_size : ARENA_REGION_DEFAULT_CAPACITY;
+//
+// Hash_Map_Stats()
+//
 
-    // add the extra alignment because if you have to allocate the thing,
-    // the alignment of the Region is kinda random, with + alignment, the allocation will always succeed.
-    u64 to_alloc_if_no_room = Max(default_size, size_in_bytes + opt.alignment);
+// how many probes Hash_Map_Find_Slot() takes to get to this slot, (the key is allready in there).
+internal u64 Hash_Map_Probe_Length(Generic_Hash_Map *hash_map, u64 slot, Hash_Map_Key_Value_Type_Properties properties) {
+    u64 hash   = Hash_Map_Slot_Hash(hash_map, slot, properties);
+    u64 mask   = hash_map->capacity - 1;
+    u64 length = 1;
 
-    // if the arena currently holds no memory
-    if (arena->last == NULL) {
-        if (arena->first != NULL) {
-            ARENA_PANIC(caller_location, "arena->first != NULL, only these library functions should touch the insides of an arena.");
-            return NULL;
-        }
+    switch (hash_map->layout) {
+        case Hash_Map_Layout_Robin_Hood: return Hash_Map_Probe_Distance(hash, slot, mask) + 1;
 
-        if (arena->panic_when_trying_to_allocate_new_page) {
-            ARENA_PANIC(caller_location, "Arena_alloc: attempted to allocate new memory, but that has been disallowed. (when there was no memory to begin with.)");
-            return NULL;
+        case Hash_Map_Layout_Control_Bytes: {
+            u64 group_mask  = hash_map->capacity / HASH_MAP_GROUP_SIZE - 1;
+            u64 group_index = (hash >> 7) & group_mask;
+            for (u64 step = 1; group_index != slot / HASH_MAP_GROUP_SIZE; step++, length++) group_index = (group_index + step) & group_mask;
+            return length;
         }
 
-        arena->last = Arena_Internal_New_Region(to_alloc_if_no_room);
-        if (arena->last == NULL) {
-            if (arena->dont_panic_when_allocation_failure) return NULL;
-            ARENA_PANIC(caller_location, "Arena_alloc: attempted to allocate new memory, got null. (when there was no memory to begin with.)");
-            return NULL;
+        case Hash_Map_Layout_Ordered: {
+            // the probing is in the index table.
+            u8 *indices = Hash_Map_Ordered_Indices(hash_map, properties);
+            u64 width   = Hash_Map_Ordered_Index_Width(hash_map->capacity);
+            u64 index_slot = hash & mask;
+            for (u64 increment = 1; Hash_Map_Ordered_Index_Get(indices, width, index_slot) != slot + 1; increment++, length++) index_slot = (index_slot + increment) & mask;
+            return length;
         }
 
-        arena->first = arena->last;
-
-        void *new_memory = Arena_Internal_Get_New_Memory_At_Last_Region(arena, size_in_bytes, opt.alignment, opt.clear_to_zero);
-        if (!new_memory) {
-            ARENA_PANIC(caller_location, "new_memory from internal allocator returned null wtf.");
+        case Hash_Map_Layout_Default:
+        case Hash_Map_Layout_Split: {
+            u64 probe = hash & mask;
+            for (u64 increment = 1; probe != slot; increment++, length++) probe = (probe + increment) & mask;
+            return length;
         }
-        return new_memory;
     }
+    UNREACHABLE();
+}
 
-    // find room, or find the end
-    while ((arena->last->count_in_bytes + size_in_bytes + opt.alignment > arena->last->capacity_in_bytes) && (arena->last->next != NULL)) {
-        arena->last = arena->last->next;
-        if (arena->last) {
-            // if we just discoverd this, it must be zero'd.
-            // this helps with our mark implementation as well.
-            arena->last->count_in_bytes = 0;
-        }
+// if this slot of the probed table is anything but empty.
+internal bool Hash_Map_Probe_Slot_Used(Generic_Hash_Map *hash_map, u64 slot, Hash_Map_Key_Value_Type_Properties properties) {
+    switch (hash_map->layout) {
+        case Hash_Map_Layout_Control_Bytes: return Hash_Map_Control_Bytes(hash_map, properties)[slot] != HASH_MAP_CONTROL_EMPTY;
+        case Hash_Map_Layout_Ordered:       return Hash_Map_Ordered_Index_Get(Hash_Map_Ordered_Indices(hash_map, properties), Hash_Map_Ordered_Index_Width(hash_map->capacity), slot) != 0;
+        case Hash_Map_Layout_Default:
+        case Hash_Map_Layout_Split:
+        case Hash_Map_Layout_Robin_Hood:    return *Hash_Map_Slot_Hash_Ptr(hash_map, slot, properties) != Hash_Map_UNALLOCATED;
     }
+    UNREACHABLE();
+}
 
-    if (arena->last->count_in_bytes + size_in_bytes + opt.alignment <= arena->last->capacity_in_bytes) {
-        // if there is space alloc
-        void *new_memory = Arena_Internal_Get_New_Memory_At_Last_Region(arena, size_in_bytes, opt.alignment, opt.clear_to_zero);
-        if (!new_memory) {
-            ARENA_PANIC(caller_location, "new_memory from internal allocator returned null wtf.");
-        }
-        return new_memory;
+Hash_Map_Stats Generic_Hash_Map_Stats(Generic_Hash_Map *hash_map, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(hash_map);
 
-    } else {
-        // we need a new region
+    Hash_Map_Stats stats = {
+        .count      = hash_map->count,
+        .dead_count = hash_map->dead_count,
+        .capacity   = hash_map->capacity,
+    };
+    if (hash_map->capacity == 0) return stats;
 
-        if (arena->last->next != NULL) {
-            ARENA_PANIC(caller_location, "arena->last->next != NULL, only these library functions should touch the insides of an arena, and they should never produce this state.");
-            return NULL;
-        }
+    stats.load_factor = (f64)hash_map->count      / hash_map->capacity;
+    stats.dead_ratio  = (f64)hash_map->dead_count / hash_map->capacity;
 
-        if (arena->panic_when_trying_to_allocate_new_page) {
-            ARENA_PANIC(caller_location, "Arena_alloc: attempted to allocate new memory, but that has been disallowed.");
-            return NULL;
+    u64 keys = 0, total_probes = 0;
+    for (u64 slot = 0; slot < Hash_Map_Slot_End(hash_map); slot++) {
+        if (Hash_Map_Hash_Is_Bad(Hash_Map_Slot_Hash(hash_map, slot, properties))) continue;
+
+        u64 length = Hash_Map_Probe_Length(hash_map, slot, properties);
+        keys         += 1;
+        total_probes += length;
+        stats.max_probe_length = Max(stats.max_probe_length, length);
+        stats.probe_length_histogram[Min(length, (u64)HASH_MAP_STATS_HISTOGRAM_SIZE + 1) - 1] += 1;
+    }
+    if (keys) stats.mean_probe_length = (f64)total_probes / keys;
+
+    // runs of used slots, (one that wraps around the end counts as two).
+    u64 run = 0, total_run = 0;
+    for (u64 slot = 0; slot <= hash_map->capacity; slot++) {
+        if (slot < hash_map->capacity && Hash_Map_Probe_Slot_Used(hash_map, slot, properties)) {
+            run += 1;
+            continue;
         }
+        if (run == 0) continue;
 
-        Region *last_last = arena->last;
+        stats.cluster_count   += 1;
+        stats.max_cluster_size = Max(stats.max_cluster_size, run);
+        total_run += run;
+        run = 0;
+    }
+    if (stats.cluster_count) stats.mean_cluster_size = (f64)total_run / stats.cluster_count;
 
-        arena->last = Arena_Internal_New_Region(to_alloc_if_no_room);
-        if (arena->last == NULL) {
-            if (arena->dont_panic_when_allocation_failure) return NULL;
-            ARENA_PANIC(caller_location, "Arena_alloc: attempted to allocate new memory, got null.");
-        }
-        last_last->next = arena->last;
+    return stats;
+}
 
+void Hash_Map_Print_Stats(Hash_Map_Stats *stats) {
+    ASSERT(stats);
 
-        void *new_memory = Arena_Internal_Get_New_Memory_At_Last_Region(arena, size_in_bytes, opt.alignment, opt.clear_to_zero);
-        if (!new_memory) {
-            ARENA_PANIC(caller_location, "new_memory from internal allocator returned null wtf.");
-        }
-        return new_memory;
+    printf("count %zu, dead %zu, capacity %zu, (load %.2f, dead %.2f)\n", stats->count, stats->dead_count, stats->capacity, stats->load_factor, stats->dead_ratio);
+    printf("probe length: mean %.2f, max %zu\n", stats->mean_probe_length, stats->max_probe_length);
+    for (u64 i = 0; i < Array_Len(stats->probe_length_histogram); i++) {
+        if (stats->probe_length_histogram[i] == 0) continue;
+        printf("    %3zu%-2s %zu\n", i + 1, (i == HASH_MAP_STATS_HISTOGRAM_SIZE) ? "+:" : ":", stats->probe_length_histogram[i]);
     }
+    printf("clusters: %zu, mean size %.2f, max size %zu\n", stats->cluster_count, stats->mean_cluster_size, stats->max_cluster_size);
 }
 
+#ifdef HASH_MAP_COUNT_PROBES
+_Thread_local Hash_Map_Probe_Counts hash_map_probe_counts = {0};
 
-
-Arena_Mark Arena_Get_Mark(Arena *arena) {
-    Arena_Mark result = {
-        .last = arena->last,
-        .count = arena->last ? arena->last->count_in_bytes : 0,
-    };
-    return result;
+Hash_Map_Probe_Counts Hash_Map_Get_Probe_Counts(void) {
+    // the lookup thats going on now hasn't made it into max_probes yet.
+    Hash_Map_Probe_Counts counts = hash_map_probe_counts;
+    counts.max_probes = Max(counts.max_probes, counts.this_lookup);
+    return counts;
 }
-void Arena_Set_To_Mark(Arena *arena, Arena_Mark mark) {
-    arena->last = mark.last ? mark.last : arena->first;
-    if (arena->last) {
-        arena->last->count_in_bytes = mark.count;
-    }
+
+void Hash_Map_Reset_Probe_Counts(void) {
+    hash_map_probe_counts = (Hash_Map_Probe_Counts){0};
 }
+#endif
 
 
-void _Arena_Initialize_First_Page(Arena *arena, u64 first_page_size_in_bytes, Source_Code_Location caller_location) {
-    if (arena->first != NULL) return;
 
-    u64 tmp_min_alloc_size = arena->minimum_allocation_size;
-    arena->minimum_allocation_size = first_page_size_in_bytes;
 
-    _Arena_Alloc(
-        arena, 0,
-        (Arena_Alloc_Opt){.alignment = Default_Alignment, .clear_to_zero = false, },
-        caller_location
-    );
+bool Generic_Hash_Set_Add(Generic_Hash_Map *hash_set, void *key, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location) {
+    ASSERT(hash_set);
+    ASSERT(key);
 
-    arena->minimum_allocation_size = tmp_min_alloc_size;
+    u64 count_before = hash_set->count;
+    Generic_Hash_Map_Put(hash_set, key, properties, caller_location);
+    return hash_set->count > count_before;
 }
 
+void Generic_Hash_Set_Union(Generic_Hash_Map *hash_set, Generic_Hash_Map *other, Hash_Map_Key_Value_Type_Properties properties, Hash_Map_Key_Value_Type_Properties other_properties, Source_Code_Location caller_location) {
+    ASSERT(hash_set && other);
 
-void _Arena_Add_Buffer_As_Storage_Space(Arena *arena, void *buffer, u64 buffer_size_in_bytes, Source_Code_Location caller_location) {
-    if (buffer == NULL) {
-        ARENA_PANIC(caller_location, "Arena_Add_Buffer_As_Storeage_Space: buffer != NULL, why did you pass this to us.");
-        return;
+    // adding to the set we are looping over would be bad.
+    if (hash_set == other) return;
+
+    for (void *key = NULL; Generic_Hash_Map_For_Each_Iterator_Next(other, &key, other_properties); ) {
+        Generic_Hash_Map_Put(hash_set, key, properties, caller_location);
     }
-    if (buffer_size_in_bytes <= sizeof(Region)) {
-        ARENA_PANIC(caller_location, "Arena_Add_Buffer_As_Storeage_Space: buffer_size_in_bytes <= sizeof(Region), The passed in buffer must be big enough to contain the Region, preferably much bigger");
+}
+
+void Generic_Hash_Set_Keep_If(Generic_Hash_Map *hash_set, Generic_Hash_Map *other, bool keep_if_in_other, Hash_Map_Key_Value_Type_Properties properties, Hash_Map_Key_Value_Type_Properties other_properties) {
+    ASSERT(hash_set && other);
+
+    if (hash_set == other) {
+        if (!keep_if_in_other) Generic_Hash_Map_Clear(hash_set, properties);
         return;
     }
 
-    u64 real_allocatable_space = buffer_size_in_bytes - sizeof(Region);
-
-    Region *new_region = (Region*) buffer;
-    new_region->count_in_bytes      = 0;
-    new_region->capacity_in_bytes   = real_allocatable_space;
-    new_region->next                = NULL;
-    new_region->do_not_free_this    = true;
+    // only one table to walk.
+    Hash_Map_Finish_Resize(hash_set, properties);
 
+    for (u64 slot = 0; slot < Hash_Map_Slot_End(hash_set); ) {
+        if (!Hash_Map_Hash_Is_Bad(Hash_Map_Slot_Hash(hash_set, slot, properties))) {
+            // the other set might hash differently, so it does its own lookup.
+            bool in_other = Generic_Hash_Map_Contains(other, Hash_Map_Slot_Key(hash_set, slot, properties), other_properties);
 
-    if (arena->last == NULL) {
-        if (arena->first != NULL) {
-            ARENA_PANIC(caller_location, "Arena_Add_Buffer_As_Storeage_Space: arena->first != NULL, when arena->last == NULL, something went wrong internally");
+            if (in_other != keep_if_in_other) {
+                Hash_Map_Slot_Kill(hash_set, slot, properties);
+                // robin hood just pulled the next one back into this slot, look at it again.
+                if (hash_set->layout == Hash_Map_Layout_Robin_Hood) continue;
+            }
         }
-        arena->first = new_region;
-        arena->last  = new_region;
-
-    } else {
-        Region *p;
-        for (p = arena->last; p->next != NULL; p = p->next);
-        p->next = new_region;
+        slot += 1;
     }
 }
 
 
-const char *Arena_sprintf(Arena *arena, const char *format, ...) {
-    char *buf    = NULL;
-    u64 buf_size = 0;
-
-    if (arena->last != NULL) {
-        buf      = (char*) (arena->last->data + arena->last->count_in_bytes);
-        buf_size = arena->last->capacity_in_bytes - arena->last->count_in_bytes;
-    }
-
-    va_list args;
 
-    va_start(args, format);
-        s64 formatted_size = vsnprintf(buf, buf_size, format, args);
-    va_end(args);
+// unaligned reads, the compiler turns these into a single load.
+internal inline u64 Hash_Read_8(void *p) { u64 result; __builtin_memcpy(&result, p, 8); return result; }
+internal inline u64 Hash_Read_4(void *p) { u32 result; __builtin_memcpy(&result, p, 4); return result; }
 
-    if (formatted_size < 0) {
-        // TODO ? accept file and line here? i never use this function anyway...
-        ARENA_PANIC(Get_Source_Code_Location(), "Arena_sprintf: format was not successful");
-        return NULL;
-    }
+u64 Hash_Map_Default_Hash_Function(void *key, u64 size) {
+    ASSERT(key);
 
-    // i dont know if this should be <= or just <, hmm...
-    if ((u64)formatted_size < buf_size) {
-        // the string fits!
-        // advance the count. +1 because we need the null terminator for this one.
-        arena->last->count_in_bytes += (u64)formatted_size+1;
-        return buf;
+    return Hash_Map_Default_Seeded_Hash_Function(key, size, 0);
+}
+u64 Hash_Map_Default_Seeded_Hash_Function(void *key, u64 size, u64 seed) {
+    ASSERT(key);
 
+    // most keys are ints, they dont need the whole thing.
+    if (size == sizeof(u64)) return Hash_u64(Hash_Read_8(key), seed);
+    if (size == sizeof(u32)) return Hash_u32(Hash_Read_4(key), seed);
 
-    } else {
-        // else we need to allocate some space.
+    return Hash_Function_wyhash(key, size, seed);
+}
+bool Hash_Map_Default_Equality_Function(void *key_a, void *key_b, u64 size) {
+    ASSERT(key_a && key_b);
 
-        buf      = (char*)Arena_Alloc(arena, (u64)formatted_size+1, .clear_to_zero = false);
-        // buf      = (char*)Arena_Alloc_Clear(arena, (u64)formatted_size+1, false);
-        buf_size = (u64)formatted_size+1;
+    // same deal, ints dont need a Mem_Cmp().
+    if (size == sizeof(u64)) return Hash_Read_8(key_a) == Hash_Read_8(key_b);
+    if (size == sizeof(u32)) return Hash_Read_4(key_a) == Hash_Read_4(key_b);
 
-        // only happens when Arena_Alloc either returns null because it was
-        // allowed to return null, or it panic'd (and the panic function was
-        // replaced with something that doesn't abort), either way the user
-        // of this function will expect this to maybe be null.
-        if (!buf) return NULL;
+    return Mem_Eq(key_a, key_b, size);
+}
 
-        va_start(args, format);
-            vsnprintf(buf, buf_size, format, args);
-        va_end(args);
 
-        return buf;
-    }
+u64 Hash_Map_Hash_String  (void *key, u64 size) {
+    return Hash_Map_Seeded_Hash_String(key, size, 0);
 }
+u64 Hash_Map_Seeded_Hash_String(void *key, u64 size, u64 seed) {
+    ASSERT(key);
+    ASSERT(size == sizeof(String));
 
+    String *string = key;
+    return Hash_Function_wyhash(string->data, string->length, seed);
+}
+bool Hash_Map_Eq_String(void *key_a, void *key_b, u64 size) {
+    ASSERT(key_a && key_b);
+    ASSERT(size == sizeof(String));
 
-void Arena_Clear(Arena *arena) {
-    if (arena->first == NULL) return;
+    String *string_a = key_a;
+    String *string_b = key_b;
+    return String_Eq(*string_a, *string_b);
+}
 
-    for (Region *r = arena->first; r != arena->last; r = r->next) {
-        r->count_in_bytes = 0;
-    }
-    arena->last->count_in_bytes = 0;
 
-    arena->last = arena->first;
+u64 Hash_Map_Hash_C_String  (void *key, u64 size) {
+    return Hash_Map_Seeded_Hash_C_String(key, size, 0);
 }
+u64 Hash_Map_Seeded_Hash_C_String(void *key, u64 size, u64 seed) {
+    ASSERT(key);
+    ASSERT(size == sizeof(const char *));
 
-void Arena_Free (Arena *arena) {
-    // this is slightly more complicated than it would be,
-    // but you cant use the thing you just free'd, for some reason,
-    // because it get's messed with by 'free'
-    Region *r = arena->first;
-    while (r) {
-        Region *next = r->next;
-        Arena_Internal_Free_Region(r);
-        r = next;
-    }
+    const char **c_str = key;
+    return Hash_C_String(*c_str, seed, NULL);
+}
+bool Hash_Map_Eq_C_String(void *key_a, void *key_b, u64 size) {
+    ASSERT(key_a && key_b);
+    ASSERT(size == sizeof(const char *));
 
-    arena->first = NULL;
-    arena->last  = NULL;
+    const char **c_str_a = key_a;
+    const char **c_str_b = key_b;
+    // one pass, stops at the first difference.
+    return strcmp(*c_str_a, *c_str_b) == 0;
 }
 
 
+#if defined(__linux__)
+    #include <sys/random.h>
+#endif
 
-// ===================================================
-//                      Pool
-// ===================================================
+u64 Hash_Map_Random_Seed(void) {
+    u64 seed = 0;
+#if defined(__linux__)
+    if (getrandom(&seed, sizeof(seed), 0) == sizeof(seed)) return seed;
+#endif
+    // not great, but better than nothing. the address changes every run with ASLR.
+    seed = Hash_u64(nanoseconds_since_unspecified_epoch(), (u64)&seed);
+    return seed;
+}
 
-Arena *Pool_Get(Arena_Pool *pool) {
-    while (true) {
-        for (u32 i = 0; i < NUM_POOL_ARENAS; i++) {
-            if (Has_Bit(Atomic_Load(&pool->in_use_flags), i)) continue;
 
-            Pool_Flag_Type before = Atomic_Or(&pool->in_use_flags, Bit(i));
-            if (Has_Bit(before, i)) continue; // someone got to it first,
+u64 Hash_Function_wyhash(void *key, u64 size, u64 seed) {
+    // its ok for the key to be NULL here,
+    // could be hashing a string or something
+    if (size > 0) ASSERT(key);
 
-            Arena *new_arena = &pool->arena_pool[i];
-            Arena_Clear(new_arena);
-            return new_arena;
+    u8 *p = key;
+    seed ^= Hash_Mix(seed ^ HASH_SECRET_0, HASH_SECRET_1);
+
+    u64 a, b;
+    if (size <= 16) {
+        if (size >= 4) {
+            // 2 overlapping reads from each end covers 4 to 16 bytes.
+            u64 middle = (size >> 3) << 2;
+            a = (Hash_Read_4(p) << 32)            | Hash_Read_4(p + middle);
+            b = (Hash_Read_4(p + size - 4) << 32) | Hash_Read_4(p + size - 4 - middle);
+        } else if (size > 0) {
+            a = ((u64)p[0] << 16) | ((u64)p[size >> 1] << 8) | p[size - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        u64 i = size;
+        if (i >= 48) {
+            // 3 independent lanes, so the multiplies can overlap.
+            u64 seed_1 = seed, seed_2 = seed;
+            do {
+                seed   = Hash_Mix(Hash_Read_8(p)      ^ HASH_SECRET_1, Hash_Read_8(p + 8)  ^ seed);
+                seed_1 = Hash_Mix(Hash_Read_8(p + 16) ^ HASH_SECRET_2, Hash_Read_8(p + 24) ^ seed_1);
+                seed_2 = Hash_Mix(Hash_Read_8(p + 32) ^ HASH_SECRET_3, Hash_Read_8(p + 40) ^ seed_2);
+                p += 48; i -= 48;
+            } while (i >= 48);
+            seed ^= seed_1 ^ seed_2;
         }
-
-        Atomic(bool) *lock = &pool->creating_new_pool_in_chain_lock;
-        Atomic_Capture_Lock(lock) {
-            if (!pool->next_pool) {
-                pool->next_pool = (Arena_Pool*)BESTED_MALLOC(sizeof(Arena_Pool));
-                Mem_Zero(pool->next_pool, sizeof(Arena_Pool));
-            }
-            pool = pool->next_pool;
+        while (i > 16) {
+            seed = Hash_Mix(Hash_Read_8(p) ^ HASH_SECRET_1, Hash_Read_8(p + 8) ^ seed);
+            p += 16; i -= 16;
         }
+        // the last 16 bytes, (might overlap with what we allready did, thats fine).
+        a = Hash_Read_8(p + i - 16);
+        b = Hash_Read_8(p + i - 8);
     }
 
-    UNREACHABLE();
+    a ^= HASH_SECRET_1;
+    b ^= seed;
+    __uint128_t result = (__uint128_t)a * b;
+    return Hash_Mix((u64)result ^ HASH_SECRET_0 ^ size, (u64)(result >> 64) ^ HASH_SECRET_1);
 }
 
-void Pool_Release(Arena_Pool *pool, Arena *to_release) {
-    while (pool) {
-        s64 maybe_index = Mem_Ptr_Diff(to_release, pool->arena_pool);
-
-        if (Is_Between(maybe_index, 0, (s64) ((NUM_POOL_ARENAS-1) * sizeof(Arena)))) {
-            ASSERT(maybe_index % sizeof(Arena) == 0);
-            s64 index = maybe_index / sizeof(Arena);
+u64 Hash_Function_fnv1a(void *key, u64 size) {
+    // its ok for the key to be NULL here,
+    // could be hashing a string or something
+    if (size > 0) ASSERT(key);
 
-            ASSERT(Has_Bit( Atomic_Load(&pool->in_use_flags) , index));
-            Atomic_Xor(&pool->in_use_flags, Bit(index)); // clear the flag atomically.
-            return;
-        }
+    // 64 bit offset_basis = 14695981039346656037
+    const u64 FNV_offset = 14695981039346656037ULL;
+    // 64 bit FNV_prime = 2^40 + 2^8 + 0xb3 = 1099511628211
+    const u64 FNV_prime  =        1099511628211ULL;
 
-        Atomic(bool) *lock = &pool->creating_new_pool_in_chain_lock;
-        Atomic_Capture_Lock(lock) {
-            pool = pool->next_pool;
-        }
+    u8 *u8_ptr = key;
+    u64 hash = FNV_offset;
+    for (u64 i = 0; i < size; i++) {
+        hash = (hash ^ u8_ptr[i]) * FNV_prime;
     }
-    // Ran out of pools to check, to_release must not be an arena from this pool.
-    UNREACHABLE();
+    return hash;
 }
 
-void Pool_Free_Arenas(Arena_Pool *pool) {
-    // the user just passed up the original pool.
-    // dont free it, but free everything else
+// reads the string one aligned word at a time, an aligned read can never
+// cross into the next page, so its safe to read past the '\0', (this is
+// what every libc strlen() dose), but the sanitizer dosen't know that.
+//
+// the bytes get put back together in string order, so the hash
+// dosen't depend on where the string is in memory.
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+__attribute__((no_sanitize_address))
+u64 Hash_C_String(const char *c_str, u64 seed, u64 *length_out) {
+    ASSERT(c_str);
+
+    const u64 ONES  = 0x0101010101010101ULL;
+    const u64 HIGHS = 0x8080808080808080ULL;
+    #define Hash_Internal_Zero_Bytes(word) (((word) - ONES) & ~(word) & HIGHS)
+    // the low 'n' bytes of a word.
+    #define Hash_Internal_Low_Bytes(word, n) ((n) >= 8 ? (word) : (word) & ((1ULL << ((n) * 8)) - 1))
+
+    u64 offset = (uintptr_t)c_str & 7;
+    u64 shift  = offset * 8;
+    const u64 *word_ptr = (const u64*)(c_str - offset);
+
+    u64 state  = seed ^ HASH_SECRET_0;
+    u64 length = 0;
+    u64 tail;
+
+    // the bytes before the string could be 0, dont let them look like the end.
+    u64 first = *word_ptr++;
+    u64 zeros = Hash_Internal_Zero_Bytes(first | ((1ULL << shift) - 1));
+
+    if (zeros) {
+        length = (u64)__builtin_ctzll(zeros) / 8 - offset;
+        tail   = Hash_Internal_Low_Bytes(first >> shift, length);
+    } else {
+        // 'current' has the next (8 - offset) bytes of the string in its low bytes.
+        u64 current       = first >> shift;
+        u64 current_count = 8 - offset;
 
-    Arena_Pool *original_pool = pool;
+        // glue the bytes back together in string order.
+        #define Hash_Internal_Glue(current, next) ((current_count == 8) ? (current) : (current) | ((next) << (current_count * 8)))
 
-    // free all the arena's.
-    while (pool) {
-        for (u32 i = 0; i < NUM_POOL_ARENAS; i++) {
-            Arena_Free(&pool->arena_pool[i]);
+        // 'next' has the '\0', whats left is the rest of 'current' and the start of 'next'.
+        //
+        // the full chunks always get paired up the same way, (no matter where the
+        // words split the string), so 'pending' is the odd one out, if there is one.
+        #define Hash_Internal_Finish(current, next, has_pending, pending)                   \
+            do {                                                                            \
+                u64 _chunk     = Hash_Internal_Glue(current, next);                         \
+                u64 _remaining = current_count + (u64)__builtin_ctzll(zeros) / 8;           \
+                if (_remaining >= 8) {                                                      \
+                    if (has_pending) state = Hash_Mix((pending) ^ HASH_SECRET_1, _chunk ^ state); \
+                    else             state = Hash_Mix(_chunk ^ HASH_SECRET_1, state);       \
+                    length += 8;                                                            \
+                    _remaining -= 8;                                                        \
+                    tail = Hash_Internal_Low_Bytes((next) >> shift, _remaining);            \
+                } else {                                                                    \
+                    if (has_pending) state = Hash_Mix((pending) ^ HASH_SECRET_1, state);    \
+                    tail = Hash_Internal_Low_Bytes(_chunk, _remaining);                     \
+                }                                                                           \
+                length += _remaining;                                                       \
+            } while (0)
+
+        // 16 bytes per multiply, same as Hash_Function_wyhash().
+        while (true) {
+            u64 next_1 = *word_ptr++;
+            zeros = Hash_Internal_Zero_Bytes(next_1);
+            if (zeros) { Hash_Internal_Finish(current, next_1, false, 0); break; }
+
+            u64 chunk_1 = Hash_Internal_Glue(current, next_1);
+            current = next_1 >> shift;
+            length += 8;
+
+            u64 next_2 = *word_ptr++;
+            zeros = Hash_Internal_Zero_Bytes(next_2);
+            if (zeros) { Hash_Internal_Finish(current, next_2, true, chunk_1); break; }
+
+            u64 chunk_2 = Hash_Internal_Glue(current, next_2);
+            current = next_2 >> shift;
+            length += 8;
+
+            state = Hash_Mix(chunk_1 ^ HASH_SECRET_1, chunk_2 ^ state);
         }
-        pool = pool->next_pool;
-    }
 
-    // free the pointers to the pools.
-    pool = original_pool->next_pool;
-    while (pool) {
-        Arena_Pool *next_pool = pool->next_pool;
-        BESTED_FREE(pool);
-        pool = next_pool;
+        #undef Hash_Internal_Glue
+        #undef Hash_Internal_Finish
     }
 
-    // clear this entire struct, make ready to use again,
-    // it should be ready to use again
-    //
-    // removes settings from all arena's
-    //
-    // probably should change this behaviour if pool ever gets
-    // any settings, like the arena has
-    Mem_Zero_Struct(original_pool);
+    #undef Hash_Internal_Zero_Bytes
+    #undef Hash_Internal_Low_Bytes
+
+    if (length_out) *length_out = length;
+    return Hash_Mix(tail ^ HASH_SECRET_2 ^ length, state ^ HASH_SECRET_3);
 }
+#else
+// big endian, just do it the slow way.
+u64 Hash_C_String(const char *c_str, u64 seed, u64 *length_out) {
+    ASSERT(c_str);
+
+    u64 length = strlen(c_str);
+    if (length_out) *length_out = length;
+    return Hash_Function_wyhash((void*)c_str, length, seed);
+}
+#endif
 
 
 
 // ===================================================
-//                Dynamic Arrays
+//                 Frozen Hash Map
 // ===================================================
 
-void Array_Maybe_Grow(Generic_Array *array, Array_Item_Type_Properties_Struct item_properties, u64 new_count, bool clear_to_zero, Source_Code_Location caller_location) {
-    ASSERT(array); // would be kinda weird.
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
 
-    // if the new count is less, we dont need to do anything. not even clear anything.
-    if (new_count <= array->count) return;
+// if this is wrong, how did you even get here.
+internal void Frozen_Hash_Map_Point_Into_Blob(Generic_Frozen_Hash_Map *frozen) {
+    Frozen_Hash_Map_Header *header = frozen->blob;
+    frozen->count             = header->count;
+    frozen->overflow_count    = header->overflow_count;
+    frozen->bucket_count      = header->bucket_count;
+    frozen->seed              = header->seed;
+    frozen->displacement_seed = header->displacement_seed;
+    frozen->displacements     = (u32*)((u8*)header + header->displacements_offset);
+    frozen->entries           =        (u8*)header + header->entries_offset;
+}
 
-    if (new_count > array->capacity) {
-        array->capacity = array->capacity ? array->capacity * 2 : ARRAY_INITAL_CAPACITY;
-        while (array->capacity < new_count) array->capacity *= 2;
+// one key, while its being frozen.
+typedef struct {
+    u64 hash;
+    void *key;
+    void *value;
+} Frozen_Hash_Map_Item;
 
-        void *new_array = NULL;
-        if (array->allocator) {
+// counting sort into buckets, then each bucket by hash, (there tiny), so equal hashes end up next to each other.
+//
+// returns the size of the biggest bucket.
+internal u32 Frozen_Hash_Map_Sort_Into_Buckets(Frozen_Hash_Map_Item *items, u64 count, Frozen_Hash_Map_Item *by_bucket, u32 *bucket_starts, u32 *cursor, u64 bucket_count) {
+    Mem_Zero(bucket_starts, (bucket_count + 1) * sizeof(u32));
+    for (u64 i = 0; i < count; i++) bucket_starts[Frozen_Hash_Map_Bucket(items[i].hash, bucket_count) + 1] += 1;
+
+    u32 biggest_bucket = 0;
+    for (u64 b = 0; b < bucket_count; b++) {
+        biggest_bucket = Max(biggest_bucket, bucket_starts[b + 1]);
+        bucket_starts[b + 1] += bucket_starts[b];
+    }
 
-            // special case where the last thing to allocate was this current array,
-            // in this case we dont need to do any Mem_Copy, just advance the count_in_bytes.
-            if (array->allocator->last) {
-                bool last_allocation_was_this_array = (array->allocator->last->data + array->allocator->last->count_in_bytes) - (array->count * item_properties.item_size) == array->items;
-                if (last_allocation_was_this_array) {
-                    u64 number_of_new_elements = array->capacity - array->count;
-                    u64 new_amount_to_allocate = number_of_new_elements * item_properties.item_size;
-                    bool new_array_can_fit_into_current_region = array->allocator->last->count_in_bytes + new_amount_to_allocate <= array->allocator->last->capacity_in_bytes;
+    Mem_Copy(cursor, bucket_starts, bucket_count * sizeof(u32));
+    for (u64 i = 0; i < count; i++) by_bucket[cursor[Frozen_Hash_Map_Bucket(items[i].hash, bucket_count)]++] = items[i];
 
-                    if (new_array_can_fit_into_current_region) {
-                        // TODO maybe call this function, this is some dangerous manipulation.
-                        // Arena_Alloc(array->allocator, new_amount_to_allocate);
-                        array->allocator->last->count_in_bytes += new_amount_to_allocate;
-                        goto skip_allocation;
-                    }
-                }
-            }
+    for (u64 b = 0; b < bucket_count; b++) {
+        for (u32 i = bucket_starts[b] + 1; i < bucket_starts[b + 1]; i++) {
+            Frozen_Hash_Map_Item item = by_bucket[i];
+            u32 j = i;
+            for (; j > bucket_starts[b] && by_bucket[j - 1].hash > item.hash; j--) by_bucket[j] = by_bucket[j - 1];
+            by_bucket[j] = item;
+        }
+    }
+    return biggest_bucket;
+}
 
-            // need to do this, need to set file and line properly.
-            //
-            // void *_Arena_Alloc(Arena *arena, u64 size_in_bytes, Arena_Alloc_Opt opt, const char *file, s32 line);
-            new_array = _Arena_Alloc(
-                array->allocator, item_properties.item_size * array->capacity,
-                (Arena_Alloc_Opt){.alignment = item_properties.item_align, .clear_to_zero = false, },
-                caller_location
-            );
-        } else {
-            new_array = BESTED_ALIGNED_ALLOC(item_properties.item_align, item_properties.item_size * array->capacity);
+// try to give every bucket a displacement, with this seed.
+//
+// biggest buckets first, while theres still lots of room. returns false if one got stuck.
+internal bool Frozen_Hash_Map_Place(Frozen_Hash_Map_Item *items, u32 *bucket_starts, u32 *bucket_order, u64 bucket_count, u64 count, u64 displacement_seed, u32 *displacements, u32 *slots_out, u64 *taken) {
+    Mem_Zero(taken, Div_Ceil(count, 64) * sizeof(u64));
+    u64 next_free = 0;
+
+    // give up on this seed after this many tries, the next one is probably better.
+    const u32 MAX_DISPLACEMENT = 1 << 20;
+
+    for (u64 i = 0; i < bucket_count; i++) {
+        u32 bucket = bucket_order[i];
+        u32 start  = bucket_starts[bucket];
+        u32 size   = bucket_starts[bucket + 1] - start;
+
+        if (size == 0) {
+            displacements[bucket] = 0;
+            continue;
         }
 
-        // malloc may return null, or the arena can be set
-        // to return NULL instead of panic'ing for an allocation.
-        //
-        // no nice way to handle this, and this situation
-        // is so rare, I dont care about it.
-        //
-        // eat this panic.
-        if (new_array == NULL) {
-            PANIC(SCL_Fmt" got null when trying to grow array", SCL_Arg(caller_location));
+        if (size == 1) {
+            // all the big ones are done, just take the next free slot.
+            while (taken[next_free / 64] & (1ULL << (next_free % 64))) next_free += 1;
+            taken[next_free / 64] |= 1ULL << (next_free % 64);
+            displacements[bucket] = FROZEN_HASH_MAP_DIRECT_SLOT | (u32)next_free;
+            slots_out[start] = (u32)next_free;
+            continue;
         }
 
-        Mem_Copy(new_array, array->items, item_properties.item_size * array->count);
+        u32 displacement = 0;
+        for (; displacement < MAX_DISPLACEMENT; displacement++) {
+            u32 placed = 0;
+            for (; placed < size; placed++) {
+                u64 slot = Frozen_Hash_Map_Fast_Range(Hash_u64(items[start + placed].hash ^ displacement, displacement_seed), count);
+                if (taken[slot / 64] & (1ULL << (slot % 64))) break;
+                // take it now, so the rest of the bucket cant land on it.
+                taken[slot / 64] |= 1ULL << (slot % 64);
+                slots_out[start + placed] = (u32)slot;
+            }
+            if (placed == size) break;
 
-        if (!array->allocator) BESTED_FREE(array->items);
-        array->items = new_array;
-    }
+            // give back the ones we took.
+            for (u32 j = 0; j < placed; j++) taken[slots_out[start + j] / 64] &= ~(1ULL << (slots_out[start + j] % 64));
+        }
+        if (displacement == MAX_DISPLACEMENT) return false;
 
-skip_allocation:
-    if (clear_to_zero) {
-        u64 new_to_add = new_count - array->count;
-        Mem_Zero((u8*)array->items + (item_properties.item_size * array->count), item_properties.item_size * new_to_add);
+        displacements[bucket] = displacement;
     }
+    return true;
 }
 
+void Generic_Hash_Map_Freeze(Generic_Hash_Map *hash_map, Generic_Frozen_Hash_Map *frozen, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location) {
+    ASSERT(hash_map);
+    ASSERT(frozen);
+    ASSERT(frozen->blob == NULL && "Frozen_Hash_Map_Free() it first");
+    ASSERT(hash_map->count < FROZEN_HASH_MAP_DIRECT_SLOT && "thats to many keys");
+
+    frozen->hash_function        = hash_map->hash_function;
+    frozen->eq_function          = hash_map->eq_function;
+    frozen->seed                 = hash_map->seed;
+    frozen->seeded_hash_function = hash_map->seeded_hash_function;
+
+    u64 count        = hash_map->count;
+    u64 bucket_count = count / FROZEN_HASH_MAP_BUCKET_SIZE + 1;
+
+    // the blob, header, displacements, then entries.
+    u64 alignment            = Max(properties.entry_alignment, (u64)Alignof(Frozen_Hash_Map_Header));
+    u64 displacements_offset = sizeof(Frozen_Hash_Map_Header);
+    u64 entries_offset       = Mem_Align_Forward(displacements_offset + bucket_count * sizeof(u32), alignment);
+    u64 blob_size            = Mem_Align_Forward(entries_offset + count * properties.entry_size, alignment);
+
+    Frozen_Hash_Map_Header *header = BESTED_ALIGNED_ALLOC(alignment, blob_size);
+    if (header == NULL) {
+        PANIC(SCL_Fmt" got null when trying to allocate a frozen hash map.", SCL_Arg(caller_location));
+    }
+    // the padding gets saved too, so zero it.
+    Mem_Zero(header, blob_size);
+    *header = (Frozen_Hash_Map_Header){
+        .magic                = FROZEN_HASH_MAP_MAGIC,
+        .entry_size           = properties.entry_size,
+        .key_size             = properties.key_size,
+        .value_size           = properties.value_size,
+        .count                = count,
+        .bucket_count         = bucket_count,
+        .seed                 = hash_map->seed,
+        .displacements_offset = displacements_offset,
+        .entries_offset       = entries_offset,
+    };
+    frozen->blob      = header;
+    frozen->blob_size = blob_size;
+    frozen->blob_kind = Frozen_Hash_Map_Blob_Allocated;
+    Frozen_Hash_Map_Point_Into_Blob(frozen);
+
+    if (count == 0) return;
+
+    // everything the building needs, in one go.
+    u64 scratch_size = Div_Ceil(count, 64)     * sizeof(u64)                   // taken slots
+                     + count                   * sizeof(Frozen_Hash_Map_Item)  // items
+                     + count                   * sizeof(Frozen_Hash_Map_Item)  // items, sorted by bucket
+                     + (bucket_count + 1)      * sizeof(u32)                   // bucket starts
+                     + bucket_count            * sizeof(u32)                   // bucket order
+                     + count                   * sizeof(u32);                  // slot for each sorted item
+    // (aligned_alloc() wants a multiple of the alignment.)
+    u8 *scratch = BESTED_MALLOC(Mem_Align_Forward(scratch_size, sizeof(u64)));
+    if (scratch == NULL) {
+        PANIC(SCL_Fmt" got null when trying to allocate space to freeze a hash map.", SCL_Arg(caller_location));
+    }
+    u64                  *taken         = (u64*) scratch;
+    Frozen_Hash_Map_Item *items         = (Frozen_Hash_Map_Item*)(taken + Div_Ceil(count, 64));
+    Frozen_Hash_Map_Item *by_bucket     = items + count;
+    u32                  *bucket_starts = (u32*)(by_bucket + count);
+    u32                  *bucket_order  = bucket_starts + bucket_count + 1;
+    u32                  *slots         = bucket_order  + bucket_count;
+
+    // the frozen map hashes the same way as the map.
+    u64 n = 0;
+    void *value = NULL;
+    while (Generic_Hash_Map_For_Each_Iterator_Next(hash_map, &value, properties)) {
+        void *key = Generic_Hash_Map_Key_For(hash_map, value, properties);
+        items[n++] = (Frozen_Hash_Map_Item){ .hash = Hash_Map_Safely_Get_Hash(hash_map, key, properties), .key = key, .value = value };
+    }
+    ASSERT(n == count);
 
-void Array_Shift(Generic_Array *array, Array_Item_Type_Properties_Struct item_properties, u64 from_index) {
-    ASSERT(array); // would be kinda weird.
+    // (bucket_order is the cursor for now.)
+    u32 biggest_bucket = Frozen_Hash_Map_Sort_Into_Buckets(items, count, by_bucket, bucket_starts, bucket_order, bucket_count);
 
-    Mem_Move(array->items, (u8*)array->items + from_index, (array->count - from_index) * item_properties.item_size);
-    array->count -= from_index;
-}
+    // two keys with the exact same hash land on the same slot with every displacement,
+    // so only the first one gets a slot, the rest go in the overflow at the end.
+    //
+    // the unique ones go back in 'items' from the front, the overflow from the back.
+    // (bucket then hash order, thats what Get() searches the overflow with.)
+    u64 slot_count     = 0;
+    u64 overflow_count = 0;
+    for (u64 b = 0; b < bucket_count; b++) {
+        for (u32 i = bucket_starts[b]; i < bucket_starts[b + 1]; i++) {
+            if (i > bucket_starts[b] && by_bucket[i].hash == by_bucket[i - 1].hash) {
+                items[count - 1 - overflow_count++] = by_bucket[i];
+            } else {
+                items[slot_count++] = by_bucket[i];
+            }
+        }
+    }
+    if (overflow_count) biggest_bucket = Frozen_Hash_Map_Sort_Into_Buckets(items, slot_count, by_bucket, bucket_starts, bucket_order, bucket_count);
 
+    header->overflow_count = overflow_count;
+    frozen->overflow_count = overflow_count;
 
+    // and the buckets, biggest first, (another counting sort, the sizes are small).
+    {
+        u32 *size_starts = BESTED_MALLOC(Mem_Align_Forward((biggest_bucket + 2) * sizeof(u32), sizeof(u64)));
+        if (size_starts == NULL) {
+            PANIC(SCL_Fmt" got null when trying to allocate space to freeze a hash map.", SCL_Arg(caller_location));
+        }
+        Mem_Zero(size_starts, (biggest_bucket + 2) * sizeof(u32));
+        for (u64 b = 0; b < bucket_count; b++) size_starts[biggest_bucket - (bucket_starts[b + 1] - bucket_starts[b]) + 1] += 1;
+        for (u32 i = 0; i <= biggest_bucket; i++) size_starts[i + 1] += size_starts[i];
+        for (u64 b = 0; b < bucket_count; b++) bucket_order[size_starts[biggest_bucket - (bucket_starts[b + 1] - bucket_starts[b])]++] = (u32)b;
+        BESTED_FREE(size_starts);
+    }
 
-// ===================================================
-//                Dynamic Hash Map
-// ===================================================
+    // almost allways the first seed works.
+    u64 displacement_seed = hash_map->seed ^ HASH_SECRET_2;
+    for (u32 attempt = 0; ; attempt++) {
+        if (Frozen_Hash_Map_Place(by_bucket, bucket_starts, bucket_order, bucket_count, slot_count, displacement_seed, frozen->displacements, slots, taken)) break;
 
-// Hash Map helper functions / macros.
+        // every hash is different now, this being stuck 17 times in a row just dosen't happen.
+        if (attempt == 16) {
+            PANIC(SCL_Fmt" could not freeze the hash map, (this should never happen)", SCL_Arg(caller_location));
+        }
+        displacement_seed = Hash_u64(displacement_seed, attempt);
+    }
+    header->displacement_seed = displacement_seed;
+    frozen->displacement_seed = displacement_seed;
 
-#define Hash_Map_UNALLOCATED    (0)
-#define Hash_Map_DEAD           (1)
+    for (u64 i = 0; i < count; i++) {
+        Frozen_Hash_Map_Item *item = (i < slot_count) ? &by_bucket[i] : &items[count - 1 - (i - slot_count)];
+        u64 slot = (i < slot_count) ? slots[i] : i;
 
-#define HASH_MAP_HASH_FROM_ENTRY(entry) (((Generic_Entry*)entry)->hash)
+        u8 *entry = (u8*)frozen->entries + slot * properties.entry_size;
+        *(u64*)entry = item->hash;
+        Mem_Copy(entry + properties.key_offset_in_entry,   item->key,   properties.key_size);
+        Mem_Copy(entry + properties.value_offset_in_entry, item->value, properties.value_size);
+    }
 
-// why use a macro when you can just not?
-internal bool Hash_Map_Hash_Is_Bad(u64 hash) {
-    return (hash == Hash_Map_UNALLOCATED) || (hash == Hash_Map_DEAD);
+    BESTED_FREE(scratch);
 }
 
-// return NULL if there are no entries,
-//
-// else either return the real entry that holds that key,
-//
-// or return somewhere new to put the key
-internal void *Hash_Map_Maybe_Get_Entry(Generic_Hash_Map *hash_map, void *key, u64 hash, Hash_Map_Key_Value_Type_Properties properties) {
-    ASSERT(hash_map);
+void *Generic_Frozen_Hash_Map_Get(Generic_Frozen_Hash_Map *frozen, void *key, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(frozen);
     ASSERT(key);
-
-    // don't give this an invalid hash.
-    ASSERT(!Hash_Map_Hash_Is_Bad(hash));
-
-    if (hash_map->capacity == 0) return NULL;
-
-    // gonna need this to check if keys are equal.
-    Equality_Function equality_function = hash_map->eq_function ? hash_map->eq_function : Hash_Map_Default_Equality_Function;
-
-    // must be true, or my probe strategy will not cover every cell.
-    ASSERT(Is_Pow_2(hash_map->capacity));
-    u64 increment   = 1;
-    u64 entry_index = hash % hash_map->capacity;
-
-    while (true) {
-        void *entry = (u8*)hash_map->entries + entry_index * properties.entry_size;
-
-        // this is a valid position to put something in. break
-        if (HASH_MAP_HASH_FROM_ENTRY(entry) == Hash_Map_UNALLOCATED) break;
-
-        // check if this is the same key.
-        if (HASH_MAP_HASH_FROM_ENTRY(entry) == hash && equality_function(key, (u8*)entry + properties.key_offset_in_entry, properties.key_size)) {
-            return entry;
+    if (frozen->count == 0) return NULL;
+
+    u64 slot_count = frozen->count - frozen->overflow_count;
+    u64 hash = Hash_Map_Hash_Key(frozen->hash_function, frozen->seeded_hash_function, frozen->seed, key, properties.key_size);
+    u64 slot = Frozen_Hash_Map_Slot(frozen->displacements, frozen->bucket_count, slot_count, frozen->displacement_seed, hash);
+
+    // a key that isn't in there still lands somewhere.
+    u8 *entry = (u8*)frozen->entries + slot * properties.entry_size;
+    if (*(u64*)entry != hash) return NULL;
+
+    Equality_Function eq_function = frozen->eq_function ? frozen->eq_function : Hash_Map_Default_Equality_Function;
+    if (eq_function(key, entry + properties.key_offset_in_entry, properties.key_size)) return entry + properties.value_offset_in_entry;
+    if (frozen->overflow_count == 0) return NULL;
+
+    // another key with the same hash got the slot, the rest of them are in the overflow,
+    // sorted by bucket then hash, so find the first one with this hash.
+    u64 bucket = Frozen_Hash_Map_Bucket(hash, frozen->bucket_count);
+    u64 low = slot_count, high = frozen->count;
+    while (low < high) {
+        u64 middle = low + (high - low) / 2;
+        u64 middle_hash   = *(u64*)((u8*)frozen->entries + middle * properties.entry_size);
+        u64 middle_bucket = Frozen_Hash_Map_Bucket(middle_hash, frozen->bucket_count);
+        if (middle_bucket < bucket || (middle_bucket == bucket && middle_hash < hash)) {
+            low = middle + 1;
+        } else {
+            high = middle;
         }
-
-        entry_index = (entry_index + increment) % hash_map->capacity;
-        increment += 1;
-        ASSERT(increment < 4096); // what are the odds for 4096 hash collisions in a row? something bad must have happened.
     }
 
-    // TODO maybe better to return a DEAD position? we can keep track if we have seen one.
-    return (u8*)hash_map->entries + entry_index * properties.entry_size;
+    for (; low < frozen->count; low++) {
+        entry = (u8*)frozen->entries + low * properties.entry_size;
+        if (*(u64*)entry != hash) break;
+        if (eq_function(key, entry + properties.key_offset_in_entry, properties.key_size)) return entry + properties.value_offset_in_entry;
+    }
+    return NULL;
 }
 
-// returns the entry that uses this key,
-//
-// if the key dose not exist in the hash map, return NULL
-internal void *Hash_Map_Get_Entry_Of_Key(Generic_Hash_Map *hash_map, void *key, u64 hash, Hash_Map_Key_Value_Type_Properties properties) {
-    ASSERT(hash_map);
-    ASSERT(key);
-
-    void *entry = Hash_Map_Maybe_Get_Entry(hash_map, key, hash, properties);
-
-    if (entry == NULL) return NULL;
-
-    u64 entry_hash = HASH_MAP_HASH_FROM_ENTRY(entry);
-    if (Hash_Map_Hash_Is_Bad(entry_hash)) return NULL;
+bool Generic_Frozen_Hash_Map_Save(Generic_Frozen_Hash_Map *frozen, const char *filepath) {
+    ASSERT(frozen);
+    ASSERT(frozen->blob && "theres nothing to save");
 
-    ASSERT(entry_hash == hash);
-    return entry;
+    FILE *file = fopen(filepath, "wb");
+    if (!file) return false;
+    bool ok = fwrite(frozen->blob, 1, frozen->blob_size, file) == frozen->blob_size;
+    ok &= fclose(file) == 0;
+    return ok;
 }
 
-// hash's that are equal to Hash_Map_UNALLOCATED or Hash_Map_DEAD are not good.
-internal u64 Hash_Map_Safely_Get_Hash(Generic_Hash_Map *hash_map, void *key, Hash_Map_Key_Value_Type_Properties properties) {
-    ASSERT(hash_map);
-    ASSERT(key);
-
-    Hash_Function hash_function = hash_map->hash_function ? hash_map->hash_function : Hash_Map_Default_Hash_Function;
-    u64 key_hash = hash_function(key, properties.key_size);
-
-    if (Hash_Map_Hash_Is_Bad(key_hash)) {
-        // some random number, to place the key randomly in the resulting hashmap,
-        //
-        // (this number is just the FNV 64-bit offset)
-        return 14695981039346656037ULL;
+bool Generic_Frozen_Hash_Map_Load(Generic_Frozen_Hash_Map *frozen, void *blob, u64 blob_size, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(frozen);
+    ASSERT(frozen->blob == NULL && "Frozen_Hash_Map_Free() it first");
+
+    Frozen_Hash_Map_Header *header = blob;
+    if (!header || blob_size < sizeof(*header)) return false;
+    if ((u64)blob % Max(properties.entry_alignment, (u64)Alignof(Frozen_Hash_Map_Header)) != 0) return false;
+
+    if (header->magic      != FROZEN_HASH_MAP_MAGIC) return false;
+    if (header->entry_size != properties.entry_size || header->key_size != properties.key_size || header->value_size != properties.value_size) return false;
+
+    if (header->count >= FROZEN_HASH_MAP_DIRECT_SLOT) return false;
+    if (header->count && header->bucket_count == 0) return false;
+    // theres allways at least one key with a slot.
+    if (header->overflow_count > header->count || (header->count && header->overflow_count == header->count)) return false;
+    u64 slot_count = header->count - header->overflow_count;
+
+    // the two arrays have to fit, (without wrapping around), and be aligned.
+    u64 displacements_size, displacements_end, entries_size, entries_end;
+    if (__builtin_mul_overflow(header->bucket_count, (u64)sizeof(u32),    &displacements_size)) return false;
+    if (__builtin_add_overflow(header->displacements_offset, displacements_size, &displacements_end)) return false;
+    if (__builtin_mul_overflow(header->count,        properties.entry_size, &entries_size))     return false;
+    if (__builtin_add_overflow(header->entries_offset, entries_size,       &entries_end))       return false;
+    if (displacements_end > blob_size || entries_end > blob_size) return false;
+
+    if (header->displacements_offset % Alignof(u32)               != 0) return false;
+    if (header->entries_offset       % properties.entry_alignment != 0) return false;
+
+    // a direct slot is used as is, so it better be a real one. (the others get a 'mod slot_count' anyway.)
+    u32 *displacements = (u32*)((u8*)blob + header->displacements_offset);
+    for (u64 i = 0; i < header->bucket_count; i++) {
+        u32 displacement = displacements[i];
+        if ((displacement & FROZEN_HASH_MAP_DIRECT_SLOT) && (displacement & ~FROZEN_HASH_MAP_DIRECT_SLOT) >= slot_count) return false;
     }
 
-    return key_hash;
+    frozen->blob      = header;
+    frozen->blob_size = blob_size;
+    frozen->blob_kind = Frozen_Hash_Map_Blob_Borrowed;
+    Frozen_Hash_Map_Point_Into_Blob(frozen);
+    return true;
 }
 
-internal void *Generic_Hash_Map_Get_Entry_For_Value(Generic_Hash_Map *hash_map, void *value_ptr, Hash_Map_Key_Value_Type_Properties properties) {
-    ASSERT(hash_map);
-    ASSERT(value_ptr);
+bool Generic_Frozen_Hash_Map_Load_File(Generic_Frozen_Hash_Map *frozen, const char *filepath, Hash_Map_Key_Value_Type_Properties properties) {
+    ASSERT(frozen);
 
-    void *entry = (u8*)value_ptr - properties.value_offset_in_entry;
+#if defined(__linux__)
+    int fd = open(filepath, O_RDONLY);
+    if (fd < 0) return false;
 
-    { // do some checks to be sure we got a valid pointer.
-        // should map down into entry.
-        s64 index_of_entry = ((u8*)entry - (u8*)hash_map->entries) / properties.entry_size;
+    struct stat file_info;
+    if (fstat(fd, &file_info) != 0 || file_info.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    u64 size = (u64)file_info.st_size;
 
-        // make sure this is in the range of the hash map.
-        ASSERT(Is_Between(index_of_entry, 0, (s64)hash_map->capacity-1));
+    // read only, the pages are shared with every other process that maps it.
+    void *blob = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (blob == MAP_FAILED) return false;
 
-        // make sure we got the right thing. make sure were not about to write somewhere stupid.
-        ASSERT((u8*)hash_map->entries + index_of_entry * properties.entry_size + properties.value_offset_in_entry == value_ptr);
+    if (!Generic_Frozen_Hash_Map_Load(frozen, blob, size, properties)) {
+        munmap(blob, size);
+        return false;
     }
+    frozen->blob_kind = Frozen_Hash_Map_Blob_Mapped;
+    return true;
+#else
+    String file = Read_Entire_File(S(filepath), NULL);
+    if (!file.data) return false;
 
-    return entry;
+    if (!Generic_Frozen_Hash_Map_Load(frozen, file.data, file.length, properties)) {
+        BESTED_FREE(file.data);
+        return false;
+    }
+    frozen->blob_kind = Frozen_Hash_Map_Blob_Allocated;
+    return true;
+#endif
 }
 
-internal void Hash_Map_Maybe_Grow(Generic_Hash_Map *hash_map, u64 be_able_to_fit_at_least, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location) {
-    ASSERT(hash_map);
+void Generic_Frozen_Hash_Map_Free(Generic_Frozen_Hash_Map *frozen) {
+    ASSERT(frozen);
 
-    const u64 HASH_MAP_GROWTH_PERCENT = 75;
+    switch (frozen->blob_kind) {
+        case Frozen_Hash_Map_Blob_Allocated: BESTED_FREE(frozen->blob); break;
+#if defined(__linux__)
+        case Frozen_Hash_Map_Blob_Mapped:    if (frozen->blob) munmap(frozen->blob, frozen->blob_size); break;
+#else
+        case Frozen_Hash_Map_Blob_Mapped:    UNREACHABLE();
+#endif
+        case Frozen_Hash_Map_Blob_Borrowed:  break;
+    }
 
-    // only grow array when at nearing capacity, not at capacity.
-    if (be_able_to_fit_at_least < hash_map->capacity * HASH_MAP_GROWTH_PERCENT / 100) return;
+    // keep the hash functions, so it can be loaded again.
+    frozen->blob           = NULL;
+    frozen->blob_size      = 0;
+    frozen->blob_kind      = Frozen_Hash_Map_Blob_Allocated;
+    frozen->entries        = NULL;
+    frozen->count          = 0;
+    frozen->overflow_count = 0;
+    frozen->displacements  = NULL;
+    frozen->bucket_count   = 0;
+}
 
-    void *old_entries = hash_map->entries;
-    u64   old_size    = hash_map->capacity;
-    u64   old_count = hash_map->count;
 
-    if (old_size == 0) ASSERT(old_entries == NULL);
-    else               ASSERT(old_entries != NULL);
 
-    // grow array capacity.
-    hash_map->capacity = hash_map->capacity != 0 ? hash_map->capacity * 2 : HASH_MAP_INITAL_CAPACITY;
-    while (be_able_to_fit_at_least >= hash_map->capacity * HASH_MAP_GROWTH_PERCENT / 100) {
-        hash_map->capacity *= 2;
-    }
+// ===================================================
+//                     LRU Cache
+// ===================================================
 
-    // get the new memory.
-    if (hash_map->allocator) {
-        // have to do this to set the caller location correctly.
-        hash_map->entries = _Arena_Alloc(
-            hash_map->allocator, properties.entry_size * hash_map->capacity,
-            (Arena_Alloc_Opt){ .alignment = properties.entry_alignment, .clear_to_zero = true, },
-            caller_location
-        );
+internal void *LRU_Cache_Alloc(Generic_LRU_Cache *cache, u64 size, u64 alignment, Source_Code_Location caller_location) {
+    void *result = NULL;
+    if (cache->allocator) {
+        result = _Arena_Alloc(cache->allocator, size, (Arena_Alloc_Opt){ .alignment = alignment, .clear_to_zero = false }, caller_location);
     } else {
-        hash_map->entries = BESTED_ALIGNED_ALLOC(properties.entry_alignment, hash_map->capacity * properties.entry_size);
-        // remember to clear malloc memory.
-        Mem_Zero(hash_map->entries, hash_map->capacity * properties.entry_size);
+        result = BESTED_ALIGNED_ALLOC(alignment, size);
     }
-
-    // arena's can be set so they dont panic when
-    // getting a NULL pointer from malloc,
-    //
-    // there is no neat way to say this function failed,
-    // so im just gonna panic here.
-    //
-    // if your in a situation where memory might run out,
-    // your machine is probably so low powered, a hash map
-    // wouldn't have that many items in it anyway.
-    // use a raw Arena instead.
-    if (hash_map->entries == NULL) {
-        PANIC(SCL_Fmt" got null pointer when trying to allocate memory for arena growth.", SCL_Arg(caller_location));
+    if (result == NULL) {
+        PANIC(SCL_Fmt" got null when trying to allocate the lru cache", SCL_Arg(caller_location));
     }
+    return result;
+}
 
-    // reset fields that need resetting.
-    hash_map->count = 0;
-    hash_map->dead_count = 0;
-
-    // now copy over the old entries
-    for (u64 i = 0; i < old_size; i++) {
-        void *this_entry = (u8*)old_entries + i * properties.entry_size;
-        u64   this_hash  = HASH_MAP_HASH_FROM_ENTRY(this_entry);
+internal void LRU_Cache_Unlink(Generic_LRU_Cache *cache, u32 slot) {
+    LRU_Cache_Link *link = &cache->links[slot];
+    if (link->prev != LRU_CACHE_NO_SLOT) cache->links[link->prev].next = link->next;
+    else                                 cache->head = link->next;
+    if (link->next != LRU_CACHE_NO_SLOT) cache->links[link->next].prev = link->prev;
+    else                                 cache->tail = link->prev;
+}
 
-        // dont care about bad entries.
-        if (Hash_Map_Hash_Is_Bad(this_hash)) continue;
+internal void LRU_Cache_Push_Front(Generic_LRU_Cache *cache, u32 slot) {
+    cache->links[slot] = (LRU_Cache_Link){ .prev = LRU_CACHE_NO_SLOT, .next = cache->head };
+    if (cache->head != LRU_CACHE_NO_SLOT) cache->links[cache->head].prev = slot;
+    else                                  cache->tail = slot;
+    cache->head = slot;
+}
 
-        void *new_entry = Hash_Map_Maybe_Get_Entry(hash_map, (u8*)this_entry + properties.key_offset_in_entry, this_hash, properties);
-        // just checking to see if we got a good place.
-        ASSERT(new_entry != NULL);
-        ASSERT(HASH_MAP_HASH_FROM_ENTRY(new_entry) == Hash_Map_UNALLOCATED);
+// who gets thrown out, the cache is full so every slot is in use.
+internal u32 LRU_Cache_Pick_Victim(Generic_LRU_Cache *cache) {
+    if (!cache->use_clock) {
+        u32 victim = cache->tail;
+        LRU_Cache_Unlink(cache, victim);
+        return victim;
+    }
 
-        // copy the new entry in.
-        Mem_Copy(new_entry, this_entry, properties.entry_size);
+    // at most one lap clearing bits, then the first one cleared is up.
+    while (cache->referenced[cache->clock_hand]) {
+        cache->referenced[cache->clock_hand] = 0;
+        cache->clock_hand = (cache->clock_hand + 1 == cache->capacity) ? 0 : cache->clock_hand + 1;
+    }
+    u32 victim = cache->clock_hand;
+    cache->clock_hand = (cache->clock_hand + 1 == cache->capacity) ? 0 : cache->clock_hand + 1;
+    return victim;
+}
 
-        // we just added a new item!
-        hash_map->count += 1;
+void Generic_LRU_Cache_Lookup(Generic_LRU_Cache *cache, u32 *slot) {
+    ASSERT(cache);
+    if (!slot) {
+        cache->misses += 1;
+        return;
     }
+    cache->hits += 1;
+    Generic_LRU_Cache_Use(cache, *slot);
+}
 
-    ASSERT(hash_map->count == old_count);
+void Generic_LRU_Cache_Use(Generic_LRU_Cache *cache, u32 slot) {
+    ASSERT(cache);
+    ASSERT(slot < cache->used);
 
-    if (!hash_map->allocator) {
-        // remember to clear the old entries.
-        //
-        // its ok to free a null pointer.
-        BESTED_FREE(old_entries);
+    if (cache->use_clock) {
+        cache->referenced[slot] = 1;
+        return;
     }
+    if (cache->head == slot) return;
+    LRU_Cache_Unlink(cache, slot);
+    LRU_Cache_Push_Front(cache, slot);
 }
 
+u32 Generic_LRU_Cache_Take_Slot(Generic_LRU_Cache *cache, Array_Item_Type_Properties_Struct key_properties, Array_Item_Type_Properties_Struct value_properties, bool *evicted, Source_Code_Location caller_location) {
+    ASSERT(cache);
+    ASSERT(cache->capacity > 0 && "set the capacity before the first Put()");
+
+    if (!cache->keys) {
+        cache->keys   = LRU_Cache_Alloc(cache, key_properties.item_size   * cache->capacity, key_properties.item_align,   caller_location);
+        cache->values = LRU_Cache_Alloc(cache, value_properties.item_size * cache->capacity, value_properties.item_align, caller_location);
+        cache->links  = LRU_Cache_Alloc(cache, sizeof(LRU_Cache_Link)     * cache->capacity, Alignof(LRU_Cache_Link),     caller_location);
+        if (cache->use_clock) {
+            cache->referenced = LRU_Cache_Alloc(cache, cache->capacity, 1, caller_location);
+            Mem_Zero(cache->referenced, cache->capacity);
+        }
+        Generic_LRU_Cache_Clear(cache);
+    }
 
+    *evicted = false;
+    u32 slot;
+    if (cache->free_list != LRU_CACHE_NO_SLOT) {
+        slot = cache->free_list;
+        cache->free_list = cache->links[slot].next;
+        cache->count += 1;
+    } else if (cache->used < cache->capacity) {
+        slot = cache->used++;
+        cache->count += 1;
+    } else {
+        slot = LRU_Cache_Pick_Victim(cache);
+        *evicted = true;
+        cache->evictions += 1;
+        if (cache->on_evict) {
+            cache->on_evict((u8*)cache->keys + slot * key_properties.item_size, (u8*)cache->values + slot * value_properties.item_size, cache->user_data);
+        }
+    }
 
-void *Generic_Hash_Map_Get(Generic_Hash_Map *hash_map, void *key, Hash_Map_Key_Value_Type_Properties properties) {
-    ASSERT(hash_map);
-    ASSERT(key);
+    // a new key has to be used again before the hand will pass it by.
+    if (cache->use_clock) cache->referenced[slot] = 0;
+    else                  LRU_Cache_Push_Front(cache, slot);
+    return slot;
+}
 
-    u64 key_hash = Hash_Map_Safely_Get_Hash(hash_map, key, properties);
+void Generic_LRU_Cache_Release_Slot(Generic_LRU_Cache *cache, u32 slot) {
+    ASSERT(cache);
+    ASSERT(slot < cache->used);
 
-    void *entry = Hash_Map_Get_Entry_Of_Key(hash_map, key, key_hash, properties);
-    if (entry == NULL) return NULL;
+    if (!cache->use_clock) LRU_Cache_Unlink(cache, slot);
+    // so the hand dosen't give it a second chance when it gets reused.
+    else cache->referenced[slot] = 0;
 
-    return (u8*)entry + properties.value_offset_in_entry;
+    cache->links[slot].next = cache->free_list;
+    cache->free_list = slot;
+    cache->count -= 1;
 }
 
-internal void *Generic_Hash_Map_Put_Or_Get_Default_Helper(Generic_Hash_Map *hash_map, void *key, bool set_default, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location) {
-    ASSERT(hash_map);
-    ASSERT(key);
+void Generic_LRU_Cache_Clear(Generic_LRU_Cache *cache) {
+    ASSERT(cache);
 
-    u64 key_hash = Hash_Map_Safely_Get_Hash(hash_map, key, properties);
+    cache->count      = 0;
+    cache->head       = LRU_CACHE_NO_SLOT;
+    cache->tail       = LRU_CACHE_NO_SLOT;
+    cache->free_list  = LRU_CACHE_NO_SLOT;
+    cache->used       = 0;
+    cache->clock_hand = 0;
+    if (cache->referenced) Mem_Zero(cache->referenced, cache->capacity);
+}
 
-    // This might make the hash map grow, even when in
-    // some cases it shouldn't, do I care?
-    Hash_Map_Maybe_Grow(hash_map, hash_map->dead_count + hash_map->count + 1, properties, caller_location);
+void Generic_LRU_Cache_Free(Generic_LRU_Cache *cache) {
+    ASSERT(cache);
 
-    // must be space to put this new thing.
-    ASSERT(hash_map->capacity > 0);
+    if (!cache->allocator) {
+        BESTED_FREE(cache->keys);
+        BESTED_FREE(cache->values);
+        BESTED_FREE(cache->links);
+        BESTED_FREE(cache->referenced);
+    }
+    cache->keys       = NULL;
+    cache->values     = NULL;
+    cache->links      = NULL;
+    cache->referenced = NULL;
+    Generic_LRU_Cache_Clear(cache);
+}
 
-    void *entry = Hash_Map_Maybe_Get_Entry(hash_map, key, key_hash, properties);
 
-    // we just grew the array, this must either be
-    // the correct key, or something unallocated.
-    ASSERT(entry != NULL);
 
-    if (HASH_MAP_HASH_FROM_ENTRY(entry) == Hash_Map_UNALLOCATED) {
-        // set hash.
-        ((Generic_Entry*) entry)->hash = key_hash;
-        // set key
-        Mem_Copy((u8*)entry + properties.key_offset_in_entry, key, properties.key_size);
-        if (set_default) {
-            // set default value.
-            Mem_Copy((u8*)entry + properties.value_offset_in_entry, (u8*)hash_map + properties.default_value_offset_in_hash_map, properties.value_size);
-        }
+// ===================================================
+//               Bloom & Cuckoo Filters
+// ===================================================
 
-        hash_map->count += 1;
+// e^-x, for the sizing math, so theres no need for libm.
+internal f64 Bloom_Filter_Exp_Neg(f64 x) {
+    f64 term = 1, sum = 1;
+    for (u32 i = 1; i < 40; i++) {
+        term *= -x / i;
+        sum  += term;
     }
+    return sum;
+}
 
-    return (u8*)entry + properties.value_offset_in_entry;
+internal void *Filter_Alloc(Arena *allocator, u64 size, u64 alignment) {
+    void *result = NULL;
+    if (allocator) {
+        result = Arena_Alloc(allocator, size, .alignment = alignment);
+    } else {
+        result = BESTED_ALIGNED_ALLOC(alignment, size);
+        if (result) Mem_Zero(result, size);
+    }
+    if (result == NULL) {
+        PANIC("got null when trying to allocate a filter");
+    }
+    return result;
 }
 
-void *Generic_Hash_Map_Get_Or_Default(Generic_Hash_Map *hash_map, void *key, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location) {
-    ASSERT(hash_map);
-    ASSERT(key);
+// one bit in each word of the block, the low half of the hash picks which.
+// (the top half picks the block).
+internal inline void Bloom_Filter_Make_Mask(u64 hash, u64 *mask) {
+    local_persist const u32 salts[BLOOM_FILTER_BLOCK_WORDS] = {
+        0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+        0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+    };
+    for (u32 i = 0; i < BLOOM_FILTER_BLOCK_WORDS; i++) {
+        mask[i] = 1ULL << (((u32)hash * salts[i]) >> 26);
+    }
+}
 
-    return Generic_Hash_Map_Put_Or_Get_Default_Helper(hash_map, key, true, properties, caller_location);
+internal inline u64 *Bloom_Filter_Block(Bloom_Filter *filter, u64 hash) {
+    return filter->blocks + ((hash >> 32) * filter->block_count >> 32) * BLOOM_FILTER_BLOCK_WORDS;
 }
 
-void *Generic_Hash_Map_Put(Generic_Hash_Map *hash_map, void *key, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location) {
-    ASSERT(hash_map);
-    ASSERT(key);
+void Bloom_Filter_Init(Bloom_Filter *filter, u64 expected_count, f64 false_positive_rate) {
+    ASSERT(filter);
+    ASSERT(false_positive_rate > 0 && false_positive_rate < 1);
+    ASSERT(!filter->blocks && "allready initialized");
+
+    // with 8 bits a key, the false positive rate is about (1 - e^(-8 / bits_per_key))^8,
+    // find the smallest bits_per_key thats good enough. the keys dont spread over
+    // the blocks evenly, (some get a lot more than others), so aim a bit lower.
+    f64 bits_per_key = 2;
+    while (bits_per_key < 64) {
+        f64 miss = 1 - Bloom_Filter_Exp_Neg(BLOOM_FILTER_BLOCK_WORDS / bits_per_key);
+        f64 rate = 1;
+        for (u32 i = 0; i < BLOOM_FILTER_BLOCK_WORDS; i++) rate *= miss;
+        if (rate <= false_positive_rate * 0.75) break;
+        bits_per_key += 0.25;
+    }
 
-    return Generic_Hash_Map_Put_Or_Get_Default_Helper(hash_map, key, false, properties, caller_location);
+    u64 bits = (u64)(bits_per_key * Max(expected_count, (u64)1)) + 1;
+    filter->block_count = Div_Ceil(bits, BLOOM_FILTER_BLOCK_WORDS * 64);
+    // the block index is picked with 32 bits of the hash.
+    ASSERT(filter->block_count <= ((u64)1 << 32));
+
+    filter->blocks = Filter_Alloc(filter->allocator, filter->block_count * BLOOM_FILTER_BLOCK_WORDS * sizeof(u64), BLOOM_FILTER_BLOCK_WORDS * sizeof(u64));
+    filter->count  = 0;
 }
 
+void Bloom_Filter_Add_Hash(Bloom_Filter *filter, u64 hash) {
+    ASSERT(filter && filter->blocks);
 
-bool Generic_Hash_Map_Contains(Generic_Hash_Map *hash_map, void *key, Hash_Map_Key_Value_Type_Properties properties) {
-    ASSERT(hash_map);
-    ASSERT(key);
+    u64 mask[BLOOM_FILTER_BLOCK_WORDS];
+    Bloom_Filter_Make_Mask(hash, mask);
 
-    u64 key_hash = Hash_Map_Safely_Get_Hash(hash_map, key, properties);
-    void *entry = Hash_Map_Get_Entry_Of_Key(hash_map, key, key_hash, properties);
-    return entry != NULL;
+    u64 *block = Bloom_Filter_Block(filter, hash);
+    for (u32 i = 0; i < BLOOM_FILTER_BLOCK_WORDS; i += BITSET_WORDS_PER_LANE) {
+        Bitset_Lane_Store(block + i, Bitset_Lane_Or(Bitset_Lane_Load(block + i), Bitset_Lane_Load(mask + i)));
+    }
+    filter->count += 1;
 }
 
-void Generic_Hash_Map_Clear(Generic_Hash_Map *hash_map, Hash_Map_Key_Value_Type_Properties properties) {
-    ASSERT(hash_map);
+bool Bloom_Filter_Maybe_Contains_Hash(Bloom_Filter *filter, u64 hash) {
+    ASSERT(filter);
+    if (!filter->blocks) return false;
 
-    // set all entries to unallocated.
-    for (u64 i = 0; i < hash_map->capacity; i++) {
-        Generic_Entry *entry = (void*)((u8*)hash_map->entries + i * properties.entry_size);
-        entry->hash = Hash_Map_UNALLOCATED;
+    u64 mask[BLOOM_FILTER_BLOCK_WORDS];
+    Bloom_Filter_Make_Mask(hash, mask);
+
+    // any bit in the mask thats not in the block.
+    u64 *block = Bloom_Filter_Block(filter, hash);
+    Bitset_Lane missing = Bitset_Lane_And_Not(Bitset_Lane_Load(mask), Bitset_Lane_Load(block));
+    for (u32 i = BITSET_WORDS_PER_LANE; i < BLOOM_FILTER_BLOCK_WORDS; i += BITSET_WORDS_PER_LANE) {
+        missing = Bitset_Lane_Or(missing, Bitset_Lane_And_Not(Bitset_Lane_Load(mask + i), Bitset_Lane_Load(block + i)));
     }
+    return Bitset_Lane_Is_Zero(missing);
+}
 
-    hash_map->count = 0;
-    hash_map->dead_count = 0;
+void Bloom_Filter_Clear(Bloom_Filter *filter) {
+    ASSERT(filter);
+    if (filter->blocks) Mem_Zero(filter->blocks, filter->block_count * BLOOM_FILTER_BLOCK_WORDS * sizeof(u64));
+    filter->count = 0;
 }
 
-void Generic_Hash_Map_Free(Generic_Hash_Map *hash_map) {
-    ASSERT(hash_map);
+void Bloom_Filter_Free(Bloom_Filter *filter) {
+    ASSERT(filter);
+    BESTED_FREE(filter->blocks);
+    filter->blocks      = NULL;
+    filter->block_count = 0;
+    filter->count       = 0;
+}
 
-    if (hash_map->allocator) {
-        fprintf(stderr, "=======================================================================================\n");
-        fprintf(stderr, "Are you serious?\n");
-        fprintf(stderr, "\n");
-        fprintf(stderr, "Did you just attempt to free a hash_map that was allready given an allocator?\n");
-        fprintf(stderr, "Not just any allocator either, the only thing hash_maps accept are arena allocators.\n");
-        fprintf(stderr, "\n");
-        fprintf(stderr, "You know I do this for you right?\n");
-        fprintf(stderr, "I give you all these tools and this is what you do with it?\n");
-        fprintf(stderr, "Make a mistake that could have easily been ignored, look into this function you just called.\n");
-        fprintf(stderr, "I can check if you have an allocator and just ignore it, but I wont.\n");
-        fprintf(stderr, "\n");
-        fprintf(stderr, "I'm not gonna even ASSERT(false).\n");
-        fprintf(stderr, "I'm gonna let the segmentation falt, or the subtle memory bug do the talking for me.\n");
-        fprintf(stderr, "\n");
-        fprintf(stderr, "I hope you have a terrible day.\n");
-        fprintf(stderr, "=======================================================================================\n");
-    }
-    BESTED_FREE(hash_map->entries);
-    hash_map->entries = NULL;
 
-    hash_map->count      = 0;
-    hash_map->dead_count = 0;
-    hash_map->capacity   = 0;
+internal inline u32 Cuckoo_Filter_Get(Cuckoo_Filter *filter, u64 bucket, u32 slot) {
+    u8 *at = filter->buckets + (bucket * CUCKOO_FILTER_BUCKET_SIZE + slot) * filter->fingerprint_size;
+    switch (filter->fingerprint_size) {
+        case 1:  return *at;
+        case 2:  return *(u16*)at;
+        default: return *(u32*)at;
+    }
+}
+internal inline void Cuckoo_Filter_Set(Cuckoo_Filter *filter, u64 bucket, u32 slot, u32 fingerprint) {
+    u8 *at = filter->buckets + (bucket * CUCKOO_FILTER_BUCKET_SIZE + slot) * filter->fingerprint_size;
+    switch (filter->fingerprint_size) {
+        case 1:  *at        = (u8) fingerprint; break;
+        case 2:  *(u16*)at  = (u16)fingerprint; break;
+        default: *(u32*)at  = fingerprint;      break;
+    }
 }
 
-void Generic_Hash_Map_Reserve(Generic_Hash_Map *hash_map, u64 num_to_reserve, Hash_Map_Key_Value_Type_Properties properties, Source_Code_Location caller_location) {
-    ASSERT(hash_map);
-
-    Hash_Map_Maybe_Grow(hash_map, num_to_reserve, properties, caller_location);
+// the top half of the hash, never 0, thats an empty slot.
+internal inline u32 Cuckoo_Filter_Fingerprint(Cuckoo_Filter *filter, u64 hash) {
+    u32 bits = filter->fingerprint_size * 8;
+    u32 fingerprint = (u32)(hash >> 32) & (u32)(((u64)1 << bits) - 1);
+    return fingerprint ? fingerprint : 1;
+}
+// works both ways, the other bucket of the other bucket is the first one.
+internal inline u64 Cuckoo_Filter_Other_Bucket(Cuckoo_Filter *filter, u64 bucket, u32 fingerprint) {
+    return (bucket ^ Hash_u64(fingerprint, filter->seed)) & (filter->bucket_count - 1);
 }
 
-bool Generic_Hash_Map_Remove(Generic_Hash_Map *hash_map, void *key, Hash_Map_Key_Value_Type_Properties properties) {
-    ASSERT(hash_map);
-    ASSERT(key);
+internal bool Cuckoo_Filter_Bucket_Has(Cuckoo_Filter *filter, u64 bucket, u32 fingerprint) {
+    bool found = false;
+    for (u32 slot = 0; slot < CUCKOO_FILTER_BUCKET_SIZE; slot++) found |= Cuckoo_Filter_Get(filter, bucket, slot) == fingerprint;
+    return found;
+}
+internal bool Cuckoo_Filter_Bucket_Insert(Cuckoo_Filter *filter, u64 bucket, u32 fingerprint) {
+    for (u32 slot = 0; slot < CUCKOO_FILTER_BUCKET_SIZE; slot++) {
+        if (Cuckoo_Filter_Get(filter, bucket, slot) == 0) {
+            Cuckoo_Filter_Set(filter, bucket, slot, fingerprint);
+            return true;
+        }
+    }
+    return false;
+}
+internal bool Cuckoo_Filter_Bucket_Remove(Cuckoo_Filter *filter, u64 bucket, u32 fingerprint) {
+    for (u32 slot = 0; slot < CUCKOO_FILTER_BUCKET_SIZE; slot++) {
+        if (Cuckoo_Filter_Get(filter, bucket, slot) == fingerprint) {
+            Cuckoo_Filter_Set(filter, bucket, slot, 0);
+            return true;
+        }
+    }
+    return false;
+}
 
-    u64 key_hash = Hash_Map_Safely_Get_Hash(hash_map, key, properties);
+void Cuckoo_Filter_Init(Cuckoo_Filter *filter, u64 expected_count, f64 false_positive_rate) {
+    ASSERT(filter);
+    ASSERT(false_positive_rate > 0 && false_positive_rate < 1);
+    ASSERT(!filter->buckets && "allready initialized");
+
+    // a lookup checks 8 slots, so the false positive rate is about 8 / 2^bits.
+    if      (false_positive_rate >= 2.0 * CUCKOO_FILTER_BUCKET_SIZE / (1 << 8))  filter->fingerprint_size = 1;
+    else if (false_positive_rate >= 2.0 * CUCKOO_FILTER_BUCKET_SIZE / (1 << 16)) filter->fingerprint_size = 2;
+    else                                                                          filter->fingerprint_size = 4;
+
+    // inserts start failing a bit after 95% full.
+    u64 buckets_needed = Div_Ceil(Max(expected_count, (u64)1) * 100, CUCKOO_FILTER_BUCKET_SIZE * 95);
+    filter->bucket_count = 1;
+    while (filter->bucket_count < buckets_needed) filter->bucket_count *= 2;
+
+    u64 size = Mem_Align_Forward(filter->bucket_count * CUCKOO_FILTER_BUCKET_SIZE * filter->fingerprint_size, sizeof(u64));
+    filter->buckets    = Filter_Alloc(filter->allocator, size, sizeof(u64));
+    filter->count      = 0;
+    filter->has_victim = false;
+}
 
-    void *entry = Hash_Map_Get_Entry_Of_Key(hash_map, key, key_hash, properties);
-    if (entry == NULL) return false;
+bool Cuckoo_Filter_Add_Hash(Cuckoo_Filter *filter, u64 hash) {
+    ASSERT(filter && filter->buckets);
+    if (filter->has_victim) return false;
 
-    u64 hash = HASH_MAP_HASH_FROM_ENTRY(entry);
-    if (hash == Hash_Map_UNALLOCATED) return false;
-    if (hash == Hash_Map_DEAD)        return false;
+    u32 fingerprint = Cuckoo_Filter_Fingerprint(filter, hash);
+    u64 bucket      = hash & (filter->bucket_count - 1);
+    u64 other       = Cuckoo_Filter_Other_Bucket(filter, bucket, fingerprint);
 
-    ASSERT(key_hash == hash);
-    ((Generic_Entry*) entry)->hash = Hash_Map_DEAD;
-    hash_map->count      -= 1;
-    hash_map->dead_count += 1;
-    return true;
-}
+    filter->count += 1;
+    if (Cuckoo_Filter_Bucket_Insert(filter, bucket, fingerprint)) return true;
+    if (Cuckoo_Filter_Bucket_Insert(filter, other,  fingerprint)) return true;
 
-bool Generic_Hash_Map_Remove_By_Value(Generic_Hash_Map *hash_map, void *value_ptr, Hash_Map_Key_Value_Type_Properties properties) {
-    ASSERT(hash_map);
-    ASSERT(value_ptr);
+    // kick someone out of their slot, and move them to their other bucket, repeat.
+    u64 random = hash;
+    bucket = (hash >> 16) & 1 ? other : bucket;
+    for (u32 kick = 0; kick < CUCKOO_FILTER_MAX_KICKS; kick++) {
+        random = random * 6364136223846793005ULL + 1442695040888963407ULL;
+        u32 slot = (u32)(random >> 62);
 
-    void *entry = Generic_Hash_Map_Get_Entry_For_Value(hash_map, value_ptr, properties);
+        u32 kicked = Cuckoo_Filter_Get(filter, bucket, slot);
+        Cuckoo_Filter_Set(filter, bucket, slot, fingerprint);
+        fingerprint = kicked;
 
-    // would be super weird if this was the case.
-    u64 hash = HASH_MAP_HASH_FROM_ENTRY(entry);
-    if (hash == Hash_Map_UNALLOCATED) return false;
-    if (hash == Hash_Map_DEAD)        return false;
+        bucket = Cuckoo_Filter_Other_Bucket(filter, bucket, fingerprint);
+        if (Cuckoo_Filter_Bucket_Insert(filter, bucket, fingerprint)) return true;
+    }
 
-    ((Generic_Entry*) entry)->hash = Hash_Map_DEAD;
-    hash_map->count      -= 1;
-    hash_map->dead_count += 1;
-    return true;
+    // nowhere to go, keep it on the side so nothing gets lost.
+    filter->has_victim         = true;
+    filter->victim_fingerprint = fingerprint;
+    filter->victim_bucket      = bucket;
+    return false;
 }
 
+bool Cuckoo_Filter_Maybe_Contains_Hash(Cuckoo_Filter *filter, u64 hash) {
+    ASSERT(filter);
+    if (!filter->buckets) return false;
 
-void *Generic_Hash_Map_Key_For(Generic_Hash_Map *hash_map, void *value_ptr, Hash_Map_Key_Value_Type_Properties properties) {
-    ASSERT(hash_map);
-    ASSERT(value_ptr);
+    u32 fingerprint = Cuckoo_Filter_Fingerprint(filter, hash);
+    u64 bucket      = hash & (filter->bucket_count - 1);
+    u64 other       = Cuckoo_Filter_Other_Bucket(filter, bucket, fingerprint);
 
-    void *entry = Generic_Hash_Map_Get_Entry_For_Value(hash_map, value_ptr, properties);
-    return (u8*)entry + properties.key_offset_in_entry;
+    if (Cuckoo_Filter_Bucket_Has(filter, bucket, fingerprint) | Cuckoo_Filter_Bucket_Has(filter, other, fingerprint)) return true;
+    return filter->has_victim && filter->victim_fingerprint == fingerprint && (filter->victim_bucket == bucket || filter->victim_bucket == other);
 }
 
-// returns if we should continue runing
-bool Generic_Hash_Map_For_Each_Iterator_Next(Generic_Hash_Map *hash_map, void **current_value, Hash_Map_Key_Value_Type_Properties properties) {
-    ASSERT(hash_map);
-    ASSERT(current_value);
-
-    void *start = (u8*)hash_map->entries;
-    void *end   = (u8*)hash_map->entries + hash_map->capacity * properties.entry_size;
+bool Cuckoo_Filter_Remove_Hash(Cuckoo_Filter *filter, u64 hash) {
+    ASSERT(filter);
+    if (!filter->buckets) return false;
 
-    void *current_entry;
+    u32 fingerprint = Cuckoo_Filter_Fingerprint(filter, hash);
+    u64 bucket      = hash & (filter->bucket_count - 1);
+    u64 other       = Cuckoo_Filter_Other_Bucket(filter, bucket, fingerprint);
 
-    if (*current_value == NULL) {
-        // this is the start of the iteration.
-        // return first element.
-        current_entry = start;
+    bool removed = false;
+    if (filter->has_victim && filter->victim_fingerprint == fingerprint && (filter->victim_bucket == bucket || filter->victim_bucket == other)) {
+        filter->has_victim = false;
+        removed = true;
     } else {
-        current_entry = Generic_Hash_Map_Get_Entry_For_Value(hash_map, *current_value, properties);
-        // also move 1 along.
-        current_entry = (u8*)current_entry + 1 * properties.entry_size;
+        removed = Cuckoo_Filter_Bucket_Remove(filter, bucket, fingerprint) || Cuckoo_Filter_Bucket_Remove(filter, other, fingerprint);
     }
+    if (!removed) return false;
 
-    // while the entry is empty. continue.
-    while (current_entry < end && Hash_Map_Hash_Is_Bad(HASH_MAP_HASH_FROM_ENTRY(current_entry))) {
-        current_entry = (u8*)current_entry + 1 * properties.entry_size;
+    filter->count -= 1;
+    // theres room now, try and find the victim a real home.
+    if (filter->has_victim && Cuckoo_Filter_Bucket_Insert(filter, filter->victim_bucket, filter->victim_fingerprint)) {
+        filter->has_victim = false;
     }
+    return true;
+}
 
-    *current_value = (u8*)current_entry + properties.value_offset_in_entry;
-    return (u8*)current_entry < (u8*)end;
+void Cuckoo_Filter_Clear(Cuckoo_Filter *filter) {
+    ASSERT(filter);
+    if (filter->buckets) Mem_Zero(filter->buckets, filter->bucket_count * CUCKOO_FILTER_BUCKET_SIZE * filter->fingerprint_size);
+    filter->count      = 0;
+    filter->has_victim = false;
 }
 
+void Cuckoo_Filter_Free(Cuckoo_Filter *filter) {
+    ASSERT(filter);
+    BESTED_FREE(filter->buckets);
+    filter->buckets      = NULL;
+    filter->bucket_count = 0;
+    filter->count        = 0;
+    filter->has_victim   = false;
+}
 
 
-u64 Hash_Map_Default_Hash_Function(void *key, u64 size) {
-    ASSERT(key);
 
-    return Hash_Function_fnv1a(key, size);
+// ===================================================
+//              Concurrent Hash Map
+// ===================================================
+
+internal inline u8 *Concurrent_Hash_Map_Shard(Generic_Concurrent_Hash_Map *concurrent_map, u64 index, Concurrent_Hash_Map_Properties properties) {
+    return (u8*)concurrent_map->shards + index * properties.shard_size;
+}
+internal inline RW_Lock *Concurrent_Hash_Map_Shard_Lock(u8 *shard) {
+    // the lock is the first thing in the shard.
+    return (RW_Lock*)shard;
+}
+internal inline Generic_Hash_Map *Concurrent_Hash_Map_Shard_Map(u8 *shard, Concurrent_Hash_Map_Properties properties) {
+    return (Generic_Hash_Map*)(shard + properties.map_offset_in_shard);
 }
-bool Hash_Map_Default_Equality_Function(void *key_a, void *key_b, u64 size) {
-    ASSERT(key_a && key_b);
 
-    return Mem_Eq(key_a, key_b, size);
+// every shard hash's the same way, so just ask the first one.
+//
+// the maps use the low bits, (and the control bytes use the ones after the first 7),
+// so the shard comes from the top bits.
+internal u8 *Concurrent_Hash_Map_Shard_For(Generic_Concurrent_Hash_Map *concurrent_map, void *key, Concurrent_Hash_Map_Properties properties) {
+    ASSERT(concurrent_map->shards && "call Concurrent_Hash_Map_Init() first");
+
+    Generic_Hash_Map *first = Concurrent_Hash_Map_Shard_Map(Concurrent_Hash_Map_Shard(concurrent_map, 0, properties), properties);
+    u64 hash = Hash_Map_Safely_Get_Hash(first, key, properties.map);
+
+    u64 index = (hash >> 48) & (concurrent_map->shard_count - 1);
+    return Concurrent_Hash_Map_Shard(concurrent_map, index, properties);
 }
 
 
-u64 Hash_Map_Hash_String  (void *key, u64 size) {
+void Generic_Concurrent_Hash_Map_Init(Generic_Concurrent_Hash_Map *concurrent_map, u64 shard_count, Concurrent_Hash_Map_Properties properties, Source_Code_Location caller_location) {
+    ASSERT(concurrent_map);
+    ASSERT(concurrent_map->shards == NULL && "allready initialized");
+    ASSERT(Is_Pow_2(shard_count) && shard_count <= (1 << 16));
+
+    u64 size = shard_count * properties.shard_size;
+    concurrent_map->shards = BESTED_ALIGNED_ALLOC(properties.shard_alignment, size);
+    if (concurrent_map->shards == NULL) {
+        PANIC(SCL_Fmt" got null when trying to allocate the shards of a concurrent hash map.", SCL_Arg(caller_location));
+    }
+    Mem_Zero(concurrent_map->shards, size);
+    concurrent_map->shard_count = shard_count;
+
+    void *default_value = (u8*)concurrent_map + properties.default_value_offset;
+
+    for (u64 i = 0; i < shard_count; i++) {
+        u8 *shard = Concurrent_Hash_Map_Shard(concurrent_map, i, properties);
+        Atomic_Store(Concurrent_Hash_Map_Shard_Lock(shard), 0);
+
+        Generic_Hash_Map *map = Concurrent_Hash_Map_Shard_Map(shard, properties);
+        map->hash_function        = concurrent_map->hash_function;
+        map->eq_function          = concurrent_map->eq_function;
+        map->seed                 = concurrent_map->seed;
+        map->seeded_hash_function = concurrent_map->seeded_hash_function;
+        map->layout               = concurrent_map->layout;
+        Mem_Copy((u8*)map + properties.map.default_value_offset_in_hash_map, default_value, properties.map.value_size);
+    }
+}
+
+bool Generic_Concurrent_Hash_Map_Get(Generic_Concurrent_Hash_Map *concurrent_map, void *key, void *value_out, Concurrent_Hash_Map_Properties properties) {
+    ASSERT(concurrent_map);
     ASSERT(key);
-    ASSERT(size == sizeof(String));
+    ASSERT(value_out);
 
-    String *string = key;
-    return Hash_Map_Default_Hash_Function(string->data, string->length);
+    u8 *shard = Concurrent_Hash_Map_Shard_For(concurrent_map, key, properties);
+    bool found = false;
+
+    RW_Lock_Capture_Read(Concurrent_Hash_Map_Shard_Lock(shard)) {
+        void *value = Generic_Hash_Map_Get(Concurrent_Hash_Map_Shard_Map(shard, properties), key, properties.map);
+        if (value) {
+            Mem_Copy(value_out, value, properties.map.value_size);
+            found = true;
+        }
+    }
+    return found;
 }
-bool Hash_Map_Eq_String(void *key_a, void *key_b, u64 size) {
-    ASSERT(key_a && key_b);
-    ASSERT(size == sizeof(String));
 
-    String *string_a = key_a;
-    String *string_b = key_b;
-    return String_Eq(*string_a, *string_b);
+void Generic_Concurrent_Hash_Map_Put(Generic_Concurrent_Hash_Map *concurrent_map, void *key, void *value, Concurrent_Hash_Map_Properties properties, Source_Code_Location caller_location) {
+    ASSERT(concurrent_map);
+    ASSERT(key);
+    ASSERT(value);
+
+    u8 *shard = Concurrent_Hash_Map_Shard_For(concurrent_map, key, properties);
+
+    RW_Lock_Capture_Write(Concurrent_Hash_Map_Shard_Lock(shard)) {
+        void *slot_value = Generic_Hash_Map_Put(Concurrent_Hash_Map_Shard_Map(shard, properties), key, properties.map, caller_location);
+        Mem_Copy(slot_value, value, properties.map.value_size);
+    }
 }
 
+void Generic_Concurrent_Hash_Map_Get_Or_Default(Generic_Concurrent_Hash_Map *concurrent_map, void *key, void *value_out, Concurrent_Hash_Map_Properties properties, Source_Code_Location caller_location) {
+    ASSERT(concurrent_map);
+    ASSERT(key);
+    ASSERT(value_out);
 
-u64 Hash_Map_Hash_C_String  (void *key, u64 size) {
+    // most of the time its allready there, so try with just a read lock first.
+    if (Generic_Concurrent_Hash_Map_Get(concurrent_map, key, value_out, properties)) return;
+
+    u8 *shard = Concurrent_Hash_Map_Shard_For(concurrent_map, key, properties);
+
+    RW_Lock_Capture_Write(Concurrent_Hash_Map_Shard_Lock(shard)) {
+        // someone else might have put it in between, thats fine, we get theirs.
+        void *value = Generic_Hash_Map_Get_Or_Default(Concurrent_Hash_Map_Shard_Map(shard, properties), key, properties.map, caller_location);
+        Mem_Copy(value_out, value, properties.map.value_size);
+    }
+}
+
+bool Generic_Concurrent_Hash_Map_Remove(Generic_Concurrent_Hash_Map *concurrent_map, void *key, Concurrent_Hash_Map_Properties properties) {
+    ASSERT(concurrent_map);
     ASSERT(key);
-    ASSERT(size == sizeof(const char *));
 
-    const char **c_str = key;
-    // yeah I know, this passes over the string twice,
-    //
-    // I do not care.
-    //
-    // just use the String type to begin with.
-    String string = S(*c_str);
-    return Hash_Map_Default_Hash_Function(string.data, string.length);
+    u8 *shard = Concurrent_Hash_Map_Shard_For(concurrent_map, key, properties);
+    bool removed = false;
+
+    RW_Lock_Capture_Write(Concurrent_Hash_Map_Shard_Lock(shard)) {
+        removed = Generic_Hash_Map_Remove(Concurrent_Hash_Map_Shard_Map(shard, properties), key, properties.map);
+    }
+    return removed;
 }
-bool Hash_Map_Eq_C_String(void *key_a, void *key_b, u64 size) {
-    ASSERT(key_a && key_b);
-    ASSERT(size == sizeof(const char *));
 
-    const char **c_str_a = key_a;
-    const char **c_str_b = key_b;
-    // it would be so much better if we had a way
-    // of telling what the size of the string was...
-    String string_a = S(*c_str_a);
-    String string_b = S(*c_str_b);
-    return String_Eq(string_a, string_b);
+u64 Generic_Concurrent_Hash_Map_Count(Generic_Concurrent_Hash_Map *concurrent_map, Concurrent_Hash_Map_Properties properties) {
+    ASSERT(concurrent_map);
+
+    u64 count = 0;
+    for (u64 i = 0; i < concurrent_map->shard_count; i++) {
+        u8 *shard = Concurrent_Hash_Map_Shard(concurrent_map, i, properties);
+        RW_Lock_Capture_Read(Concurrent_Hash_Map_Shard_Lock(shard)) {
+            count += Concurrent_Hash_Map_Shard_Map(shard, properties)->count;
+        }
+    }
+    return count;
 }
 
+void Generic_Concurrent_Hash_Map_Snapshot(Generic_Concurrent_Hash_Map *concurrent_map, Generic_Hash_Map *hash_map, Concurrent_Hash_Map_Properties properties, Source_Code_Location caller_location) {
+    ASSERT(concurrent_map);
+    ASSERT(hash_map);
 
-u64 Hash_Function_fnv1a(void *key, u64 size) {
-    // its ok for the key to be NULL here,
-    // could be hashing a string or something
-    if (size > 0) ASSERT(key);
+    for (u64 i = 0; i < concurrent_map->shard_count; i++) {
+        u8 *shard = Concurrent_Hash_Map_Shard(concurrent_map, i, properties);
 
-    // 64 bit offset_basis = 14695981039346656037
-    const u64 FNV_offset = 14695981039346656037ULL;
-    // 64 bit FNV_prime = 2^40 + 2^8 + 0xb3 = 1099511628211
-    const u64 FNV_prime  =        1099511628211ULL;
+        RW_Lock_Capture_Read(Concurrent_Hash_Map_Shard_Lock(shard)) {
+            Generic_Hash_Map *map = Concurrent_Hash_Map_Shard_Map(shard, properties);
 
-    u8 *u8_ptr = key;
-    u64 hash = FNV_offset;
-    for (u64 i = 0; i < size; i++) {
-        hash = (hash ^ u8_ptr[i]) * FNV_prime;
+            // so the snapshot only grows once per shard.
+            Generic_Hash_Map_Reserve(hash_map, hash_map->count + map->count, properties.map, caller_location);
+
+            void *value = NULL;
+            while (Generic_Hash_Map_For_Each_Iterator_Next(map, &value, properties.map)) {
+                void *key = Generic_Hash_Map_Key_For(map, value, properties.map);
+                void *copy = Generic_Hash_Map_Put(hash_map, key, properties.map, caller_location);
+                Mem_Copy(copy, value, properties.map.value_size);
+            }
+        }
     }
-    return hash;
+}
+
+void Generic_Concurrent_Hash_Map_Free(Generic_Concurrent_Hash_Map *concurrent_map, Concurrent_Hash_Map_Properties properties) {
+    ASSERT(concurrent_map);
+
+    for (u64 i = 0; i < concurrent_map->shard_count; i++) {
+        u8 *shard = Concurrent_Hash_Map_Shard(concurrent_map, i, properties);
+        Generic_Hash_Map_Free(Concurrent_Hash_Map_Shard_Map(shard, properties));
+    }
+
+    BESTED_FREE(concurrent_map->shards);
+    concurrent_map->shards      = NULL;
+    concurrent_map->shard_count = 0;
 }
 
 
@@ -2821,6 +8674,130 @@ void String_Builder_Free(String_Builder *sb) {
 
 
 
+// ===================================================
+//                 String Interner
+// ===================================================
+
+// the lock is only taken if the interner wants it.
+internal inline void String_Interner_Read_Lock   (String_Interner *interner) { if (interner->thread_safe) RW_Lock_Read_Lock   (&interner->lock); }
+internal inline void String_Interner_Read_Unlock (String_Interner *interner) { if (interner->thread_safe) RW_Lock_Read_Unlock (&interner->lock); }
+internal inline void String_Interner_Write_Lock  (String_Interner *interner) { if (interner->thread_safe) RW_Lock_Write_Lock  (&interner->lock); }
+internal inline void String_Interner_Write_Unlock(String_Interner *interner) { if (interner->thread_safe) RW_Lock_Write_Unlock(&interner->lock); }
+
+// needs the write lock, (if there is one).
+internal String_Id String_Interner_Intern_Locked(String_Interner *interner, String s) {
+    u64 count_before = interner->ids.count;
+    String_Id *id = String_Interner_Map_Put(&interner->ids, s);
+    if (interner->ids.count == count_before) return *id;
+
+    // its new, the key has to point at our copy, not theirs.
+    ASSERT(interner->strings.count < UINT32_MAX && "thats a lot of strings");
+
+    String copy = { .length = s.length };
+    copy.data = Arena_Alloc(&interner->arena, s.length + 1, .alignment = 1, .clear_to_zero = false);
+    Mem_Copy(copy.data, s.data, s.length);
+    copy.data[s.length] = 0;
+
+    *Hash_Map_Key_For(&interner->ids, id) = copy;
+    Array_Append(&interner->strings, copy);
+    *id = (String_Id) interner->strings.count;
+    return *id;
+}
+
+String_Id String_Interner_Intern(String_Interner *interner, String s) {
+    ASSERT(interner);
+
+    // most strings are allready in there, see if the read lock is enough.
+    if (interner->thread_safe) {
+        String_Id id = String_Interner_Find(interner, s);
+        if (id) return id;
+    }
+
+    String_Interner_Write_Lock(interner);
+    String_Id id = String_Interner_Intern_Locked(interner, s);
+    String_Interner_Write_Unlock(interner);
+    return id;
+}
+
+String_Id String_Interner_Find(String_Interner *interner, String s) {
+    ASSERT(interner);
+
+    String_Interner_Read_Lock(interner);
+    String_Id *id = String_Interner_Map_Get(&interner->ids, s);
+    String_Id result = id ? *id : 0;
+    String_Interner_Read_Unlock(interner);
+    return result;
+}
+
+String String_Interner_Get(String_Interner *interner, String_Id id) {
+    ASSERT(interner);
+    ASSERT(id != 0 && "zero is never a real string");
+
+    String_Interner_Read_Lock(interner);
+    ASSERT(id <= interner->strings.count && "this id isn't from this interner");
+    String result = interner->strings.items[id - 1];
+    String_Interner_Read_Unlock(interner);
+    return result;
+}
+
+void String_Interner_Intern_Many(String_Interner *interner, String *strings, u64 count, String_Id *ids_out) {
+    ASSERT(interner);
+    ASSERT((strings && ids_out) || count == 0);
+
+    u64 hashes[HASH_MAP_BATCH_SIZE];
+
+    for (u64 batch_start = 0; batch_start < count; batch_start += HASH_MAP_BATCH_SIZE) {
+        u64 batch_count = Min(count - batch_start, (u64)HASH_MAP_BATCH_SIZE);
+        String    *batch_strings = strings + batch_start;
+        String_Id *batch_ids     = ids_out + batch_start;
+
+        // the hashing dosen't need the lock.
+        for (u64 i = 0; i < batch_count; i++) hashes[i] = String_Interner_Map_Hash(&interner->ids, batch_strings[i]);
+
+        bool any_new = false;
+        String_Interner_Read_Lock(interner);
+        {
+            String_Interner_Map *ids = &interner->ids;
+            if (ids->capacity) {
+                for (u64 i = 0; i < batch_count; i++) __builtin_prefetch(String_Interner_Map_Hash_At(ids, hashes[i] & (ids->capacity - 1)));
+            }
+
+            for (u64 i = 0; i < batch_count; i++) {
+                u64 slot = String_Interner_Map_Find_Slot(ids, batch_strings[i], hashes[i], NULL);
+                batch_ids[i] = (slot == HASH_MAP_NO_SLOT) ? 0 : *String_Interner_Map_Value_At(ids, slot);
+                any_new |= batch_ids[i] == 0;
+            }
+        }
+        String_Interner_Read_Unlock(interner);
+
+        if (!any_new) continue;
+
+        // the new ones, (and any repeats of them in this batch), all under the one lock.
+        String_Interner_Write_Lock(interner);
+        for (u64 i = 0; i < batch_count; i++) {
+            if (batch_ids[i] == 0) batch_ids[i] = String_Interner_Intern_Locked(interner, batch_strings[i]);
+        }
+        String_Interner_Write_Unlock(interner);
+    }
+}
+
+u64 String_Interner_Count(String_Interner *interner) {
+    ASSERT(interner);
+    String_Interner_Read_Lock(interner);
+    u64 count = interner->strings.count;
+    String_Interner_Read_Unlock(interner);
+    return count;
+}
+
+void String_Interner_Free(String_Interner *interner) {
+    ASSERT(interner);
+    Hash_Map_Free(&interner->ids);
+    Array_Free(&interner->strings);
+    Arena_Free(&interner->arena);
+}
+
+
+
 // ===================================================
 //             Some Common Functions
 // ===================================================
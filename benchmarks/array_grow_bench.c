@@ -0,0 +1,53 @@
+
+// grows a malloc backed array (no allocator) up to 4 GB, timing how long the growing takes.
+//
+// build it twice to compare:
+//     make bench
+//     ./build/array_grow_bench           // mremap() growth
+//     ./build/array_grow_bench_memcpy    // the old allocate, Mem_Copy(), free growth
+//
+// pass a size in megabytes if your machine doesn't have 4 GB to spare.
+
+#define BESTED_IMPLEMENTATION
+#include "../Bested.h"
+
+
+int main(int argc, char **argv) {
+    u64 target_in_bytes = (argc > 1) ? (u64) atoll(argv[1]) * MEGABYTE : 4 * GIGABYTE;
+
+    printf("growing to %zu MB, %s\n", target_in_bytes / MEGABYTE, ARRAY_USE_MREMAP ? "with mremap()" : "with Mem_Copy()");
+
+    Array(u64) array = ZEROED;
+
+    u64 growth_count   = 0;
+    u64 total_growth   = 0;
+    u64 slowest_growth = 0;
+
+    u64 start = nanoseconds_since_unspecified_epoch();
+
+    while (array.count * sizeof(u64) < target_in_bytes) {
+        if (array.count == array.capacity) {
+            u64 growth_start = nanoseconds_since_unspecified_epoch();
+                Array_Reserve(&array, array.count + 1);
+            u64 growth_time = nanoseconds_since_unspecified_epoch() - growth_start;
+
+            growth_count   += 1;
+            total_growth   += growth_time;
+            slowest_growth  = Max(slowest_growth, growth_time);
+        }
+
+        // touch every item, like a real program would.
+        array.items[array.count] = array.count;
+        array.count += 1;
+    }
+
+    u64 total = nanoseconds_since_unspecified_epoch() - start;
+
+    printf("    %zu items, %zu growths\n", array.count, growth_count);
+    printf("    total time:      %8.2f ms\n", (f64) total          / MILLION);
+    printf("    time growing:    %8.2f ms\n", (f64) total_growth   / MILLION);
+    printf("    slowest growth:  %8.2f ms\n", (f64) slowest_growth / MILLION);
+
+    Array_Free(&array);
+    return 0;
+}
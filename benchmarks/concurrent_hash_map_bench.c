@@ -0,0 +1,118 @@
+// throughput of a Concurrent_Hash_Map vs one Hash_Map behind a global spinlock,
+// for a read heavy and a write heavy mix, from 1 to 32 threads.
+//
+//     make bench
+//     ./build/concurrent_hash_map_bench            // 1 million operations per thread
+//     ./build/concurrent_hash_map_bench 100000     // or however many you want
+
+#define BESTED_IMPLEMENTATION
+#include "../Bested.h"
+
+#include <pthread.h>
+
+
+#define KEY_RANGE   (1 << 20)
+#define SHARD_COUNT 64
+
+typedef Concurrent_Hash_Map(u64, u64) Sharded_Map;
+typedef Hash_Map(u64, u64)            Locked_Map;
+
+global_variable Sharded_Map sharded;
+global_variable Locked_Map  locked;
+global_variable Atomic(bool) global_lock;
+
+global_variable u64 operations_per_thread;
+global_variable u32 write_percent;
+global_variable bool use_sharded;
+
+// so the compiler cant throw the lookups away.
+global_variable Atomic(u64) sink;
+
+
+// splitmix64, good enough random keys.
+internal u64 next_random(u64 *state) {
+    u64 z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void *worker(void *arg) {
+    u64 random = (u64)arg * 7919 + 1;
+    u64 found  = 0;
+
+    for (u64 i = 0; i < operations_per_thread; i++) {
+        u64 r     = next_random(&random);
+        u64 key   = r % KEY_RANGE;
+        bool write = (r >> 32) % 100 < write_percent;
+
+        if (use_sharded) {
+            if (write) {
+                // half puts, half removes, so the size stays about the same.
+                if (r & (1ULL << 31)) Concurrent_Hash_Map_Put(&sharded, key, i);
+                else                  Concurrent_Hash_Map_Remove(&sharded, key);
+            } else {
+                u64 value;
+                found += Concurrent_Hash_Map_Get(&sharded, key, &value);
+            }
+        } else {
+            Atomic_Capture_Lock(&global_lock) {
+                if (write) {
+                    if (r & (1ULL << 31)) *Hash_Map_Put(&locked, key) = i;
+                    else                  Hash_Map_Remove(&locked, key);
+                } else {
+                    found += Hash_Map_Get(&locked, key) != NULL;
+                }
+            }
+        }
+    }
+
+    Atomic_Add(&sink, found);
+    return NULL;
+}
+
+internal f64 run(u64 thread_count) {
+    pthread_t threads[32];
+
+    u64 start = nanoseconds_since_unspecified_epoch();
+    for (u64 i = 0; i < thread_count; i++) pthread_create(&threads[i], NULL, worker, (void*)i);
+    for (u64 i = 0; i < thread_count; i++) pthread_join(threads[i], NULL);
+    u64 time = nanoseconds_since_unspecified_epoch() - start;
+
+    // millions of operations per second.
+    return (f64)(thread_count * operations_per_thread) / ((f64)time / 1e9) / 1e6;
+}
+
+
+int main(int argc, char **argv) {
+    operations_per_thread = (argc > 1) ? (u64) atoll(argv[1]) : 1000000;
+
+    Concurrent_Hash_Map_Init(&sharded, SHARD_COUNT);
+    for (u64 key = 0; key < KEY_RANGE; key += 2) {
+        Concurrent_Hash_Map_Put(&sharded, key, key);
+        *Hash_Map_Put(&locked, key) = key;
+    }
+
+    u32 mixes[] = { 5, 50 };
+    u64 thread_counts[] = { 1, 2, 4, 8, 16, 32 };
+
+    printf("%zu operations per thread, %u keys, %u shards, in million operations per second:\n", operations_per_thread, KEY_RANGE, SHARD_COUNT);
+    for (u64 m = 0; m < Array_Len(mixes); m++) {
+        write_percent = mixes[m];
+        printf("    %u%% writes\n", write_percent);
+        printf("        threads   global lock     sharded\n");
+
+        for (u64 t = 0; t < Array_Len(thread_counts); t++) {
+            use_sharded = false;
+            f64 global_throughput  = run(thread_counts[t]);
+            use_sharded = true;
+            f64 sharded_throughput = run(thread_counts[t]);
+
+            printf("        %7zu   %11.1f %11.1f\n", thread_counts[t], global_throughput, sharded_throughput);
+        }
+    }
+
+    Concurrent_Hash_Map_Free(&sharded);
+    Hash_Map_Free(&locked);
+    return 0;
+}
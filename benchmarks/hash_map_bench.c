@@ -0,0 +1,265 @@
+// hit and miss lookups, for every Hash_Map_Layout,
+// the generic functions vs a Hash_Map_Define() map, Get() vs Get_Many(),
+// a frozen map, bloom and cuckoo filters in front of misses, iterating a mostly
+// empty map, and the slowest single insert with and without '.incremental_resize'.
+//
+//     make bench
+//     ./build/hash_map_bench            // 1 million keys
+//     ./build/hash_map_bench 10000000   // or however many you want
+//
+// the big values make every entry a cache line, so misses that
+// have to walk the entries get a lot more expensive.
+
+#define BESTED_IMPLEMENTATION
+#include "../Bested.h"
+
+
+typedef struct { u64 data[7]; } Big_Value;
+
+typedef Hash_Map(u64, u64)       Small_Map;
+typedef Hash_Map(u64, Big_Value) Big_Map;
+
+Hash_Map_Define(Typed_Map, u64, u64, Hash_u64, Hash_Map_Eq_Direct)
+
+
+// splitmix64, good enough random keys.
+internal u64 next_random(u64 *state) {
+    u64 z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+global_variable const char *layout_names[] = {
+    [Hash_Map_Layout_Default]       = "Default",
+    [Hash_Map_Layout_Control_Bytes] = "Control_Bytes",
+    [Hash_Map_Layout_Split]         = "Split",
+    [Hash_Map_Layout_Robin_Hood]    = "Robin_Hood",
+    [Hash_Map_Layout_Ordered]       = "Ordered",
+};
+
+// so the compiler cant throw the lookups away.
+global_variable volatile u64 sink;
+
+
+#define Run_Bench_With(Map_Type, PUT, GET, layout_, keys, misses, n)                                             \
+    do {                                                                                                \
+        Map_Type map = { .layout = (layout_) };                                                         \
+                                                                                                        \
+        u64 start = nanoseconds_since_unspecified_epoch();                                              \
+        for (u64 i = 0; i < (n); i++) PUT(&map, (keys)[i]);                                             \
+        u64 insert_time = nanoseconds_since_unspecified_epoch() - start;                                \
+                                                                                                        \
+        u64 found = 0;                                                                                  \
+        start = nanoseconds_since_unspecified_epoch();                                                  \
+        for (u64 i = 0; i < (n); i++) found += GET(&map, (keys)[i]) != NULL;                            \
+        u64 hit_time = nanoseconds_since_unspecified_epoch() - start;                                   \
+                                                                                                        \
+        start = nanoseconds_since_unspecified_epoch();                                                  \
+        for (u64 i = 0; i < (n); i++) found += GET(&map, (misses)[i]) != NULL;                          \
+        u64 miss_time = nanoseconds_since_unspecified_epoch() - start;                                  \
+                                                                                                        \
+        ASSERT(found == (n));                                                                           \
+        sink = found;                                                                                   \
+                                                                                                        \
+        printf("    %-10s %-14s insert %6.1f ns, hit %6.1f ns, miss %6.1f ns\n", #Map_Type,             \
+            layout_names[(layout_)], (f64)insert_time / (n), (f64)hit_time / (n), (f64)miss_time / (n)); \
+                                                                                                        \
+        Hash_Map_Free(&map);                                                                            \
+    } while (0)
+
+#define Run_Bench(Map_Type, layout_, keys, misses, n)   Run_Bench_With(Map_Type, Hash_Map_Put, Hash_Map_Get, layout_, keys, misses, n)
+
+
+int main(int argc, char **argv) {
+    u64 n = (argc > 1) ? (u64) atoll(argv[1]) : 1000000;
+
+    u64 random = 1234;
+    u64 *keys   = malloc(n * sizeof(u64));
+    u64 *misses = malloc(n * sizeof(u64));
+    for (u64 i = 0; i < n; i++) keys  [i] = next_random(&random);
+    for (u64 i = 0; i < n; i++) misses[i] = next_random(&random);
+
+    printf("%zu keys, per operation:\n", n);
+
+    for (Hash_Map_Layout layout = 0; layout < Array_Len(layout_names); layout++) {
+        Run_Bench(Small_Map, layout, keys, misses, n);
+        Run_Bench(Big_Map,   layout, keys, misses, n);
+    }
+
+    // the same u64 -> u64 map, but nothing goes through a function pointer.
+    printf("Hash_Map_Define():\n");
+    for (Hash_Map_Layout layout = 0; layout < Array_Len(layout_names); layout++) {
+        Run_Bench_With(Typed_Map, Typed_Map_Put, Typed_Map_Get, layout, keys, misses, n);
+    }
+
+    // the same hits, but a batch at a time, so the cache misses overlap.
+    printf("Hash_Map_Get() vs Hash_Map_Get_Many(), hits:\n");
+    for (Hash_Map_Layout layout = 0; layout < Array_Len(layout_names); layout++) {
+        Small_Map map = { .layout = layout };
+        for (u64 i = 0; i < n; i++) *Hash_Map_Put(&map, keys[i]) = i;
+
+        u64 found = 0;
+        u64 start = nanoseconds_since_unspecified_epoch();
+        for (u64 i = 0; i < n; i++) found += Hash_Map_Get(&map, keys[i]) != NULL;
+        u64 get_time = nanoseconds_since_unspecified_epoch() - start;
+
+        u64 *values[256];
+        start = nanoseconds_since_unspecified_epoch();
+        for (u64 i = 0; i < n; i += Array_Len(values)) {
+            u64 batch = Min(n - i, (u64)Array_Len(values));
+            Hash_Map_Get_Many(&map, keys + i, batch, values);
+            for (u64 j = 0; j < batch; j++) found += values[j] != NULL;
+        }
+        u64 many_time = nanoseconds_since_unspecified_epoch() - start;
+
+        ASSERT(found == 2 * n);
+        sink = found;
+
+        printf("    %-14s get %6.1f ns, get many %6.1f ns, %.1fx\n", layout_names[layout],
+            (f64)get_time / n, (f64)many_time / n, (f64)get_time / many_time);
+        Hash_Map_Free(&map);
+    }
+
+    // the same hits and misses, once its frozen.
+    {
+        Small_Map map = ZEROED;
+        for (u64 i = 0; i < n; i++) *Hash_Map_Put(&map, keys[i]) = i;
+
+        Frozen_Hash_Map(u64, u64) frozen = ZEROED;
+        u64 start = nanoseconds_since_unspecified_epoch();
+        Hash_Map_Freeze(&map, &frozen);
+        u64 freeze_time = nanoseconds_since_unspecified_epoch() - start;
+
+        u64 found = 0;
+        start = nanoseconds_since_unspecified_epoch();
+        for (u64 i = 0; i < n; i++) found += Frozen_Hash_Map_Get(&frozen, keys[i]) != NULL;
+        u64 hit_time = nanoseconds_since_unspecified_epoch() - start;
+
+        start = nanoseconds_since_unspecified_epoch();
+        for (u64 i = 0; i < n; i++) found += Frozen_Hash_Map_Get(&frozen, misses[i]) != NULL;
+        u64 miss_time = nanoseconds_since_unspecified_epoch() - start;
+
+        ASSERT(found == n);
+        sink = found;
+
+        printf("Hash_Map_Freeze():\n");
+        printf("    freeze %6.1f ns a key, hit %6.1f ns, miss %6.1f ns, %.1f bytes a key\n",
+            (f64)freeze_time / n, (f64)hit_time / n, (f64)miss_time / n, (f64)frozen.blob_size / n);
+
+        Frozen_Hash_Map_Free(&frozen);
+        Hash_Map_Free(&map);
+    }
+
+    // misses, straight to the map vs asking a filter first.
+    {
+        Big_Map map = ZEROED;
+        for (u64 i = 0; i < n; i++) Hash_Map_Put(&map, keys[i]);
+
+        Bloom_Filter bloom = ZEROED;
+        Bloom_Filter_Init(&bloom, n, 0.01);
+        Cuckoo_Filter cuckoo = ZEROED;
+        Cuckoo_Filter_Init(&cuckoo, n, 0.001);
+        for (u64 i = 0; i < n; i++) Bloom_Filter_Add(&bloom, keys[i]);
+        for (u64 i = 0; i < n; i++) Cuckoo_Filter_Add(&cuckoo, keys[i]);
+
+        u64 found = 0;
+        u64 start = nanoseconds_since_unspecified_epoch();
+        for (u64 i = 0; i < n; i++) found += Hash_Map_Get(&map, misses[i]) != NULL;
+        u64 map_time = nanoseconds_since_unspecified_epoch() - start;
+
+        start = nanoseconds_since_unspecified_epoch();
+        for (u64 i = 0; i < n; i++) found += Bloom_Filter_Maybe_Contains(&bloom, misses[i]) && Hash_Map_Get(&map, misses[i]) != NULL;
+        u64 bloom_time = nanoseconds_since_unspecified_epoch() - start;
+
+        start = nanoseconds_since_unspecified_epoch();
+        for (u64 i = 0; i < n; i++) found += Cuckoo_Filter_Maybe_Contains(&cuckoo, misses[i]) && Hash_Map_Get(&map, misses[i]) != NULL;
+        u64 cuckoo_time = nanoseconds_since_unspecified_epoch() - start;
+
+        ASSERT(found == 0);
+        sink = found;
+
+        printf("Big_Map misses, with a filter in front:\n");
+        printf("    no filter %6.1f ns, bloom %6.1f ns, (%.1f bits a key), cuckoo %6.1f ns, (%.1f bits a key)\n",
+            (f64)map_time / n, (f64)bloom_time / n, (f64)bloom.block_count * 512 / n,
+            (f64)cuckoo_time / n, (f64)cuckoo.bucket_count * CUCKOO_FILTER_BUCKET_SIZE * cuckoo.fingerprint_size * 8 / n);
+
+        Bloom_Filter_Free(&bloom);
+        Cuckoo_Filter_Free(&cuckoo);
+        Hash_Map_Free(&map);
+    }
+
+    // walking a map after most of it was removed, the ordered layout skips the empty slots.
+    printf("Hash_Map_For_Each() with 1 in 10 left:\n");
+    for (Hash_Map_Layout layout = 0; layout < Array_Len(layout_names); layout++) {
+        Small_Map map = { .layout = layout };
+        for (u64 i = 0; i < n; i++) *Hash_Map_Put(&map, keys[i]) = i;
+        for (u64 i = 0; i < n; i++) if (i % 10) Hash_Map_Remove(&map, keys[i]);
+
+        u64 total = 0;
+        u64 start = nanoseconds_since_unspecified_epoch();
+        Hash_Map_For_Each(value, &map) total += *value;
+        u64 time = nanoseconds_since_unspecified_epoch() - start;
+        sink = total;
+
+        printf("    %-14s %6.1f ns per entry\n", layout_names[layout], (f64)time / map.count);
+        Hash_Map_Free(&map);
+    }
+
+    // the worst single insert, this is where a full rehash hurts.
+    printf("slowest insert:\n");
+    for (u32 incremental = 0; incremental <= 1; incremental++) {
+        Small_Map map = { .incremental_resize = incremental };
+
+        u64 worst = 0;
+        u64 start = nanoseconds_since_unspecified_epoch();
+        for (u64 i = 0; i < n; i++) {
+            u64 before = nanoseconds_since_unspecified_epoch();
+            *Hash_Map_Put(&map, keys[i]) = i;
+            worst = Max(worst, nanoseconds_since_unspecified_epoch() - before);
+        }
+        u64 total = nanoseconds_since_unspecified_epoch() - start;
+
+        printf("    %-22s worst %10.3f ms, average %6.1f ns\n", incremental ? ".incremental_resize" : "rehash all at once",
+            (f64)worst / 1000000, (f64)total / n);
+        Hash_Map_Free(&map);
+    }
+
+    // the hash functions on their own, strings from 8 to 64 bytes.
+    {
+        const u64 STRING_COUNT = 1024;
+        char *strings = calloc(STRING_COUNT, 72);
+        for (u64 i = 0; i < STRING_COUNT; i++) {
+            u64 length = 8 + next_random(&random) % 57;
+            for (u64 j = 0; j < length; j++) strings[i * 72 + j] = 'a' + next_random(&random) % 26;
+        }
+
+        u64 rounds = Max(n / STRING_COUNT, (u64)1);
+        u64 total  = 0;
+
+        #define Time_Hash(name, expression)                                                     \
+            do {                                                                                \
+                u64 start = nanoseconds_since_unspecified_epoch();                              \
+                for (u64 round = 0; round < rounds; round++) {                                  \
+                    for (u64 i = 0; i < STRING_COUNT; i++) {                                    \
+                        char *str = strings + i * 72;                                           \
+                        total += (expression);                                                  \
+                    }                                                                           \
+                }                                                                               \
+                u64 time = nanoseconds_since_unspecified_epoch() - start;                       \
+                printf("    %-28s %6.1f ns\n", name, (f64)time / (rounds * STRING_COUNT));      \
+            } while (0)
+
+        printf("hashing c strings, per string:\n");
+        Time_Hash("strlen + fnv1a",        Hash_Function_fnv1a (str, strlen(str)));
+        Time_Hash("strlen + wyhash",       Hash_Function_wyhash(str, strlen(str), 0));
+        Time_Hash("Hash_C_String (fused)", Hash_C_String(str, 0, NULL));
+
+        sink = total;
+        free(strings);
+    }
+
+    free(keys);
+    free(misses);
+    return 0;
+}
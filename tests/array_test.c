@@ -1,5 +1,7 @@
 
 #define ARRAY_INITAL_CAPCITY 1
+// small enough that the test actually hits the mremap() path.
+#define ARRAY_MREMAP_THRESHOLD (64 * KILOBYTE)
 
 #define BESTED_IMPLEMENTATION
 #include "../Bested.h"
@@ -15,6 +17,41 @@ typedef Array(Person) Person_Array;
 
 Arena arena = ZEROED;
 
+
+// Array_Retain_Where() against a plain Array_Retain(), for every op.
+//
+// small values, so there are lots of equal ones, and a length thats not a multiple of a lane.
+#define Check_Retain_Where(Type, n, random)                                                         \
+    do {                                                                                            \
+        Array(Type) expected = ZEROED, got = ZEROED;                                                \
+        for (Array_Keep_Op op = Array_Keep_Equal; op <= Array_Keep_Greater_Equal; op++) {           \
+            for (Type scalar = (Type)-2; scalar != (Type)3; scalar++) {                             \
+                expected.count = got.count = 0;                                                     \
+                u64 state = op * 1000 + (u64)scalar;                                                \
+                for (u64 i = 0; i < (n); i++) {                                                     \
+                    Type value = (Type)((s64)(random(&state) % 9) - 4);                             \
+                    Array_Append(&expected, value);                                                 \
+                    Array_Append(&got,      value);                                                 \
+                }                                                                                   \
+                Array_Retain(&expected, it, Array_Internal_Keep(op, *it, scalar));                  \
+                Array_Retain_Where(&got, op, scalar);                                               \
+                ASSERT(got.count == expected.count);                                                \
+                ASSERT(Mem_Eq(got.items, expected.items, got.count * sizeof(Type)));                \
+            }                                                                                       \
+        }                                                                                           \
+        Array_Free(&expected);                                                                      \
+        Array_Free(&got);                                                                           \
+    } while (0)
+
+// splitmix64.
+internal u64 next_random(u64 *state) {
+    u64 z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+
 int main(void) {
 
     Person_Array people = ZEROED;
@@ -46,6 +83,50 @@ int main(void) {
     // we set an allocator, so we dont have to do this.
     // Array_Free(&people);
 
+
+    // big enough to go past ARRAY_MREMAP_THRESHOLD a few times.
+    Int_Array big = ZEROED;
+    for (s64 i = 0; i < 100000; i++) Array_Append(&big, i * 3);
+    for (s64 i = 0; i < 100000; i++) ASSERT(big.items[i] == i * 3);
+    printf("big array: %zu items, capacity %zu\n", big.count, big.capacity);
+    Array_Free(&big);
+    ASSERT(big.items == NULL && big.capacity == 0);
+
+    // filtering, keeps the order.
+    Int_Array numbers = ZEROED;
+    for (s64 i = 0; i < 1000; i++) Array_Append(&numbers, i);
+    Array_Retain(&numbers, it, *it % 3 == 0);
+    ASSERT(numbers.count == 334);
+    for (u64 i = 0; i < numbers.count; i++) ASSERT(numbers.items[i] == (s64)i * 3);
+
+    // the big item path.
+    Array_Retain(&people, it, it->age > 30);
+    Array_For_Each(p, &people) ASSERT(p->age > 30);
+    ASSERT(people.count == 3);
+
+    // the SIMD one, every integer type, (the unsigned ones wrap, so -4 is a big number there).
+    Check_Retain_Where(u8,  1003, next_random);
+    Check_Retain_Where(s8,  1003, next_random);
+    Check_Retain_Where(u16, 1003, next_random);
+    Check_Retain_Where(s16, 1003, next_random);
+    Check_Retain_Where(u32, 1003, next_random);
+    Check_Retain_Where(s32, 1003, next_random);
+    Check_Retain_Where(u64, 1003, next_random);
+    Check_Retain_Where(s64, 1003, next_random);
+
+    numbers.count = 0;
+    for (s64 i = 0; i < 1000; i++) Array_Append(&numbers, i);
+    Array_Retain_Where(&numbers, Array_Keep_Greater_Equal, 990);
+    ASSERT(numbers.count == 10 && numbers.items[0] == 990);
+
+    // dedup.
+    numbers.count = 0;
+    for (s64 i = 0; i < 100; i++) Array_Append(&numbers, i / 4);
+    Array_Dedup_Sorted(&numbers, a, b, *a == *b);
+    ASSERT(numbers.count == 25);
+    for (u64 i = 0; i < numbers.count; i++) ASSERT(numbers.items[i] == (s64)i);
+    Array_Free(&numbers);
+
     Arena_Free(&arena);
     return 0;
 }
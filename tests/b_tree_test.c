@@ -0,0 +1,179 @@
+
+#define BESTED_IMPLEMENTATION
+#include "../Bested.h"
+
+
+#define U64_Less(a, b)      ((a) < (b))
+B_Tree_Define(U64_Tree, u64, u64, U64_Less)
+
+// big values, so every node only holds a few, lots of splits and merges.
+typedef struct { u64 id; u8 padding[192]; } Big_Value;
+B_Tree_Define(Big_Tree, u32, Big_Value, U64_Less)
+
+internal bool string_less(String a, String b) {
+    int cmp = memcmp(a.data, b.data, Min(a.length, b.length));
+    return cmp ? cmp < 0 : a.length < b.length;
+}
+#define String_Less(a, b)   string_less((a), (b))
+B_Tree_Define(Name_Tree, String, u32, String_Less)
+
+
+// splitmix64, good enough random keys.
+internal u64 next_random(u64 *state) {
+    u64 z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+
+int main(void) {
+    // a leaf fills its node, (the free list reuses 'next', so theres no extra pointer).
+    ASSERT(sizeof(U64_Tree_Leaf) == B_TREE_NODE_SIZE && sizeof(U64_Tree_Branch) <= B_TREE_NODE_SIZE);
+
+    U64_Tree tree = ZEROED;
+
+    ASSERT(U64_Tree_Get(&tree, 5) == NULL);
+    ASSERT(!U64_Tree_Remove(&tree, 5));
+    U64_Tree_Iterator it = U64_Tree_Begin(&tree);
+    ASSERT(!U64_Tree_Next(&it));
+
+    // in a random order, (every multiple of 3 under 3 * N).
+    const u64 N = 100000;
+    u64 random = 1234;
+    u64 *order = malloc(N * sizeof(u64));
+    for (u64 i = 0; i < N; i++) order[i] = i;
+    for (u64 i = N - 1; i > 0; i--) {
+        u64 j = next_random(&random) % (i + 1);
+        u64 tmp = order[i]; order[i] = order[j]; order[j] = tmp;
+    }
+    for (u64 i = 0; i < N; i++) *U64_Tree_Put(&tree, order[i] * 3) = order[i];
+    ASSERT(tree.count == N);
+    ASSERT(tree.height >= 2);
+
+    // putting it again just gives back the same value.
+    ASSERT(*U64_Tree_Put(&tree, 30) == 10);
+    ASSERT(tree.count == N);
+
+    for (u64 i = 0; i < 3 * N; i++) {
+        u64 *value = U64_Tree_Get(&tree, i);
+        if (i % 3 == 0) ASSERT(value && *value == i / 3);
+        else            ASSERT(value == NULL);
+    }
+
+    // everything, in order.
+    u64 next = 0;
+    it = U64_Tree_Begin(&tree);
+    while (U64_Tree_Next(&it)) {
+        ASSERT(*it.key == next * 3 && *it.value == next);
+        next += 1;
+    }
+    ASSERT(next == N);
+
+    // a range, the ends dont have to be in the tree.
+    next = 0;
+    it = U64_Tree_Range(&tree, 100, 200);
+    while (U64_Tree_Next(&it)) {
+        ASSERT(*it.key >= 100 && *it.key < 200 && *it.key % 3 == 0);
+        next += 1;
+    }
+    ASSERT(next == 33);
+
+    it = U64_Tree_Lower_Bound(&tree, 3 * N - 4);
+    ASSERT(U64_Tree_Next(&it) && *it.key == 3 * N - 3);
+    ASSERT(!U64_Tree_Next(&it));
+    it = U64_Tree_Lower_Bound(&tree, 3 * N);
+    ASSERT(!U64_Tree_Next(&it));
+
+    // remove the odd ones, in a random order.
+    for (u64 i = 0; i < N; i++) {
+        if (order[i] % 2) ASSERT(U64_Tree_Remove(&tree, order[i] * 3));
+    }
+    ASSERT(!U64_Tree_Remove(&tree, 3));
+    ASSERT(tree.count == N / 2);
+
+    next = 0;
+    it = U64_Tree_Begin(&tree);
+    while (U64_Tree_Next(&it)) {
+        ASSERT(*it.key == next * 6);
+        next += 1;
+    }
+    ASSERT(next == N / 2);
+
+    // and the rest, the nodes go on the free list and get reused.
+    for (u64 i = 0; i < N; i++) U64_Tree_Remove(&tree, order[i] * 3);
+    ASSERT(tree.count == 0 && tree.height == 0);
+    it = U64_Tree_Begin(&tree);
+    ASSERT(!U64_Tree_Next(&it));
+
+    for (u64 i = 0; i < 1000; i++) *U64_Tree_Put(&tree, i) = i;
+    U64_Tree_Clear(&tree);
+    ASSERT(tree.count == 0 && U64_Tree_Get(&tree, 5) == NULL);
+    for (u64 i = 0; i < 1000; i++) *U64_Tree_Put(&tree, i) = i;
+    ASSERT(*U64_Tree_Get(&tree, 999) == 999);
+    U64_Tree_Free(&tree);
+
+
+    // a few keys a node, against a plain array of whats in there.
+    ASSERT(Big_Tree_LEAF_CAPACITY == 4 && Big_Tree_BRANCH_CAPACITY > 4);
+    Big_Tree big = ZEROED;
+    bool in_tree[2000] = {0};
+    for (u64 round = 0; round < 50000; round++) {
+        u32 key = next_random(&random) % Array_Len(in_tree);
+        if (next_random(&random) % 3) {
+            Big_Tree_Put(&big, key)->id = key;
+            in_tree[key] = true;
+        } else {
+            ASSERT(Big_Tree_Remove(&big, key) == in_tree[key]);
+            in_tree[key] = false;
+        }
+    }
+    u64 expected = 0;
+    for (u32 key = 0; key < Array_Len(in_tree); key++) {
+        Big_Value *value = Big_Tree_Get(&big, key);
+        ASSERT((value != NULL) == in_tree[key]);
+        if (value) ASSERT(value->id == key);
+        expected += in_tree[key];
+    }
+    ASSERT(big.count == expected);
+
+    u32 previous = 0;
+    u64 seen = 0;
+    Big_Tree_Iterator big_it = Big_Tree_Begin(&big);
+    while (Big_Tree_Next(&big_it)) {
+        ASSERT(seen == 0 || *big_it.key > previous);
+        previous = *big_it.key;
+        seen += 1;
+    }
+    ASSERT(seen == expected);
+    Big_Tree_Free(&big);
+
+
+    // strings, with an arena.
+    Arena arena = ZEROED;
+    Name_Tree names = { .allocator = &arena };
+
+    String_Array split = ZEROED;
+    String_Split_By(S("the quick brown fox jumps over the lazy dog"), S(" "), &split);
+    Array_For_Each(word, &split) *Name_Tree_Put(&names, *word) += 1;
+    ASSERT(names.count == 8 && *Name_Tree_Get(&names, S("the")) == 2);
+
+    // [d, o), in order.
+    const char *expected_names[] = { "dog", "fox", "jumps", "lazy" };
+    u32 name_count = 0;
+    Name_Tree_Iterator name_it = Name_Tree_Range(&names, S("d"), S("o"));
+    while (Name_Tree_Next(&name_it)) {
+        ASSERT(name_count < Array_Len(expected_names));
+        ASSERT(String_Eq(*name_it.key, S(expected_names[name_count])));
+        name_count += 1;
+    }
+    ASSERT(name_count == Array_Len(expected_names));
+
+    name_it = Name_Tree_Lower_Bound(&names, S("m"));
+    ASSERT(Name_Tree_Next(&name_it) && String_Eq(*name_it.key, S("over")));
+
+    Array_Free(&split);
+    Arena_Free(&arena);
+    free(order);
+    return 0;
+}
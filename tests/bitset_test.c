@@ -0,0 +1,102 @@
+
+#define BESTED_IMPLEMENTATION
+#include "../Bested.h"
+
+
+int main(void) {
+    // these used to overflow past bit 31.
+    u64 flags = Bit(40);
+    ASSERT(Has_Bit(flags, 40) && !Has_Bit(flags, 8));
+
+
+    Bitset visited = ZEROED;
+    Bitset_Resize(&visited, 1000);
+    ASSERT(visited.count == 1000 && visited.word_count == 16);
+    ASSERT(Bitset_Count(&visited) == 0);
+
+    Bitset_Set(&visited, 0);
+    Bitset_Set(&visited, 63);
+    Bitset_Set(&visited, 64);
+    Bitset_Set(&visited, 999);
+    ASSERT(Bitset_Test(&visited, 63) && Bitset_Test(&visited, 64) && !Bitset_Test(&visited, 65));
+    ASSERT(Bitset_Count(&visited) == 4);
+
+    Bitset_Clear(&visited, 0);
+    ASSERT(Bitset_Find_Next_Set(&visited, 0)   == 63);
+    ASSERT(Bitset_Find_Next_Set(&visited, 65)  == 999);
+    ASSERT(Bitset_Find_Next_Set(&visited, 1000) == visited.count);
+    ASSERT(Bitset_Find_Next_Unset(&visited, 63) == 65);
+
+    u64 expected[] = { 63, 64, 999 };
+    u64 seen = 0;
+    Bitset_For_Each_Set(index, &visited) {
+        ASSERT(index == expected[seen]);
+        seen += 1;
+    }
+    ASSERT(seen == 3);
+
+    // all set, the tail past count has to stay clear.
+    Bitset_Set_All(&visited);
+    ASSERT(Bitset_Count(&visited) == 1000);
+    ASSERT(Bitset_Find_Next_Unset(&visited, 0) == visited.count);
+
+    // shrinking then growing gives back zeros.
+    Bitset_Resize(&visited, 10);
+    ASSERT(Bitset_Count(&visited) == 10);
+    Bitset_Resize(&visited, 200);
+    ASSERT(Bitset_Count(&visited) == 10);
+    ASSERT(Bitset_Find_Next_Unset(&visited, 0) == 10);
+
+
+    // bulk operations, with sizes that aren't a multiple of any lane width.
+    Bitset a = ZEROED, b = ZEROED;
+    Bitset_Resize(&a, 1001);
+    Bitset_Resize(&b, 1001);
+    for (u64 i = 0; i < a.count; i += 2) Bitset_Set(&a, i);
+    for (u64 i = 0; i < b.count; i += 3) Bitset_Set(&b, i);
+
+    Bitset tmp = ZEROED;
+    #define Copy_Into_Tmp(src) do { Bitset_Resize(&tmp, (src)->count); Mem_Copy(tmp.words, (src)->words, (src)->word_count * sizeof(u64)); } while (0)
+
+    Copy_Into_Tmp(&a); Bitset_And(&tmp, &b);
+    for (u64 i = 0; i < tmp.count; i++) ASSERT(Bitset_Test(&tmp, i) == (i % 6 == 0));
+
+    Copy_Into_Tmp(&a); Bitset_Or(&tmp, &b);
+    for (u64 i = 0; i < tmp.count; i++) ASSERT(Bitset_Test(&tmp, i) == (i % 2 == 0 || i % 3 == 0));
+
+    Copy_Into_Tmp(&a); Bitset_Xor(&tmp, &b);
+    for (u64 i = 0; i < tmp.count; i++) ASSERT(Bitset_Test(&tmp, i) == ((i % 2 == 0) != (i % 3 == 0)));
+
+    Copy_Into_Tmp(&a); Bitset_And_Not(&tmp, &b);
+    for (u64 i = 0; i < tmp.count; i++) ASSERT(Bitset_Test(&tmp, i) == (i % 2 == 0 && i % 3 != 0));
+
+    // a shorter src counts as zeros for and.
+    Bitset_Resize(&b, 100);
+    Copy_Into_Tmp(&a); Bitset_And(&tmp, &b);
+    ASSERT(Bitset_Find_Next_Set(&tmp, 100) == tmp.count);
+
+    // a longer src cant leak bits past our count.
+    Bitset_Resize(&b, 1001);
+    Bitset_Set_All(&b);
+    Bitset_Resize(&tmp, 70);
+    Bitset_Or(&tmp, &b);
+    ASSERT(Bitset_Count(&tmp) == 70);
+
+    Bitset_Free(&a);
+    Bitset_Free(&b);
+    Bitset_Free(&tmp);
+    Bitset_Free(&visited);
+    ASSERT(visited.words == NULL && visited.count == 0);
+
+
+    // with an arena.
+    Arena arena = ZEROED;
+    Bitset mask = { .allocator = &arena };
+    Bitset_Resize(&mask, 1000000);
+    for (u64 i = 0; i < mask.count; i += 7) Bitset_Set(&mask, i);
+    printf("%zu of %zu bits set\n", Bitset_Count(&mask), mask.count);
+    ASSERT(Bitset_Count(&mask) == Div_Ceil(1000000, 7));
+
+    Arena_Free(&arena);
+    return 0;
+}
@@ -0,0 +1,72 @@
+
+#define BESTED_IMPLEMENTATION
+#include "../Bested.h"
+
+
+typedef struct {
+    u64 id;
+    f64 value;
+} Thing;
+
+typedef Bucket_Array(Thing) Thing_Bucket_Array;
+
+
+int main(void) {
+    Thing_Bucket_Array things = ZEROED;
+
+    Thing *first = Bucket_Array_Add_One(&things, true);
+    assert(first->id == 0 && first->value == 0);
+    first->id = 1234;
+
+    for (u64 i = 1; i < 10000; i++) {
+        Bucket_Array_Append(&things, ((Thing){ .id = i, .value = i * 2.0 }));
+    }
+    assert(things.count == 10000);
+    assert(things.bucket_count == Div_Ceil(10000, BUCKET_ARRAY_ITEMS_PER_BUCKET));
+
+    // nothing moved.
+    assert(first == Bucket_Array_Get(&things, 0));
+    assert(first->id == 1234);
+
+    u64 seen = 0;
+    Bucket_Array_For_Each(it, &things) {
+        assert(it.item == Bucket_Array_Get(&things, it.index));
+        if (it.index > 0) assert(it.item->id == it.index);
+        seen += 1;
+    }
+    assert(seen == things.count);
+
+    Bucket_Array_Swap_And_Remove(&things, 5);
+    assert(things.count == 9999);
+    assert(Bucket_Array_Get(&things, 5)->id == 9999);
+
+    // keeps the buckets.
+    Bucket_Array_Clear(&things);
+    u64 bucket_count = things.bucket_count;
+    Bucket_Array_Reserve(&things, 500);
+    assert(things.bucket_count == bucket_count);
+
+    Bucket_Array_Free(&things);
+    assert(things.buckets == NULL && things.bucket_count == 0);
+
+
+    // with an arena, growing never leaves old copies behind.
+    Arena_Pool pool = ZEROED;
+    Thing_Bucket_Array arena_things = { .allocator = Pool_Get(&pool) };
+
+    const u64 TO_ADD = 100000;
+    for (u64 i = 0; i < TO_ADD; i++) {
+        Bucket_Array_Append(&arena_things, ((Thing){ .id = i }));
+    }
+
+    u64 arena_bytes = 0;
+    for (Region *r = arena_things.allocator->first; r; r = r->next) arena_bytes += r->count_in_bytes;
+
+    printf("%zu things in %zu buckets, %zu bytes used in the arena\n", arena_things.count, arena_things.bucket_count, arena_bytes);
+    // the items, plus a little bit for the directory.
+    assert(arena_bytes < TO_ADD * sizeof(Thing) * 11 / 10);
+
+    Pool_Release(&pool, arena_things.allocator);
+    Pool_Free_Arenas(&pool);
+    return 0;
+}
@@ -0,0 +1,94 @@
+
+#define BESTED_IMPLEMENTATION
+#include "../Bested.h"
+
+#include <pthread.h>
+
+
+#define THREAD_COUNT        8
+#define KEYS_PER_THREAD     20000
+
+typedef Concurrent_Hash_Map(u64, u64) Shared_Map;
+
+global_variable Shared_Map shared = { .default_value = 1234 };
+
+global_variable RW_Lock counter_lock;
+global_variable u64     counter;
+
+
+void *writer(void *arg) {
+    u64 thread = (u64)arg;
+
+    for (u64 i = 0; i < KEYS_PER_THREAD; i++) {
+        u64 key = thread * KEYS_PER_THREAD + i;
+        Concurrent_Hash_Map_Put(&shared, key, key * 2);
+    }
+    // take every other one back out.
+    for (u64 i = 0; i < KEYS_PER_THREAD; i += 2) {
+        ASSERT(Concurrent_Hash_Map_Remove(&shared, thread * KEYS_PER_THREAD + i));
+    }
+
+    // everyone fights over the same few keys.
+    for (u64 i = 0; i < 1000; i++) {
+        u64 value = Concurrent_Hash_Map_Get_Or_Default(&shared, (u64)(~0ULL - i % 10));
+        ASSERT(value == 1234);
+    }
+
+    // and a plain counter, to make sure the write lock actually locks.
+    for (u64 i = 0; i < 10000; i++) {
+        RW_Lock_Capture_Write(&counter_lock) {
+            counter += 1;
+        }
+    }
+    return NULL;
+}
+
+void *reader(void *arg) {
+    (void)arg;
+    // the values are always key * 2, a torn read would show up here.
+    for (u64 round = 0; round < 20; round++) {
+        for (u64 key = 0; key < THREAD_COUNT * KEYS_PER_THREAD; key += 7) {
+            u64 value;
+            if (Concurrent_Hash_Map_Get(&shared, key, &value)) ASSERT(value == key * 2);
+        }
+    }
+    return NULL;
+}
+
+
+int main(void) {
+    Concurrent_Hash_Map_Init(&shared, 16);
+
+    pthread_t writers[THREAD_COUNT];
+    pthread_t readers[2];
+    for (u64 i = 0; i < THREAD_COUNT; i++) pthread_create(&writers[i], NULL, writer, (void*)i);
+    for (u64 i = 0; i < Array_Len(readers); i++) pthread_create(&readers[i], NULL, reader, NULL);
+
+    for (u64 i = 0; i < THREAD_COUNT; i++) pthread_join(writers[i], NULL);
+    for (u64 i = 0; i < Array_Len(readers); i++) pthread_join(readers[i], NULL);
+
+    ASSERT(counter == THREAD_COUNT * 10000);
+    ASSERT(Concurrent_Hash_Map_Count(&shared) == THREAD_COUNT * KEYS_PER_THREAD / 2 + 10);
+
+    for (u64 key = 0; key < THREAD_COUNT * KEYS_PER_THREAD; key++) {
+        u64 value = 0;
+        bool found = Concurrent_Hash_Map_Get(&shared, key, &value);
+        ASSERT(found == (key % 2 == 1));
+        if (found) ASSERT(value == key * 2);
+    }
+
+    // the snapshot is just a normal hash map.
+    Hash_Map(u64, u64) copy = ZEROED;
+    Concurrent_Hash_Map_Snapshot(&shared, &copy);
+    ASSERT(copy.count == Concurrent_Hash_Map_Count(&shared));
+    Hash_Map_For_Each(value, &copy) {
+        u64 key = *Hash_Map_Key_For(&copy, value);
+        ASSERT(*value == ((key > THREAD_COUNT * KEYS_PER_THREAD) ? 1234 : key * 2));
+    }
+    printf("%zu keys in %zu shards\n", copy.count, shared.shard_count);
+
+    Hash_Map_Free(&copy);
+    Concurrent_Hash_Map_Free(&shared);
+    ASSERT(shared.shards == NULL);
+    return 0;
+}
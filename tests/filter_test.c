@@ -0,0 +1,98 @@
+
+#define BESTED_IMPLEMENTATION
+#include "../Bested.h"
+
+
+// how many of 'n' keys that were never added say 'maybe'.
+#define False_Positive_Rate(filter, Contains, n)                                \
+    ({                                                                          \
+        u64 _maybe = 0;                                                         \
+        for (u64 _i = 0; _i < (n); _i++) _maybe += Contains((filter), (_i + 1) * 0x9E3779B97F4A7C15ULL + 7);    \
+        (f64)_maybe / (n);                                                      \
+    })
+
+
+int main(void) {
+    const u64 N = 100000;
+
+    // a bloom filter never forgets.
+    Bloom_Filter bloom = ZEROED;
+    ASSERT(!Bloom_Filter_Maybe_Contains(&bloom, (u64)5));
+
+    Bloom_Filter_Init(&bloom, N, 0.01);
+    for (u64 i = 0; i < N; i++) Bloom_Filter_Add(&bloom, i);
+    for (u64 i = 0; i < N; i++) ASSERT(Bloom_Filter_Maybe_Contains(&bloom, i));
+    ASSERT(bloom.count == N);
+
+    f64 bloom_rate = False_Positive_Rate(&bloom, Bloom_Filter_Maybe_Contains, N);
+    printf("bloom filter:  %5.2f bits a key, %.3f%% false positives, (asked for 1%%)\n", (f64)bloom.block_count * 512 / N, bloom_rate * 100);
+    ASSERT(bloom_rate < 0.015);
+
+    // a tighter one takes more bits.
+    Bloom_Filter tight = ZEROED;
+    Bloom_Filter_Init(&tight, N, 0.001);
+    ASSERT(tight.block_count > bloom.block_count);
+    for (u64 i = 0; i < N; i++) Bloom_Filter_Add(&tight, i);
+    ASSERT(False_Positive_Rate(&tight, Bloom_Filter_Maybe_Contains, N) < 0.003);
+    Bloom_Filter_Free(&tight);
+
+    Bloom_Filter_Clear(&bloom);
+    ASSERT(bloom.count == 0 && !Bloom_Filter_Maybe_Contains(&bloom, (u64)5));
+    Bloom_Filter_Free(&bloom);
+
+
+    // a cuckoo filter can take things out.
+    Cuckoo_Filter cuckoo = ZEROED;
+    Cuckoo_Filter_Init(&cuckoo, N, 0.001);
+    ASSERT(cuckoo.fingerprint_size == 2);
+
+    for (u64 i = 0; i < N; i++) ASSERT(Cuckoo_Filter_Add(&cuckoo, i));
+    for (u64 i = 0; i < N; i++) ASSERT(Cuckoo_Filter_Maybe_Contains(&cuckoo, i));
+    ASSERT(cuckoo.count == N);
+
+    f64 cuckoo_rate = False_Positive_Rate(&cuckoo, Cuckoo_Filter_Maybe_Contains, N);
+    printf("cuckoo filter: %5.2f bits a key, %.3f%% false positives, (asked for 0.1%%)\n", (f64)cuckoo.bucket_count * CUCKOO_FILTER_BUCKET_SIZE * cuckoo.fingerprint_size * 8 / N, cuckoo_rate * 100);
+    ASSERT(cuckoo_rate < 0.001);
+
+    for (u64 i = 0; i < N; i += 2) ASSERT(Cuckoo_Filter_Remove(&cuckoo, i));
+    ASSERT(cuckoo.count == N / 2);
+    for (u64 i = 1; i < N; i += 2) ASSERT(Cuckoo_Filter_Maybe_Contains(&cuckoo, i));
+    // the removed ones are (mostly) gone.
+    u64 still_there = 0;
+    for (u64 i = 0; i < N; i += 2) still_there += Cuckoo_Filter_Maybe_Contains(&cuckoo, i);
+    ASSERT(still_there < N / 2 / 100);
+
+    Cuckoo_Filter_Clear(&cuckoo);
+    ASSERT(!Cuckoo_Filter_Maybe_Contains(&cuckoo, (u64)1));
+    Cuckoo_Filter_Free(&cuckoo);
+
+
+    // way past full, it says so, and nothing that went in gets lost.
+    Arena arena = ZEROED;
+    Cuckoo_Filter small = { .allocator = &arena, .seed = Hash_Map_Random_Seed() };
+    Cuckoo_Filter_Init(&small, 1000, 0.05);
+    ASSERT(small.fingerprint_size == 1);
+
+    u64 added = 0;
+    while (Cuckoo_Filter_Add(&small, added)) added += 1;
+    ASSERT(added >= small.bucket_count * CUCKOO_FILTER_BUCKET_SIZE * 9 / 10);
+    ASSERT(!Cuckoo_Filter_Add(&small, added + 1));
+    for (u64 i = 0; i <= added; i++) ASSERT(Cuckoo_Filter_Maybe_Contains(&small, i));
+
+    // making room lets the one on the side back in.
+    u64 removed = 0;
+    while (small.has_victim) ASSERT(Cuckoo_Filter_Remove(&small, removed++));
+    ASSERT(removed < added);
+    for (u64 i = removed; i <= added; i++) ASSERT(Cuckoo_Filter_Maybe_Contains(&small, i));
+    ASSERT(Cuckoo_Filter_Add(&small, added + 1));
+
+    // strings, with a hash you already have.
+    Bloom_Filter words = { .allocator = &arena };
+    Bloom_Filter_Init(&words, 100, 0.01);
+    Bloom_Filter_Add_Hash(&words, Hash_String(S("hello"), words.seed));
+    ASSERT( Bloom_Filter_Maybe_Contains_Hash(&words, Hash_String(S("hello"), words.seed)));
+    ASSERT(!Bloom_Filter_Maybe_Contains_Hash(&words, Hash_String(S("world"), words.seed)));
+
+    Arena_Free(&arena);
+    return 0;
+}
@@ -0,0 +1,161 @@
+
+#define BESTED_IMPLEMENTATION
+#include "../Bested.h"
+
+
+typedef Hash_Map(u64, u32)        Id_Map;
+typedef Frozen_Hash_Map(u64, u32) Frozen_Id_Map;
+
+#define BLOB_PATH   "/tmp/frozen_hash_map_test.blob"
+
+
+// only 32 bits, and lots of keys share one.
+u64 narrow_hash(void *key, u64 size) {
+    (void) size;
+    return (u32)(*(u64*)key / 3) + 2ULL;  // (0 and 1 are taken.)
+}
+
+
+int main(void) {
+    // every layout freezes the same.
+    for (Hash_Map_Layout layout = 0; layout <= Hash_Map_Layout_Ordered; layout++) {
+        Id_Map map = { .layout = layout, .seed = Hash_Map_Random_Seed() };
+
+        const u64 N = 100000;
+        for (u64 i = 0; i < N; i++) *Hash_Map_Put(&map, i * 13) = (u32)i;
+        // and some dead ones, they shouldn't make it in.
+        for (u64 i = 0; i < N; i += 10) Hash_Map_Remove(&map, i * 13);
+
+        Frozen_Id_Map frozen = ZEROED;
+        Hash_Map_Freeze(&map, &frozen);
+        ASSERT(frozen.count == map.count);
+
+        for (u64 i = 0; i < N; i++) {
+            u32 *value = Frozen_Hash_Map_Get(&frozen, i * 13);
+            if (i % 10 == 0) {
+                ASSERT(value == NULL);
+            } else {
+                ASSERT(value && *value == i);
+            }
+            ASSERT(!Frozen_Hash_Map_Contains(&frozen, i * 13 + 1));
+        }
+
+        // exactly one entry per key, no gaps.
+        for (u64 i = 0; i < frozen.count; i++) ASSERT(frozen.entries[i].key % 13 == 0);
+
+        Frozen_Hash_Map_Free(&frozen);
+        Hash_Map_Free(&map);
+    }
+
+    // keys with the same hash dont stop it, they just go in the overflow.
+    {
+        Id_Map map = { .hash_function = narrow_hash };
+        const u64 N = 30000;
+        for (u64 i = 0; i < N; i++) *Hash_Map_Put(&map, i) = (u32)i;
+
+        Frozen_Id_Map frozen = { .hash_function = narrow_hash };
+        Hash_Map_Freeze(&map, &frozen);
+        ASSERT(frozen.count == N && frozen.overflow_count == N - N / 3);
+
+        for (u64 i = 0; i < N; i++) ASSERT(*Frozen_Hash_Map_Get(&frozen, i) == i);
+        // same hash as something thats in there, but not in there.
+        ASSERT(Frozen_Hash_Map_Get(&frozen, ((u64)3 << 32) + 3) == NULL);
+        ASSERT(Frozen_Hash_Map_Get(&frozen, ((u64)3 << 32) + 5) == NULL);
+
+        // every key with the same hash.
+        Hash_Map_Clear(&map);
+        for (u64 i = 0; i < 100; i++) *Hash_Map_Put(&map, (i * 3) << 32) = (u32)i;
+        Frozen_Hash_Map_Free(&frozen);
+        Hash_Map_Freeze(&map, &frozen);
+        ASSERT(frozen.overflow_count == 99);
+        for (u64 i = 0; i < 100; i++) ASSERT(*Frozen_Hash_Map_Get(&frozen, (i * 3) << 32) == i);
+        ASSERT(Frozen_Hash_Map_Get(&frozen, (u64)300 << 32) == NULL);
+
+        Frozen_Hash_Map_Free(&frozen);
+        Hash_Map_Free(&map);
+    }
+
+    // nothing in it.
+    Id_Map empty = ZEROED;
+    Frozen_Id_Map frozen_empty = ZEROED;
+    Hash_Map_Freeze(&empty, &frozen_empty);
+    ASSERT(frozen_empty.count == 0 && Frozen_Hash_Map_Get(&frozen_empty, 5) == NULL);
+    Frozen_Hash_Map_Free(&frozen_empty);
+
+
+    // a keyword table, frozen, saved, and loaded back in.
+    const char *keywords[] = { "if", "else", "while", "for", "return", "struct", "enum", "union", "switch", "case", "break", "continue" };
+
+    Hash_Map(const char *, u32) keyword_map = {
+        .hash_function = Hash_Map_Hash_C_String,
+        .eq_function   = Hash_Map_Eq_C_String,
+    };
+    for (u32 i = 0; i < Array_Len(keywords); i++) *Hash_Map_Put(&keyword_map, keywords[i]) = i;
+
+    Frozen_Hash_Map(const char *, u32) frozen_keywords = ZEROED;
+    Hash_Map_Freeze(&keyword_map, &frozen_keywords);
+    Hash_Map_Free(&keyword_map);
+
+    for (u32 i = 0; i < Array_Len(keywords); i++) ASSERT(*Frozen_Hash_Map_Get(&frozen_keywords, keywords[i]) == i);
+    ASSERT(Frozen_Hash_Map_Get(&frozen_keywords, "goto") == NULL);
+    Frozen_Hash_Map_Free(&frozen_keywords);
+
+
+    // plain data can go to a file.
+    Id_Map map = ZEROED;
+    for (u64 i = 0; i < 5000; i++) *Hash_Map_Put(&map, i * i) = (u32)i;
+
+    Frozen_Id_Map frozen = ZEROED;
+    Hash_Map_Freeze(&map, &frozen);
+    ASSERT(Frozen_Hash_Map_Save(&frozen, BLOB_PATH));
+
+    Frozen_Id_Map loaded = ZEROED;
+    ASSERT(Frozen_Hash_Map_Load_File(&loaded, BLOB_PATH));
+    ASSERT(loaded.count == 5000);
+    for (u64 i = 0; i < 5000; i++) ASSERT(*Frozen_Hash_Map_Get(&loaded, i * i) == i);
+    ASSERT(Frozen_Hash_Map_Get(&loaded, 2) == NULL);
+    Frozen_Hash_Map_Free(&loaded);
+
+    // or straight from memory, the wrong types get turned away.
+    Frozen_Id_Map borrowed = ZEROED;
+    ASSERT(Frozen_Hash_Map_Load(&borrowed, frozen.blob, frozen.blob_size));
+    ASSERT(*Frozen_Hash_Map_Get(&borrowed, 49) == 7);
+    Frozen_Hash_Map_Free(&borrowed);
+
+    Frozen_Hash_Map(u64, u64) wrong_type = ZEROED;
+    ASSERT(!Frozen_Hash_Map_Load(&wrong_type, frozen.blob, frozen.blob_size));
+    ASSERT(!Frozen_Hash_Map_Load(&borrowed, frozen.blob, sizeof(Frozen_Hash_Map_Header)));
+
+    // a broken blob gets turned away too, instead of reading off the end later.
+    u8 *broken = malloc(frozen.blob_size);
+    Frozen_Hash_Map_Header *header = (Frozen_Hash_Map_Header*)broken;
+
+    Mem_Copy(broken, frozen.blob, frozen.blob_size);
+    ASSERT(Frozen_Hash_Map_Load(&borrowed, broken, frozen.blob_size));
+    Frozen_Hash_Map_Free(&borrowed);
+
+    u32 *displacements = (u32*)(broken + header->displacements_offset);
+    for (u64 i = 0; i < header->bucket_count; i++) displacements[i] = FROZEN_HASH_MAP_DIRECT_SLOT | 0x7fffffff;
+    ASSERT(!Frozen_Hash_Map_Load(&borrowed, broken, frozen.blob_size));
+
+    Mem_Copy(broken, frozen.blob, frozen.blob_size);
+    header->count = (u64)-1 / sizeof(*frozen.entries) + 2;  // wraps around to something small.
+    ASSERT(!Frozen_Hash_Map_Load(&borrowed, broken, frozen.blob_size));
+
+    Mem_Copy(broken, frozen.blob, frozen.blob_size);
+    header->entries_offset += 1;
+    ASSERT(!Frozen_Hash_Map_Load(&borrowed, broken, frozen.blob_size));
+
+    Mem_Copy(broken, frozen.blob, frozen.blob_size);
+    header->displacements_offset = (u64)-4;
+    ASSERT(!Frozen_Hash_Map_Load(&borrowed, broken, frozen.blob_size));
+
+    free(broken);
+
+    printf("froze %zu keys into %zu bytes, (%.1f bytes a key)\n", frozen.count, frozen.blob_size, (f64)frozen.blob_size / frozen.count);
+
+    Frozen_Hash_Map_Free(&frozen);
+    Hash_Map_Free(&map);
+    remove(BLOB_PATH);
+    return 0;
+}
@@ -0,0 +1,104 @@
+
+#define BESTED_IMPLEMENTATION
+#include "../Bested.h"
+
+
+typedef Hash_Set(u64) U64_Set;
+
+
+internal void set_test(Hash_Map_Layout layout) {
+    U64_Set evens = { .layout = layout };
+    U64_Set threes = { .layout = layout, .seed = Hash_Map_Random_Seed() };
+
+    ASSERT(!Hash_Set_Contains(&evens, 2));
+
+    for (u64 i = 0; i < 3000; i += 2) ASSERT(Hash_Set_Add(&evens, i));
+    for (u64 i = 0; i < 3000; i += 3) ASSERT(Hash_Set_Add(&threes, i));
+    // twice is fine, its just not new.
+    ASSERT(!Hash_Set_Add(&evens, 0));
+    ASSERT(evens.count == 1500 && threes.count == 1000);
+
+    for (u64 i = 0; i < 3000; i++) ASSERT(Hash_Set_Contains(&evens, i) == (i % 2 == 0));
+
+    u64 sum = 0, seen = 0;
+    Hash_Set_For_Each(key, &threes) {
+        ASSERT(*key % 3 == 0);
+        sum += *key;
+        seen += 1;
+    }
+    ASSERT(seen == 1000 && sum == 3 * (999 * 1000 / 2));
+
+    u64 keys[100];
+    bool found[100];
+    for (u64 i = 0; i < Array_Len(keys); i++) keys[i] = i;
+    Hash_Set_Contains_Many(&threes, keys, Array_Len(keys), found);
+    for (u64 i = 0; i < Array_Len(keys); i++) ASSERT(found[i] == (i % 3 == 0));
+
+    // the set operations, (the two sets have different seeds).
+    U64_Set both = { .layout = layout };
+    Hash_Set_Union(&both, &evens);
+    Hash_Set_Intersection(&both, &threes);
+    ASSERT(both.count == 500);
+    for (u64 i = 0; i < 3000; i++) ASSERT(Hash_Set_Contains(&both, i) == (i % 6 == 0));
+
+    U64_Set either = { .layout = layout };
+    Hash_Set_Union(&either, &evens);
+    Hash_Set_Union(&either, &threes);
+    for (u64 i = 0; i < 3000; i++) ASSERT(Hash_Set_Contains(&either, i) == (i % 2 == 0 || i % 3 == 0));
+
+    Hash_Set_Difference(&either, &threes);
+    for (u64 i = 0; i < 3000; i++) ASSERT(Hash_Set_Contains(&either, i) == (i % 2 == 0 && i % 3 != 0));
+    ASSERT(either.count == 1000);
+
+    Hash_Set_Difference(&either, &either);
+    ASSERT(either.count == 0);
+
+    for (u64 i = 0; i < 3000; i += 4) ASSERT(Hash_Set_Remove(&evens, i));
+    ASSERT(!Hash_Set_Remove(&evens, 0));
+    for (u64 i = 0; i < 3000; i++) ASSERT(Hash_Set_Contains(&evens, i) == (i % 4 == 2));
+
+    Hash_Set_Clear(&evens);
+    ASSERT(evens.count == 0 && !Hash_Set_Contains(&evens, 2));
+
+    Hash_Set_Free(&evens);
+    Hash_Set_Free(&threes);
+    Hash_Set_Free(&both);
+    Hash_Set_Free(&either);
+}
+
+
+int main(void) {
+    set_test(Hash_Map_Layout_Default);
+    set_test(Hash_Map_Layout_Control_Bytes);
+    set_test(Hash_Map_Layout_Split);
+    set_test(Hash_Map_Layout_Robin_Hood);
+    set_test(Hash_Map_Layout_Ordered);
+
+    // no value, no default value, just the hash and key.
+    Hash_Set(u64) set = ZEROED;
+    Hash_Map(u64, u8) map = ZEROED;
+    printf("Hash_Set(u64) entry: %zu bytes, Hash_Map(u64, u8) entry: %zu bytes\n", sizeof(*set.entries), sizeof(*map.entries));
+    ASSERT(sizeof(*set.entries) < sizeof(*map.entries));
+
+
+    // strings, with an arena.
+    Arena arena = ZEROED;
+    Hash_Set(String) words = {
+        .hash_function = Hash_Map_Hash_String,
+        .eq_function   = Hash_Map_Eq_String,
+        .allocator     = &arena,
+    };
+
+    String_Array split = ZEROED;
+    String_Split_By(S("the cat and the dog and the bird"), S(" "), &split);
+    Array_For_Each(word, &split) Hash_Set_Add(&words, *word);
+    ASSERT(words.count == 5);
+    ASSERT(Hash_Set_Contains(&words, S("bird")) && !Hash_Set_Contains(&words, S("fish")));
+
+    Hash_Set_For_Each(word, &words) printf(S_Fmt" ", S_Arg(*word));
+    printf("\n");
+
+    Array_Free(&split);
+    Arena_Free(&arena);
+    return 0;
+}
@@ -1,4 +1,6 @@
 
+// so the probe counting gets tested too.
+#define HASH_MAP_COUNT_PROBES
 #include "../Bested.h"
 
 
@@ -37,6 +39,427 @@ void foo(void) {
 }
 
 
+// every layout should act the exact same.
+void layout_test(Hash_Map_Layout layout) {
+    Hash_Map(u64, u64) map = { .layout = layout };
+
+    const u64 N = 10000;
+    for (u64 i = 0; i < N; i++) *Hash_Map_Put(&map, i * 7) = i;
+    assert(map.count == N);
+
+    for (u64 i = 0; i < N; i++) {
+        u64 *value = Hash_Map_Get(&map, i * 7);
+        assert(value && *value == i);
+        assert(Hash_Map_Get(&map, i * 7 + 1) == NULL);
+    }
+
+    // remove every other one.
+    for (u64 i = 0; i < N; i += 2) assert(Hash_Map_Remove(&map, i * 7));
+    assert(map.count == N / 2);
+    for (u64 i = 0; i < N; i++) assert(Hash_Map_Contains(&map, i * 7) == (i % 2 == 1));
+
+    u64 seen = 0;
+    Hash_Map_For_Each(value, &map) {
+        assert(*Hash_Map_Key_For(&map, value) == *value * 7);
+        seen += 1;
+    }
+    assert(seen == map.count);
+
+    // put them back, some of these go where the dead ones were.
+    for (u64 i = 0; i < N; i += 2) *Hash_Map_Get_Or_Default(&map, i * 7) = i;
+    for (u64 i = 0; i < N; i++) assert(*Hash_Map_Get(&map, i * 7) == i);
+
+    if (layout == Hash_Map_Layout_Robin_Hood) {
+        // removing moves the entries after it back, so it cant be done while looping.
+        for (u64 i = 0; i < N; i += 3) assert(Hash_Map_Remove_By_Value(&map, Hash_Map_Get(&map, i * 7)));
+        assert(map.dead_count == 0);
+    } else {
+        Hash_Map_For_Each(value, &map) {
+            if (*value % 3 == 0) Hash_Map_Remove_By_Value(&map, value);
+        }
+    }
+    for (u64 i = 0; i < N; i++) assert(Hash_Map_Contains(&map, i * 7) == (i % 3 != 0));
+
+    // insert / remove churn with the count staying the same shouldn't grow the map.
+    u64 capacity_before_churn = map.capacity;
+    u64 count_before_churn    = map.count;
+    for (u64 i = 0; i < 20 * N; i++) {
+        *Hash_Map_Put(&map, N * 7 + i) = i;
+        assert(Hash_Map_Remove(&map, N * 7 + i));
+    }
+    assert(map.count == count_before_churn);
+    // it might double once, (to get the live count under half), but thats it.
+    assert(map.capacity <= capacity_before_churn * 2);
+    if (layout == Hash_Map_Layout_Robin_Hood) {
+        // no tombstones, and nothing is closer to home than the one before it, (minus one).
+        assert(map.dead_count == 0);
+        u64 mask = map.capacity - 1;
+        for (u64 slot = 0; slot < map.capacity; slot++) {
+            u64 hash      = map.entries[slot].hash;
+            u64 next_hash = map.entries[(slot + 1) & mask].hash;
+            if (hash == 0 || next_hash == 0) continue;
+            assert(Hash_Map_Probe_Distance(next_hash, (slot + 1) & mask, mask) <= Hash_Map_Probe_Distance(hash, slot, mask) + 1);
+        }
+    }
+    for (u64 i = 0; i < N; i++) assert(Hash_Map_Contains(&map, i * 7) == (i % 3 != 0));
+
+    // remove most of them, then shrink.
+    for (u64 i = 0; i < N - 10; i++) Hash_Map_Remove(&map, i * 7);
+    Hash_Map_Shrink_To_Fit(&map);
+    assert(map.dead_count == 0);
+    assert(map.capacity == HASH_MAP_INITAL_CAPACITY);
+    for (u64 i = 0; i < N; i++) assert(Hash_Map_Contains(&map, i * 7) == (i >= N - 10 && i % 3 != 0));
+
+    Hash_Map_Clear(&map);
+    assert(map.count == 0);
+    assert(Hash_Map_Get(&map, 7) == NULL);
+    *Hash_Map_Put(&map, 7) = 1;
+    assert(*Hash_Map_Get(&map, 7) == 1);
+
+    // empty maps give back all the memory.
+    Hash_Map_Remove(&map, 7);
+    Hash_Map_Shrink_To_Fit(&map);
+    assert(map.entries == NULL && map.capacity == 0);
+
+    Hash_Map_Free(&map);
+
+    // odd sized keys, the split layout has to keep the values after them aligned.
+    typedef struct { u8 bytes[3]; } Three;
+    Hash_Map(Three, f64) odd = { .layout = layout };
+    for (u32 i = 0; i < 200; i++) *Hash_Map_Put(&odd, ((Three){{ (u8)i, 1, 2 }})) = i;
+    for (u32 i = 0; i < 200; i++) assert(*Hash_Map_Get(&odd, ((Three){{ (u8)i, 1, 2 }})) == i);
+    Hash_Map_For_Each(value, &odd) assert(Hash_Map_Key_For(&odd, value)->bytes[0] == (u8)*value);
+    Hash_Map_Free(&odd);
+}
+
+
+void hash_function_test(void) {
+    const char *text = "the quick brown fox jumps over the lazy dog, again and again and again.";
+    u64 text_length = S(text).length;
+
+    // the c string hash shouldn't care where the string is, or how long it is.
+    char buffer[128];
+    for (u64 length = 0; length < text_length; length++) {
+        u64 expected_length;
+        u64 expected = Hash_C_String(text + text_length - length, 0, &expected_length);
+        assert(expected_length == length);
+
+        for (u64 offset = 0; offset < 8; offset++) {
+            Mem_Copy(buffer + offset, (void*)(text + text_length - length), length + 1);
+            u64 got_length;
+            assert(Hash_C_String(buffer + offset, 0, &got_length) == expected);
+            assert(got_length == length);
+        }
+    }
+
+    // every prefix should hash differently.
+    Hash_Map(u64, u64) seen = ZEROED;
+    for (u64 length = 0; length <= text_length; length++) {
+        assert(!Hash_Map_Contains(&seen, Hash_Function_wyhash((void*)text, length, 0)));
+        *Hash_Map_Put(&seen, Hash_Function_wyhash((void*)text, length, 0)) = length;
+    }
+    Hash_Map_Free(&seen);
+
+    // the seed changes everything.
+    assert(Hash_Function_wyhash((void*)text, text_length, 1) != Hash_Function_wyhash((void*)text, text_length, 2));
+    assert(Hash_u64(5, 1) != Hash_u64(5, 2));
+    assert(Hash_u64(5, 1) != Hash_u64(6, 1));
+
+    // seeded maps.
+    Hash_Map(String, u32) words = {
+        .seed                 = Hash_Map_Random_Seed(),
+        .seeded_hash_function = Hash_Map_Seeded_Hash_String,
+        .eq_function          = Hash_Map_Eq_String,
+    };
+    String_Array split = ZEROED;
+    String_Split_By(S(text), S(" "), &split);
+    for (u64 i = 0; i < split.count; i++) *Hash_Map_Get_Or_Default(&words, split.items[i]) += 1;
+    assert(*Hash_Map_Get(&words, S("again")) == 2);
+    assert(*Hash_Map_Get(&words, S("fox")) == 1);
+    Hash_Map_Free(&words);
+    Array_Free(&split);
+
+    Hash_Map(const char *, u32) c_words = {
+        .hash_function = Hash_Map_Hash_C_String,
+        .eq_function   = Hash_Map_Eq_C_String,
+    };
+    *Hash_Map_Put(&c_words, "hello") = 1;
+    Mem_Copy(buffer + 3, "hello", 6);
+    assert(*Hash_Map_Get(&c_words, buffer + 3) == 1);
+    assert(Hash_Map_Get(&c_words, "hell") == NULL);
+    Hash_Map_Free(&c_words);
+}
+
+
+void get_many_test(Hash_Map_Layout layout) {
+    Hash_Map(u64, u64) map = { .layout = layout };
+
+    // nothing in there, (and no memory yet).
+    u64 keys[1000];
+    u64 *values[1000];
+    bool found[1000];
+    for (u64 i = 0; i < Array_Len(keys); i++) keys[i] = i * 5;
+    Hash_Map_Get_Many(&map, keys, Array_Len(keys), values);
+    for (u64 i = 0; i < Array_Len(keys); i++) assert(values[i] == NULL);
+
+    // every other key, and a count that isn't a multiple of the batch size.
+    for (u64 i = 0; i < Array_Len(keys); i += 2) *Hash_Map_Put(&map, keys[i]) = i;
+
+    Hash_Map_Get_Many(&map, keys, 999, values);
+    Hash_Map_Contains_Many(&map, keys, 999, found);
+    for (u64 i = 0; i < 999; i++) {
+        assert(values[i] == Hash_Map_Get(&map, keys[i]));
+        assert(found[i] == (i % 2 == 0));
+        if (found[i]) assert(*values[i] == i);
+    }
+
+    // still works half way through a resize, (ordered maps dont do those).
+    if (layout != Hash_Map_Layout_Ordered) {
+        map.incremental_resize = true;
+        for (u64 i = 1; !Hash_Map_Is_Resizing(&map); i += 2) *Hash_Map_Put(&map, i * 5) = i;
+        Hash_Map_Get_Many(&map, keys, Array_Len(keys), values);
+        for (u64 i = 0; i < Array_Len(keys); i++) assert(values[i] == Hash_Map_Get(&map, keys[i]));
+    }
+
+    Hash_Map_Free(&map);
+}
+
+
+Hash_Map_Define(Id_Map,   u64,    u32, Hash_u64,    Hash_Map_Eq_Direct)
+Hash_Map_Define(Word_Map, String, u32, Hash_String, String_Eq)
+
+void define_test(Hash_Map_Layout layout) {
+    Id_Map ids = { .layout = layout, .default_value = 7 };
+
+    assert(Id_Map_Get(&ids, 5) == NULL);
+    assert(*Id_Map_Get_Or_Default(&ids, 5) == 7);
+
+    for (u64 i = 0; i < 10000; i++) *Id_Map_Put(&ids, i * 31) = (u32)i;
+    assert(ids.count == 10001);
+
+    // the generic functions hash the same way, so they can share the map.
+    for (u64 i = 0; i < 10000; i++) {
+        assert(*Id_Map_Get(&ids, i * 31) == i);
+        assert(*Hash_Map_Get(&ids, (u64)(i * 31)) == i);
+    }
+    *Hash_Map_Put(&ids, (u64)3) = 99;
+    assert(*Id_Map_Get(&ids, 3) == 99);
+
+    // churn, the dead slots get reused.
+    for (u64 i = 0; i < 10000; i += 2) assert(Id_Map_Remove(&ids, i * 31));
+    assert(!Id_Map_Remove(&ids, 0));
+    for (u64 i = 0; i < 10000; i++) assert(Id_Map_Contains(&ids, i * 31) == (i % 2 == 1));
+    for (u64 i = 0; i < 10000; i += 2) *Id_Map_Put(&ids, i * 31) = (u32)i;
+    for (u64 i = 0; i < 10000; i++) assert(*Hash_Map_Get(&ids, (u64)(i * 31)) == i);
+
+    Hash_Map_Free(&ids);
+
+
+    Word_Map words = {
+        .layout               = layout,
+        .seed                 = Hash_Map_Random_Seed(),
+        .seeded_hash_function = Hash_Map_Seeded_Hash_String,
+        .eq_function          = Hash_Map_Eq_String,
+    };
+    *Word_Map_Get_Or_Default(&words, S("hello")) += 1;
+    *Word_Map_Get_Or_Default(&words, S("hello")) += 1;
+    *Hash_Map_Get_Or_Default(&words, S("world")) += 1;
+
+    assert(*Word_Map_Get(&words, S("hello")) == 2);
+    assert(*Hash_Map_Get(&words, S("hello")) == 2);
+    assert(*Word_Map_Get(&words, S("world")) == 1);
+    assert(Word_Map_Get(&words, S("hell")) == NULL);
+
+    Hash_Map_Free(&words);
+}
+
+
+// Hash_Map_Layout_Ordered, For_Each goes in the order things were put in.
+void ordered_test(void) {
+    Hash_Map(u64, u64) map = { .layout = Hash_Map_Layout_Ordered };
+
+    // random looking keys, so the order isn't just the hash order.
+    const u64 N = 5000;
+    for (u64 i = 0; i < N; i++) *Hash_Map_Put(&map, i * 0x9E3779B97F4A7C15ULL) = i;
+
+    u64 next = 0;
+    Hash_Map_For_Each(value, &map) assert(*value == next++);
+    assert(next == N);
+
+    // putting an existing key dosen't move it.
+    *Hash_Map_Put(&map, 0) = 0;
+    // removing leaves a gap, and new keys go on the end.
+    for (u64 i = 0; i < N; i += 2) assert(Hash_Map_Remove(&map, i * 0x9E3779B97F4A7C15ULL));
+    *Hash_Map_Put(&map, 0) = N;
+
+    // the odd ones, then the new zero.
+    next = 0;
+    Hash_Map_For_Each(value, &map) {
+        assert(*value == ((next < N / 2) ? next * 2 + 1 : N));
+        next += 1;
+    }
+    assert(next == N / 2 + 1);
+
+    // a rehash keeps the order, and gets rid of the dead ones.
+    Hash_Map_Shrink_To_Fit(&map);
+    assert(map.dead_count == 0);
+    next = 0;
+    Hash_Map_For_Each(value, &map) {
+        assert(*value == ((next < N / 2) ? next * 2 + 1 : N));
+        assert(*Hash_Map_Key_For(&map, value) == (*value % N) * 0x9E3779B97F4A7C15ULL);
+        next += 1;
+    }
+    assert(next == map.count);
+
+    // after a clear, its all new again.
+    Hash_Map_Clear(&map);
+    for (u64 i = 0; i < 100; i++) *Hash_Map_Put(&map, i) = i;
+    next = 0;
+    Hash_Map_For_Each(value, &map) assert(*value == next++);
+    assert(next == 100);
+    Hash_Map_Free(&map);
+
+    // small maps get a small index table.
+    Hash_Map(u32, u32) small = { .layout = Hash_Map_Layout_Ordered };
+    for (u32 i = 0; i < 100; i++) *Hash_Map_Put(&small, i) = i;
+    assert(Hash_Map_Ordered_Index_Width(small.capacity) == 1);
+    for (u32 i = 0; i < 100; i++) assert(*Hash_Map_Get(&small, i) == i);
+    Hash_Map_Free(&small);
+}
+
+
+// 64 keys in a row get the same hash.
+u64 bad_hash(void *key, u64 size) {
+    (void) size;
+    return *(u64*)key >> 6;
+}
+
+void stats_test(Hash_Map_Layout layout) {
+    const u64 N = 4000;
+    Hash_Map(u64, u64) good = { .layout = layout };
+    Hash_Map(u64, u64) bad  = { .layout = layout, .hash_function = bad_hash };
+
+    Hash_Map_Stats empty = Hash_Map_Stats(&good);
+    assert(empty.count == 0 && empty.max_probe_length == 0 && empty.cluster_count == 0);
+
+    for (u64 i = 0; i < N; i++) *Hash_Map_Put(&good, i) = i;
+    for (u64 i = 0; i < N; i++) *Hash_Map_Put(&bad,  i) = i;
+
+    Hash_Map_Stats good_stats = Hash_Map_Stats(&good);
+    Hash_Map_Stats bad_stats  = Hash_Map_Stats(&bad);
+
+    assert(good_stats.count == N && good_stats.capacity == good.capacity);
+    assert(good_stats.load_factor > 0 && good_stats.load_factor < 1);
+    assert(good_stats.mean_probe_length >= 1);
+
+    u64 in_histogram = 0;
+    for (u64 i = 0; i < Array_Len(good_stats.probe_length_histogram); i++) in_histogram += good_stats.probe_length_histogram[i];
+    assert(in_histogram == N);
+    assert(good_stats.probe_length_histogram[0] > 0);
+
+    // the bad hash should stick out.
+    assert(bad_stats.mean_probe_length > 2 * good_stats.mean_probe_length);
+    assert(bad_stats.max_probe_length  > good_stats.max_probe_length);
+
+    // every hit probes exactly as far as the stats say.
+    Hash_Map_Reset_Probe_Counts();
+    for (u64 i = 0; i < N; i++) assert(*Hash_Map_Get(&bad, i) == i);
+    Hash_Map_Probe_Counts counts = Hash_Map_Get_Probe_Counts();
+    assert(counts.lookups == N);
+    assert(counts.probes == (u64)(bad_stats.mean_probe_length * N + 0.5));
+    assert(counts.max_probes == bad_stats.max_probe_length);
+
+    // the dead ones show up.
+    for (u64 i = 0; i < N; i += 2) Hash_Map_Remove(&good, i);
+    good_stats = Hash_Map_Stats(&good);
+    assert(good_stats.count == N / 2);
+    if (layout != Hash_Map_Layout_Robin_Hood) assert(good_stats.dead_ratio > 0);
+
+    if (layout == Hash_Map_Layout_Default) Hash_Map_Print_Stats(&bad_stats);
+
+    Hash_Map_Free(&good);
+    Hash_Map_Free(&bad);
+}
+
+
+void incremental_test(Hash_Map_Layout layout) {
+    const u64 N = 20000;
+
+    Hash_Map(u64, u64) map = { .layout = layout, .incremental_resize = true };
+
+    // every key has to be findable the whole way through.
+    u64 resizes_seen = 0;
+    for (u64 i = 0; i < N; i++) {
+        *Hash_Map_Put(&map, i * 13) = i;
+
+        if (Hash_Map_Is_Resizing(&map)) {
+            resizes_seen += 1;
+            for (u64 j = 0; j <= i; j += 97) assert(*Hash_Map_Get(&map, j * 13) == j);
+            assert(Hash_Map_Get(&map, (u64)1) == NULL);
+        }
+    }
+    assert(resizes_seen > 0);
+    assert(map.count == N);
+
+    // get a resize going, then mess with it.
+    u64 count = N;
+    for (; !Hash_Map_Is_Resizing(&map); count++) *Hash_Map_Put(&map, count * 13) = count;
+
+    // some of these are still in the old table, and a remove moves it along too,
+    // so just removing things finishes it.
+    for (u64 i = 0; i < count; i += 3) assert(Hash_Map_Remove(&map, i * 13));
+    assert(!Hash_Map_Remove(&map, (u64)0));
+    assert(!Hash_Map_Is_Resizing(&map));
+
+    // putting an old key gives back the same value.
+    for (u64 i = 1; i < count; i += 3) assert(*Hash_Map_Put(&map, i * 13) == i);
+
+    // the loop sees both tables, and removing while looping is fine, (just not for robin hood).
+    u64 seen = 0, alive = map.count;
+    Hash_Map_For_Each(value, &map) {
+        assert(*Hash_Map_Key_For(&map, value) == *value * 13);
+        if (layout != Hash_Map_Layout_Robin_Hood && *value % 3 == 1) assert(Hash_Map_Remove_By_Value(&map, value));
+        seen += 1;
+    }
+    assert(seen == alive);
+    if (layout == Hash_Map_Layout_Robin_Hood) {
+        for (u64 i = 1; i < count; i += 3) assert(Hash_Map_Remove(&map, i * 13));
+    }
+
+    for (u64 i = 0; i < count; i++) assert(Hash_Map_Contains(&map, i * 13) == (i % 3 == 2));
+
+    // finishes on its own.
+    for (u64 i = count; Hash_Map_Is_Resizing(&map); i++) *Hash_Map_Get_Or_Default(&map, i * 13) = i;
+    for (u64 i = 0; i < count; i++) assert(Hash_Map_Contains(&map, i * 13) == (i % 3 == 2));
+
+    Hash_Map_Clear(&map);
+    assert(map.count == 0 && !Hash_Map_Is_Resizing(&map));
+    Hash_Map_Free(&map);
+
+
+    // the typed functions hand off to the generic ones while its resizing.
+    Id_Map ids = { .layout = layout, .incremental_resize = true };
+    for (u64 i = 0; i < N; i++) {
+        *Id_Map_Put(&ids, i) = (u32)i;
+        if (i % 500 == 0) assert(*Id_Map_Get(&ids, i / 2) == i / 2);
+    }
+    for (u64 i = 0; i < N; i += 2) assert(Id_Map_Remove(&ids, i));
+    for (u64 i = 0; i < N; i++) assert(Id_Map_Contains(&ids, i) == (i % 2 == 1));
+
+    // shrinking finishes the resize first.
+    Hash_Map_Shrink_To_Fit(&ids);
+    assert(!Hash_Map_Is_Resizing(&ids));
+    for (u64 i = 1; i < N; i += 2) assert(*Id_Map_Get(&ids, i) == i);
+    Hash_Map_Free(&ids);
+
+
+    // with an arena, the old tables just stay in there.
+    Arena arena = ZEROED;
+    Hash_Map(u32, u32) in_arena = { .layout = layout, .incremental_resize = true, .allocator = &arena };
+    for (u32 i = 0; i < 5000; i++) *Hash_Map_Put(&in_arena, i) = i;
+    for (u32 i = 0; i < 5000; i++) assert(*Hash_Map_Get(&in_arena, i) == i);
+    Arena_Free(&arena);
+}
 
 
 
@@ -44,6 +467,39 @@ int main(void) {
 
     foo();
 
+    layout_test(Hash_Map_Layout_Default);
+    layout_test(Hash_Map_Layout_Control_Bytes);
+    layout_test(Hash_Map_Layout_Split);
+    layout_test(Hash_Map_Layout_Robin_Hood);
+    layout_test(Hash_Map_Layout_Ordered);
+
+    hash_function_test();
+
+    get_many_test(Hash_Map_Layout_Default);
+    get_many_test(Hash_Map_Layout_Control_Bytes);
+    get_many_test(Hash_Map_Layout_Split);
+    get_many_test(Hash_Map_Layout_Robin_Hood);
+    get_many_test(Hash_Map_Layout_Ordered);
+
+    define_test(Hash_Map_Layout_Default);
+    define_test(Hash_Map_Layout_Control_Bytes);
+    define_test(Hash_Map_Layout_Split);
+    define_test(Hash_Map_Layout_Robin_Hood);
+    define_test(Hash_Map_Layout_Ordered);
+
+    ordered_test();
+
+    stats_test(Hash_Map_Layout_Default);
+    stats_test(Hash_Map_Layout_Control_Bytes);
+    stats_test(Hash_Map_Layout_Split);
+    stats_test(Hash_Map_Layout_Robin_Hood);
+    stats_test(Hash_Map_Layout_Ordered);
+
+    incremental_test(Hash_Map_Layout_Default);
+    incremental_test(Hash_Map_Layout_Control_Bytes);
+    incremental_test(Hash_Map_Layout_Split);
+    incremental_test(Hash_Map_Layout_Robin_Hood);
+
     typedef struct {
         String name;
         u32 age;
@@ -56,6 +512,7 @@ int main(void) {
         .hash_function = Hash_Map_Hash_String,
         .eq_function   = Hash_Map_Eq_String,
         .default_value = { .name = S("NULL"), .age = 32, .is_male = false },
+        .layout        = Hash_Map_Layout_Control_Bytes,
     };
 
     Person jim = {.name = S("Jim"), .age = 43, .is_male = true};
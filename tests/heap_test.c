@@ -0,0 +1,131 @@
+
+#define BESTED_IMPLEMENTATION
+#include "../Bested.h"
+
+
+typedef struct {
+    u32 priority;
+    u32 id;
+} Job;
+
+#define Job_Less(a, b)  ((a).priority < (b).priority)
+
+Heap_Define(Job_Heap,   Job, 2, Job_Less)
+Heap_Define(Job_Heap_4, Job, 4, Job_Less)
+
+
+// for decrease-key, a small dijkstra style setup.
+#define NODE_COUNT 1000
+global_variable u32 distances[NODE_COUNT];
+global_variable u64 heap_index_of[NODE_COUNT];
+
+#define Node_Less(a, b)             (distances[(a)] < distances[(b)])
+#define Node_Moved(node, index)     (heap_index_of[(node)] = (index))
+
+Heap_Define_Indexed(Node_Heap, u32, 4, Node_Less, Node_Moved)
+
+
+// a bad random, but good enough to shuffle things.
+internal u32 next_random(u32 *state) {
+    *state = *state * 1664525 + 1013904223;
+    return *state >> 8;
+}
+
+
+int main(void) {
+    u32 random = 1234;
+
+    // both arities should pop in order.
+    Job_Heap   heap   = ZEROED;
+    Job_Heap_4 heap_4 = ZEROED;
+    ASSERT(Job_Heap_Peek(&heap) == NULL);
+
+    for (u32 i = 0; i < 5000; i++) {
+        Job job = { .priority = next_random(&random) % 1000, .id = i };
+        Job_Heap_Push  (&heap,   job);
+        Job_Heap_4_Push(&heap_4, job);
+    }
+
+    u32 last = 0;
+    while (heap.count) {
+        ASSERT(Job_Heap_Peek(&heap)->priority == Job_Heap_4_Peek(&heap_4)->priority);
+        Job job   = Job_Heap_Pop(&heap);
+        Job job_4 = Job_Heap_4_Pop(&heap_4);
+        ASSERT(job.priority == job_4.priority);
+        ASSERT(last <= job.priority);
+        last = job.priority;
+    }
+    ASSERT(heap_4.count == 0);
+
+
+    // heapify an existing array.
+    Array(Job) jobs = ZEROED;
+    for (u32 i = 0; i < 1000; i++) Array_Append(&jobs, ((Job){ .priority = 999 - i, .id = i }));
+
+    Job_Heap_4 from_array = { .items = jobs.items, .count = jobs.count, .capacity = jobs.capacity };
+    Job_Heap_4_Heapify(&from_array);
+    for (u32 i = 0; i < 1000; i++) ASSERT(Job_Heap_4_Pop(&from_array).priority == i);
+
+
+    // top k, in pop order.
+    for (u32 i = 0; i < 1000; i++) jobs.items[i] = (Job){ .priority = next_random(&random) % 100000, .id = i };
+
+    Job best[10];
+    u64 best_count = Job_Heap_Top_K(jobs.items, jobs.count, Array_Len(best), best);
+    ASSERT(best_count == 10);
+
+    for (u64 i = 1; i < best_count; i++) ASSERT(best[i-1].priority <= best[i].priority);
+    // nothing in the array is better than the last one we got, (unless its in there).
+    u64 better_count = 0;
+    Array_For_Each(job, &jobs) better_count += job->priority < best[best_count-1].priority;
+    ASSERT(better_count < best_count);
+
+    // asking for more than there is.
+    Job all[4];
+    ASSERT(Job_Heap_Top_K(jobs.items, 3, 4, all) == 3);
+
+    Array_Free(&jobs);
+    Array_Free(&heap);
+    Array_Free(&heap_4);
+
+
+    // indexed, with decrease key.
+    Arena arena = ZEROED;
+    Node_Heap nodes = { .allocator = &arena };
+
+    for (u32 node = 0; node < NODE_COUNT; node++) {
+        distances[node] = 1000000 + next_random(&random) % 1000;
+        Node_Heap_Push(&nodes, node);
+    }
+    for (u32 node = 0; node < NODE_COUNT; node++) ASSERT(nodes.items[heap_index_of[node]] == node);
+
+    // pull some to the front.
+    for (u32 node = 0; node < NODE_COUNT; node += 10) {
+        distances[node] = node;
+        Node_Heap_Decrease_Key(&nodes, heap_index_of[node], node);
+    }
+    for (u32 node = 0; node < NODE_COUNT; node++) ASSERT(nodes.items[heap_index_of[node]] == node);
+
+    // and push one to the back.
+    distances[0] = 2000000;
+    Node_Heap_Update(&nodes, heap_index_of[0]);
+
+    u32 removed = nodes.items[heap_index_of[55]];
+    ASSERT(Node_Heap_Remove(&nodes, heap_index_of[55]) == removed);
+
+    for (u32 node = 10; node < NODE_COUNT; node += 10) ASSERT(Node_Heap_Pop(&nodes) == node);
+
+    u32 last_distance = 0;
+    while (nodes.count) {
+        u32 node = Node_Heap_Pop(&nodes);
+        ASSERT(node != 55);
+        ASSERT(last_distance <= distances[node]);
+        last_distance = distances[node];
+    }
+    ASSERT(last_distance == 2000000);
+
+    printf("heaps are in order\n");
+
+    Arena_Free(&arena);
+    return 0;
+}
@@ -0,0 +1,122 @@
+
+#define BESTED_IMPLEMENTATION
+#include "../Bested.h"
+
+
+typedef LRU_Cache(u64, u64) U64_Cache;
+
+global_variable u64 evicted_keys[16];
+global_variable u64 evicted_count = 0;
+
+internal void remember_eviction(void *key, void *value, void *user_data) {
+    ASSERT(*(u64*)value == *(u64*)key * 10);
+    ASSERT(user_data == &evicted_count);
+    evicted_keys[evicted_count++ % Array_Len(evicted_keys)] = *(u64*)key;
+}
+
+internal void free_the_string(void *key, void *value, void *user_data) {
+    (void) key; (void) user_data;
+    free(*(char**)value);
+}
+
+
+int main(void) {
+    U64_Cache cache = { .capacity = 4, .on_evict = remember_eviction, .user_data = &evicted_count };
+
+    ASSERT(LRU_Cache_Get(&cache, 1) == NULL);
+    ASSERT(!LRU_Cache_Remove(&cache, 1));
+
+    for (u64 i = 1; i <= 4; i++) *LRU_Cache_Put(&cache, i) = i * 10;
+    ASSERT(cache.count == 4 && evicted_count == 0);
+
+    // 1 was the oldest, but now its the newest, so 2 goes.
+    ASSERT(*LRU_Cache_Get(&cache, 1) == 10);
+    *LRU_Cache_Put(&cache, 5) = 50;
+    ASSERT(evicted_count == 1 && evicted_keys[0] == 2);
+    ASSERT(LRU_Cache_Get(&cache, 2) == NULL);
+    ASSERT(cache.count == 4);
+
+    // putting an existing key counts as a use too.
+    *LRU_Cache_Put(&cache, 3) = 30;
+    *LRU_Cache_Put(&cache, 6) = 60;
+    ASSERT(evicted_count == 2 && evicted_keys[1] == 4);
+
+    // 1 5 3 6 are in there, oldest first.
+    ASSERT(LRU_Cache_Contains(&cache, 1) && LRU_Cache_Contains(&cache, 5));
+    ASSERT(cache.hits == 1 && cache.misses == 2 && cache.evictions == 2);
+
+    // a removed slot gets used before anyone is evicted.
+    ASSERT(LRU_Cache_Remove(&cache, 5));
+    ASSERT(cache.count == 3);
+    *LRU_Cache_Put(&cache, 7) = 70;
+    ASSERT(evicted_count == 2 && cache.count == 4);
+    *LRU_Cache_Put(&cache, 8) = 80;
+    ASSERT(evicted_count == 3 && evicted_keys[2] == 1);
+
+    // lots of churn, the memory stays put.
+    u64 map_capacity = cache.map.capacity;
+    for (u64 i = 100; i < 100000; i++) {
+        if (!LRU_Cache_Get(&cache, i % 7 + 100)) *LRU_Cache_Put(&cache, i % 7 + 100) = (i % 7 + 100) * 10;
+    }
+    ASSERT(cache.count == 4 && cache.map.count == 4);
+    ASSERT(cache.map.capacity == map_capacity);
+
+    // everything thats left gets told.
+    u64 before = evicted_count;
+    LRU_Cache_Clear(&cache);
+    ASSERT(evicted_count == before + 4 && cache.count == 0);
+    ASSERT(LRU_Cache_Get(&cache, 106) == NULL);
+    *LRU_Cache_Put(&cache, 9) = 90;
+    ASSERT(*LRU_Cache_Get(&cache, 9) == 90);
+    LRU_Cache_Free(&cache);
+
+
+    // CLOCK, a used key gets a second chance.
+    U64_Cache clock = { .capacity = 4, .use_clock = true };
+    for (u64 i = 1; i <= 4; i++) *LRU_Cache_Put(&clock, i) = i * 10;
+    ASSERT(LRU_Cache_Get(&clock, 1) && LRU_Cache_Get(&clock, 2));
+
+    // 1 and 2 were used, so the hand goes past them to 3.
+    *LRU_Cache_Put(&clock, 5) = 50;
+    ASSERT(LRU_Cache_Contains(&clock, 1) && LRU_Cache_Contains(&clock, 2));
+    ASSERT(!LRU_Cache_Contains(&clock, 3));
+    // and there second chance is used up, 4 hasn't been used either way.
+    *LRU_Cache_Put(&clock, 6) = 60;
+    ASSERT(!LRU_Cache_Contains(&clock, 4));
+
+    // a hot key stays, even with a bunch of one off keys going through.
+    for (u64 i = 1000; i < 2000; i++) {
+        ASSERT(LRU_Cache_Get(&clock, 1));
+        *LRU_Cache_Put(&clock, i) = i;
+    }
+    ASSERT(LRU_Cache_Contains(&clock, 1) && clock.count == 4);
+    LRU_Cache_Free(&clock);
+
+
+    // strings that own their memory, in an arena.
+    Arena arena = ZEROED;
+    LRU_Cache(String, char *) names = {
+        .capacity      = 64,
+        .on_evict      = free_the_string,
+        .allocator     = &arena,
+        .map = {
+            .hash_function = Hash_Map_Hash_String,
+            .eq_function   = Hash_Map_Eq_String,
+        },
+    };
+    for (u32 i = 0; i < 1000; i++) {
+        String key = S(Arena_sprintf(&arena, "name_%u", (i / 3) % 100));
+        char **value = LRU_Cache_Get(&names, key);
+        if (!value) {
+            value = LRU_Cache_Put(&names, key);
+            *value = strdup(key.data);
+        }
+        ASSERT(String_Eq(S(*value), key));
+    }
+    ASSERT(names.count == 64);
+    printf("%zu hits, %zu misses, %zu evictions\n", names.hits, names.misses, names.evictions);
+
+    LRU_Cache_Free(&names);
+    Arena_Free(&arena);
+    return 0;
+}
@@ -0,0 +1,75 @@
+
+#define BESTED_IMPLEMENTATION
+#include "../Bested.h"
+
+
+typedef Deque(s64) Int_Queue;
+
+
+int main(void) {
+    Int_Queue queue = ZEROED;
+
+    // fifo.
+    for (s64 i = 0; i < 10; i++) Ring_Buffer_Push_Back(&queue, i);
+    for (s64 i = 0; i < 10; i++) ASSERT(Ring_Buffer_Pop_Front(&queue) == i);
+    ASSERT(queue.count == 0);
+    ASSERT(Ring_Buffer_Peek_Front(&queue) == NULL);
+
+    // the head is now in the middle, these wrap around the end.
+    for (s64 i = 0; i < 30; i++) Ring_Buffer_Push_Back(&queue, i);
+    ASSERT(queue.capacity == RING_BUFFER_INITAL_CAPACITY);
+
+    // both ends.
+    Ring_Buffer_Push_Front(&queue, -1);
+    ASSERT(*Ring_Buffer_Peek_Front(&queue) == -1);
+    ASSERT(*Ring_Buffer_Peek_Back (&queue) == 29);
+    ASSERT(Ring_Buffer_Pop_Back(&queue) == 29);
+    ASSERT(Ring_Buffer_Pop_Front(&queue) == -1);
+
+    for (u64 i = 0; i < queue.count; i++) ASSERT(*Ring_Buffer_Get(&queue, i) == (s64)i);
+
+    // grow while wrapped, order must survive.
+    for (s64 i = 29; i < 100; i++) Ring_Buffer_Push_Back(&queue, i);
+    ASSERT(queue.head == 0);
+    for (u64 i = 0; i < queue.count; i++) ASSERT(*Ring_Buffer_Get(&queue, i) == (s64)i);
+
+    // bulk.
+    Ring_Buffer_Spans popped = Ring_Buffer_Pop_Front_Many(&queue, 90);
+    ASSERT(popped.first_count + popped.second_count == 90);
+    ASSERT(((s64*)popped.first)[0] == 0);
+    ASSERT(queue.count == 10 && *Ring_Buffer_Peek_Front(&queue) == 90);
+
+    Ring_Buffer_Spans pushed = Ring_Buffer_Push_Back_Many(&queue, 100);
+    ASSERT(pushed.first_count + pushed.second_count == 100);
+    // this one wraps.
+    ASSERT(pushed.second_count > 0);
+    for (u64 i = 0; i < pushed.first_count;  i++) ((s64*)pushed.first )[i] = 100 + i;
+    for (u64 i = 0; i < pushed.second_count; i++) ((s64*)pushed.second)[i] = 100 + pushed.first_count + i;
+
+    s64 expected = 90;
+    while (queue.count > 0) ASSERT(Ring_Buffer_Pop_Front(&queue) == expected++);
+    ASSERT(expected == 200);
+
+    // asking for more than there is.
+    Ring_Buffer_Push_Back(&queue, 5);
+    popped = Ring_Buffer_Pop_Front_Many(&queue, 1000);
+    ASSERT(popped.first_count == 1 && popped.second_count == 0);
+
+    Ring_Buffer_Free(&queue);
+
+
+    // and with an arena.
+    Arena arena = ZEROED;
+    Ring_Buffer(String) words = { .allocator = &arena };
+    Ring_Buffer_Push_Back (&words, S("world"));
+    Ring_Buffer_Push_Front(&words, S("hello"));
+
+    while (words.count) {
+        String word = Ring_Buffer_Pop_Front(&words);
+        printf(S_Fmt" ", S_Arg(word));
+    }
+    printf("\n");
+
+    Arena_Free(&arena);
+    return 0;
+}
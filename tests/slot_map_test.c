@@ -0,0 +1,77 @@
+
+#define BESTED_IMPLEMENTATION
+#include "../Bested.h"
+
+
+typedef struct {
+    u32 id;
+    f32 hp;
+} Entity;
+
+typedef Slot_Map(Entity) Entity_Map;
+
+
+int main(void) {
+    Entity_Map entities = ZEROED;
+
+    ASSERT(Slot_Map_Get(&entities, 0) == NULL);
+
+    Slot_Map_Handle handles[1000];
+    for (u32 i = 0; i < Array_Len(handles); i++) {
+        handles[i] = Slot_Map_Insert(&entities, ((Entity){ .id = i, .hp = 100 }));
+        ASSERT(handles[i] != 0);
+    }
+    ASSERT(entities.count == 1000);
+
+    for (u32 i = 0; i < Array_Len(handles); i++) ASSERT(Slot_Map_Get(&entities, handles[i])->id == i);
+
+    // remove every other one, the rest are still findable.
+    for (u32 i = 0; i < Array_Len(handles); i += 2) ASSERT(Slot_Map_Remove(&entities, handles[i]));
+    ASSERT(entities.count == 500);
+    // twice dose nothing.
+    ASSERT(!Slot_Map_Remove(&entities, handles[0]));
+
+    for (u32 i = 0; i < Array_Len(handles); i++) {
+        Entity *e = Slot_Map_Get(&entities, handles[i]);
+        if (i % 2 == 0) ASSERT(e == NULL);
+        else            ASSERT(e && e->id == i);
+    }
+
+    // the slots get reused, but the old handles stay dead.
+    Slot_Map_Handle reused = Slot_Map_Insert(&entities, ((Entity){ .id = 5000 }));
+    ASSERT(entities.slots.count == 1000);
+    ASSERT(Slot_Map_Get(&entities, reused)->id == 5000);
+    for (u32 i = 0; i < Array_Len(handles); i += 2) ASSERT(!Slot_Map_Contains(&entities, handles[i]));
+
+    // dense iteration, and back to handles.
+    u64 seen = 0;
+    Array_For_Each(it, &entities) {
+        Slot_Map_Handle handle = Slot_Map_Handle_Of(&entities, it - entities.items);
+        ASSERT(Slot_Map_Get(&entities, handle) == it);
+        seen += 1;
+    }
+    ASSERT(seen == entities.count);
+
+    Slot_Map_Clear(&entities);
+    ASSERT(entities.count == 0);
+    ASSERT(!Slot_Map_Contains(&entities, reused));
+    ASSERT(!Slot_Map_Contains(&entities, handles[1]));
+
+    Slot_Map_Free(&entities);
+    ASSERT(entities.items == NULL && entities.slots.items == NULL);
+
+
+    // with an arena.
+    Arena arena = ZEROED;
+    Slot_Map(String) names = { .allocator = &arena };
+
+    Slot_Map_Handle hello = Slot_Map_Insert(&names, S("hello"));
+    Slot_Map_Handle world = Slot_Map_Insert(&names, S("world"));
+    Slot_Map_Remove(&names, hello);
+    // 'world' moved into the hole, but its handle still works.
+    ASSERT(String_Eq(*Slot_Map_Get(&names, world), S("world")));
+    printf(S_Fmt"\n", S_Arg(*Slot_Map_Get(&names, world)));
+
+    Arena_Free(&arena);
+    return 0;
+}
@@ -0,0 +1,74 @@
+
+#define BESTED_IMPLEMENTATION
+#include "../Bested.h"
+
+
+#define PARTICLE_FIELDS(X)      \
+    X(f32, x)                   \
+    X(f32, y)                   \
+    X(f32, speed)               \
+    X(u8,  color)               \
+    X(f64, mass)
+
+SoA_Define(Particles, PARTICLE_FIELDS)
+
+
+int main(void) {
+    Arena arena = ZEROED;
+
+    Particles particles = ZEROED;
+
+    for (u32 i = 0; i < 100; i++) {
+        u64 index = Particles_Append(&particles, ((Particles_Row){ .x = i, .y = -(f32)i, .speed = 2, .color = i % 7, .mass = i * 0.5 }));
+        assert(index == i);
+    }
+    assert(particles.count == 100);
+    assert(particles.capacity >= 100);
+
+    // every column should be aligned for its type.
+    assert(Mem_Is_Aligned(particles.mass, alignof(f64)));
+    assert(Mem_Is_Aligned(particles.x,    alignof(f32)));
+
+    SoA_For_Each_Index(i, &particles) {
+        particles.x[i] += particles.speed[i];
+    }
+
+    Particles_Row row = Particles_Get(&particles, 10);
+    assert(row.x == 12 && row.y == -10 && row.color == 3 && row.mass == 5);
+
+    // the last row gets swapped into the hole.
+    Particles_Swap_And_Remove(&particles, 10);
+    assert(particles.count == 99);
+    assert(particles.x[10] == 101 && particles.mass[10] == 49.5);
+    // full swap, so the removed one is just past the end.
+    assert(particles.x[99] == 12);
+
+    u64 first = Particles_Add(&particles, 3, true);
+    assert(first == 99 && particles.count == 102);
+    assert(particles.x[100] == 0 && particles.color[101] == 0);
+
+    Particles_Set(&particles, 0, row);
+    assert(particles.y[0] == -10);
+
+    Particles_Free(&particles);
+    assert(particles.x == NULL && particles.count == 0);
+
+
+    // now with an arena.
+    Particles arena_particles = { .allocator = &arena };
+    Particles_Reserve(&arena_particles, 1000);
+    assert(arena_particles.capacity >= 1000 && arena_particles.count == 0);
+
+    for (u32 i = 0; i < 5000; i++) {
+        Particles_Append(&arena_particles, ((Particles_Row){ .x = i, .mass = i }));
+    }
+
+    f64 total_mass = 0;
+    SoA_For_Each_Index(i, &arena_particles) total_mass += arena_particles.mass[i];
+    assert(total_mass == 4999.0 * 5000.0 / 2.0);
+
+    printf("%zu particles, total mass %.0f\n", arena_particles.count, total_mass);
+
+    Arena_Free(&arena);
+    return 0;
+}
@@ -0,0 +1,98 @@
+
+#define BESTED_IMPLEMENTATION
+#include "../Bested.h"
+
+#include <pthread.h>
+
+
+#define THREAD_COUNT    4
+#define WORD_COUNT      2000
+
+global_variable String_Interner shared = { .thread_safe = true };
+global_variable String_Id thread_ids[THREAD_COUNT][WORD_COUNT];
+
+// every thread interns the same words, in a different order.
+internal void *intern_words(void *arg) {
+    u64 thread = (u64) arg;
+    char buffer[32];
+    for (u64 n = 0; n < WORD_COUNT; n++) {
+        u64 i = (n * 7 + thread * 500) % WORD_COUNT;
+        u64 length = snprintf(buffer, sizeof(buffer), "word_%zu", i);
+        String_Id id = String_Interner_Intern(&shared, ((String){ .data = buffer, .length = length }));
+
+        ASSERT(String_Eq(String_Interner_Get(&shared, id), ((String){ .data = buffer, .length = length })));
+        thread_ids[thread][i] = id;
+    }
+    return NULL;
+}
+
+
+int main(void) {
+    String_Interner interner = ZEROED;
+
+    ASSERT(String_Interner_Find(&interner, S("hello")) == 0);
+
+    String_Id hello = String_Interner_Intern(&interner, S("hello"));
+    String_Id world = String_Interner_Intern(&interner, S("world"));
+    ASSERT(hello != 0 && world != 0 && hello != world);
+
+    // the same bytes from somewhere else get the same id.
+    char buffer[] = "hello";
+    ASSERT(String_Interner_Intern(&interner, ((String){ .data = buffer, .length = 5 })) == hello);
+    ASSERT(String_Interner_Find(&interner, S("world")) == world);
+    ASSERT(String_Interner_Count(&interner) == 2);
+
+    // the copy is the interners, and its null terminated.
+    String canonical = String_Interner_Get(&interner, hello);
+    ASSERT(canonical.data != buffer && String_Eq(canonical, S("hello")));
+    ASSERT(canonical.data[canonical.length] == 0);
+    ASSERT(String_Interner_Canonical(&interner, S("hello")).data == canonical.data);
+
+    // the empty string is a string too.
+    String_Id empty = String_Interner_Intern(&interner, S(""));
+    ASSERT(empty != 0 && String_Interner_Get(&interner, empty).length == 0);
+
+
+    // tokenizer output, lots of repeats, (some in the same batch).
+    Arena token_arena = ZEROED;
+    String_Array tokens = ZEROED;
+    String_Split_By(S("the cat sat on the mat and the dog sat on the cat"), S(" "), &tokens);
+    for (u32 i = 0; i < 100; i++) Array_Append(&tokens, S(Arena_sprintf(&token_arena, "token_%u", i % 40)));
+
+    String_Id ids[256];
+    ASSERT(tokens.count <= Array_Len(ids));
+    String_Interner_Intern_Many(&interner, tokens.items, tokens.count, ids);
+
+    for (u64 i = 0; i < tokens.count; i++) {
+        ASSERT(ids[i] == String_Interner_Find(&interner, tokens.items[i]));
+        ASSERT(String_Eq(String_Interner_Get(&interner, ids[i]), tokens.items[i]));
+    }
+    ASSERT(ids[0] == ids[4] && ids[1] == ids[12]);
+    // hello, world, "", 7 words and 40 tokens.
+    ASSERT(String_Interner_Count(&interner) == 3 + 7 + 40);
+
+    // again, its all lookups this time.
+    String_Id again[256];
+    String_Interner_Intern_Many(&interner, tokens.items, tokens.count, again);
+    ASSERT(Mem_Eq(ids, again, tokens.count * sizeof(String_Id)));
+    ASSERT(String_Interner_Count(&interner) == 50);
+
+    Array_Free(&tokens);
+    Arena_Free(&token_arena);
+    String_Interner_Free(&interner);
+
+
+    // from lots of threads at once.
+    pthread_t threads[THREAD_COUNT];
+    for (u64 i = 0; i < THREAD_COUNT; i++) pthread_create(&threads[i], NULL, intern_words, (void*)i);
+    for (u64 i = 0; i < THREAD_COUNT; i++) pthread_join(threads[i], NULL);
+
+    ASSERT(String_Interner_Count(&shared) == WORD_COUNT);
+    for (u64 i = 0; i < WORD_COUNT; i++) {
+        for (u64 thread = 1; thread < THREAD_COUNT; thread++) ASSERT(thread_ids[thread][i] == thread_ids[0][i]);
+    }
+    printf("%u threads interned %zu unique words\n", THREAD_COUNT, String_Interner_Count(&shared));
+
+    String_Interner_Free(&shared);
+    return 0;
+}